@@ -0,0 +1,433 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+BC_USE_LIBBITCOIN_MAIN
+
+// Replays a capture of wire messages (heading and payload, back to back as
+// received) through the frame decoder, the registered message parsers and
+// message serialization, reporting throughput and allocations by command.
+// The sample capture, replay_sample.dat, is a mainnet session of handshake,
+// headers, inventory, transaction and block messages at the maximum protocol
+// version, with the genesis block and otherwise generated content.
+
+using namespace bc;
+namespace po = boost::program_options;
+
+// Allocations of the process are counted only while profiling, so that the
+// counter is not contended by the timed threads. The profile is single
+// threaded, so the count is attributable to the message being replayed.
+static std::atomic<bool> counting(false);
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const auto block = std::malloc(size == 0 ? 1 : size);
+
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    return block;
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+static const uint32_t mainnet_magic = 0xd9b4bef9;
+
+struct record
+{
+    size_t offset;
+    size_t size;
+    message::message_type type;
+};
+
+struct statistics
+{
+    size_t messages;
+    size_t bytes;
+    size_t failures;
+    size_t decode_allocations;
+    size_t encode_allocations;
+};
+
+typedef std::vector<record> records;
+typedef std::function<data_chunk()> encoder;
+
+// Discards each parsed message, which returns pooled instances to the pool.
+class discarder
+{
+public:
+    template <typename Message>
+    void operator()(std::shared_ptr<const Message>)
+    {
+    }
+};
+
+// Retains a copy of each parsed message for serialization. The copy is not
+// pooled, so retaining it does not exhaust the parsing thread's pool.
+class collector
+{
+public:
+    collector(uint32_t protocol_version, uint32_t magic)
+      : protocol_version_(protocol_version), magic_(magic)
+    {
+    }
+
+    template <typename Message>
+    void operator()(std::shared_ptr<const Message> packet)
+    {
+        const auto copy = std::make_shared<const Message>(*packet);
+        const auto protocol_version = protocol_version_;
+        const auto magic = magic_;
+
+        encoder_ = [copy, protocol_version, magic]()
+        {
+            return message::serialize(protocol_version, *copy, magic);
+        };
+    }
+
+    encoder take()
+    {
+        encoder out;
+        out.swap(encoder_);
+        return out;
+    }
+
+private:
+    const uint32_t protocol_version_;
+    const uint32_t magic_;
+    encoder encoder_;
+};
+
+static bool load(const std::string& path, data_chunk& out)
+{
+    bc::ifstream file(path, std::ios::binary);
+
+    if (!file.good())
+        return false;
+
+    out.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+// Split the capture into frames, failing on a malformed or truncated frame.
+static code split(const data_chunk& capture, uint32_t protocol_version,
+    uint32_t magic, records& out)
+{
+    message::frame decoder(magic);
+    const auto end = capture.data() + capture.size();
+
+    for (size_t offset = 0; offset < capture.size();)
+    {
+        decoder.reset();
+        const auto begin = capture.data() + offset;
+        const auto ec = decoder.decode(protocol_version,
+            data_slice(begin, end));
+
+        if (ec)
+            return ec;
+
+        if (!decoder.complete())
+            return error::bad_stream;
+
+        out.push_back({ offset, decoder.size(), decoder.type() });
+        offset += decoder.size();
+    }
+
+    return error::success;
+}
+
+// Decode the heading, verify the checksum and parse the payload.
+template <typename Handler>
+static code replay(const data_chunk& capture, const record& entry,
+    uint32_t protocol_version, message::frame& decoder, Handler& handler)
+{
+    const auto begin = capture.data() + entry.offset;
+    decoder.reset();
+    const auto ec = decoder.decode(protocol_version,
+        data_slice(begin, begin + entry.size));
+
+    return ec ? ec :
+        message::registry::dispatch(protocol_version, decoder, handler);
+}
+
+// Returns the elapsed seconds of the work run once on each of the threads.
+template <typename Work>
+static double measure(size_t threads, Work work)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers.emplace_back(work);
+
+    for (auto& worker: workers)
+        worker.join();
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Profile a warm pass over the capture on this thread, by message type.
+static void profile(const data_chunk& capture, const records& frames,
+    const std::vector<encoder>& encoders, uint32_t protocol_version,
+    uint32_t magic, std::vector<statistics>& out)
+{
+    message::frame decoder(magic);
+    discarder handler;
+
+    // Warm the message pools, so that the profile reflects steady state.
+    for (const auto& entry: frames)
+        replay(capture, entry, protocol_version, decoder, handler);
+
+    counting = true;
+
+    for (size_t index = 0; index < frames.size(); ++index)
+    {
+        const auto& entry = frames[index];
+        auto& stats = out[static_cast<size_t>(entry.type)];
+        ++stats.messages;
+        stats.bytes += entry.size;
+
+        auto start = allocations.load();
+        const auto ec = replay(capture, entry, protocol_version, decoder,
+            handler);
+        stats.decode_allocations += allocations.load() - start;
+
+        if (ec)
+        {
+            ++stats.failures;
+            continue;
+        }
+
+        start = allocations.load();
+        const auto wire = encoders[index]();
+        stats.encode_allocations += allocations.load() - start;
+    }
+
+    counting = false;
+}
+
+static void report(const std::string& name, size_t messages, size_t bytes,
+    double seconds)
+{
+    const auto rate = [seconds](size_t value)
+    {
+        return seconds > 0.0 ? value / seconds : 0.0;
+    };
+
+    bc::cout << std::left << std::setw(8) << name << std::right
+        << std::fixed << std::setprecision(0)
+        << std::setw(14) << rate(messages) << " msgs/s"
+        << std::setprecision(2)
+        << std::setw(12) << rate(bytes) / 1000000.0 << " MB/s"
+        << std::setprecision(3)
+        << std::setw(10) << seconds << " s" << std::endl;
+}
+
+int bc::main(int argc, char* argv[])
+{
+    set_utf8_stdio();
+
+    std::string path;
+    size_t threads;
+    size_t repeat;
+    uint32_t magic;
+    uint32_t protocol_version;
+
+    po::options_description options("Options");
+    options.add_options()
+        ("help,h", "Show this help.")
+        ("capture,c", po::value<std::string>(&path)->default_value(
+            "examples/replay_sample.dat"), "The capture file to replay.")
+        ("threads,t", po::value<size_t>(&threads)->default_value(1),
+            "The number of threads replaying the capture concurrently.")
+        ("repeat,r", po::value<size_t>(&repeat)->default_value(100),
+            "The number of times each thread replays the capture.")
+        ("magic,m", po::value<uint32_t>(&magic)->default_value(
+            mainnet_magic), "The network magic of the capture.")
+        ("protocol,p", po::value<uint32_t>(&protocol_version)->default_value(
+            message::version::level::maximum), "The protocol version.");
+
+    po::positional_options_description positional;
+    positional.add("capture", 1);
+
+    try
+    {
+        po::variables_map variables;
+        po::store(po::command_line_parser(argc, argv).options(options)
+            .positional(positional).run(), variables);
+        po::notify(variables);
+
+        if (variables.count("help") != 0)
+        {
+            bc::cout << "Usage: libbitcoin_replay [options] [capture]"
+                << std::endl << options << std::endl;
+            return EXIT_SUCCESS;
+        }
+    }
+    catch (const po::error& error)
+    {
+        bc::cerr << error.what() << std::endl << options << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (threads == 0 || repeat == 0)
+    {
+        bc::cerr << "Threads and repeat must be non-zero." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    data_chunk capture;
+
+    if (!load(path, capture))
+    {
+        bc::cerr << "Failed to read capture: " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    records frames;
+    const auto ec = split(capture, protocol_version, magic, frames);
+
+    if (ec)
+    {
+        bc::cerr << "Invalid frame at message " << frames.size() << ": "
+            << ec.message() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Parse once to retain each message for the encoding passes.
+    std::vector<encoder> encoders(frames.size());
+    size_t encoded_messages = 0;
+    size_t encoded_bytes = 0;
+    {
+        message::frame decoder(magic);
+        collector handler(protocol_version, magic);
+
+        for (size_t index = 0; index < frames.size(); ++index)
+        {
+            if (replay(capture, frames[index], protocol_version, decoder,
+                handler))
+                continue;
+
+            encoders[index] = handler.take();
+            ++encoded_messages;
+            encoded_bytes += frames[index].size;
+        }
+    }
+
+    const auto decode = [&]()
+    {
+        message::frame decoder(magic);
+        discarder handler;
+
+        for (size_t pass = 0; pass < repeat; ++pass)
+            for (const auto& entry: frames)
+                replay(capture, entry, protocol_version, decoder, handler);
+    };
+
+    std::atomic<size_t> written(0);
+    const auto encode = [&]()
+    {
+        size_t bytes = 0;
+
+        for (size_t pass = 0; pass < repeat; ++pass)
+            for (const auto& encoder: encoders)
+                if (encoder)
+                    bytes += encoder().size();
+
+        written += bytes;
+    };
+
+    const auto decode_seconds = measure(threads, decode);
+    const auto encode_seconds = measure(threads, encode);
+    BITCOIN_ASSERT(written == encoded_bytes * threads * repeat);
+
+    std::vector<statistics> types(message::registry::size + 1,
+        statistics{ 0, 0, 0, 0, 0 });
+    profile(capture, frames, encoders, protocol_version, magic, types);
+
+    const auto passes = threads * repeat;
+    bc::cout << "capture : " << path << " (" << frames.size()
+        << " messages, " << capture.size() << " bytes)" << std::endl;
+    bc::cout << "replay  : " << threads << " threads x " << repeat
+        << " passes" << std::endl << std::endl;
+    report("decode", frames.size() * passes, capture.size() * passes,
+        decode_seconds);
+    report("encode", encoded_messages * passes, encoded_bytes * passes,
+        encode_seconds);
+
+    bc::cout << std::endl << std::left << std::setw(14) << "command"
+        << std::right << std::setw(8) << "count" << std::setw(12) << "bytes"
+        << std::setw(8) << "failed" << std::setw(16) << "decode allocs"
+        << std::setw(16) << "encode allocs" << std::endl;
+
+    for (size_t index = 0; index < types.size(); ++index)
+    {
+        const auto& stats = types[index];
+
+        if (stats.messages == 0)
+            continue;
+
+        const auto type = static_cast<message::message_type>(index);
+        const auto command = index == 0 ? std::string("(unknown)") :
+            message::registry::command(type);
+        const auto encoded = stats.messages - stats.failures;
+        const auto average = [](size_t total, size_t count)
+        {
+            return count == 0 ? 0.0 : static_cast<double>(total) / count;
+        };
+
+        // Allocations are per message, in a single threaded warm pass.
+        bc::cout << std::left << std::setw(14) << command << std::right
+            << std::setw(8) << stats.messages
+            << std::setw(12) << stats.bytes
+            << std::setw(8) << stats.failures << std::fixed
+            << std::setprecision(2)
+            << std::setw(16) << average(stats.decode_allocations,
+                stats.messages)
+            << std::setw(16) << average(stats.encode_allocations, encoded)
+            << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
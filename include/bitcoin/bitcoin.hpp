@@ -23,6 +23,13 @@
 #include <bitcoin/bitcoin/messages.hpp>
 #include <bitcoin/bitcoin/version.hpp>
 #include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/block_assembler.hpp>
+#include <bitcoin/bitcoin/chain/block_file_reader.hpp>
+#include <bitcoin/bitcoin/chain/block_filter.hpp>
+#include <bitcoin/bitcoin/chain/block_parser.hpp>
+#include <bitcoin/bitcoin/chain/block_pipeline.hpp>
+#include <bitcoin/bitcoin/chain/chain_state.hpp>
+#include <bitcoin/bitcoin/chain/checkpoint_policy.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
 #include <bitcoin/bitcoin/chain/history.hpp>
 #include <bitcoin/bitcoin/chain/input.hpp>
@@ -32,6 +39,10 @@
 #include <bitcoin/bitcoin/chain/spend.hpp>
 #include <bitcoin/bitcoin/chain/stealth.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/chain/transaction_graph.hpp>
+#include <bitcoin/bitcoin/chain/transaction_parser.hpp>
+#include <bitcoin/bitcoin/chain/transaction_pool.hpp>
+#include <bitcoin/bitcoin/chain/utxo_snapshot.hpp>
 #include <bitcoin/bitcoin/chain/script/opcode.hpp>
 #include <bitcoin/bitcoin/chain/script/operation.hpp>
 #include <bitcoin/bitcoin/chain/script/script.hpp>
@@ -59,19 +70,24 @@
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/math/hash_number.hpp>
+#include <bitcoin/bitcoin/math/multiset_hash.hpp>
 #include <bitcoin/bitcoin/math/script_number.hpp>
 #include <bitcoin/bitcoin/math/stealth.hpp>
 #include <bitcoin/bitcoin/math/uint256.hpp>
 #include <bitcoin/bitcoin/message/address.hpp>
+#include <bitcoin/bitcoin/message/address_table.hpp>
 #include <bitcoin/bitcoin/message/alert.hpp>
 #include <bitcoin/bitcoin/message/alert_payload.hpp>
 #include <bitcoin/bitcoin/message/block_message.hpp>
+#include <bitcoin/bitcoin/message/block_reconstructor.hpp>
 #include <bitcoin/bitcoin/message/block_transactions.hpp>
+#include <bitcoin/bitcoin/message/bloom_filter.hpp>
 #include <bitcoin/bitcoin/message/compact_block.hpp>
 #include <bitcoin/bitcoin/message/fee_filter.hpp>
 #include <bitcoin/bitcoin/message/filter_add.hpp>
 #include <bitcoin/bitcoin/message/filter_clear.hpp>
 #include <bitcoin/bitcoin/message/filter_load.hpp>
+#include <bitcoin/bitcoin/message/frame.hpp>
 #include <bitcoin/bitcoin/message/get_address.hpp>
 #include <bitcoin/bitcoin/message/get_block_transactions.hpp>
 #include <bitcoin/bitcoin/message/get_blocks.hpp>
@@ -84,12 +100,16 @@
 #include <bitcoin/bitcoin/message/inventory_vector.hpp>
 #include <bitcoin/bitcoin/message/memory_pool.hpp>
 #include <bitcoin/bitcoin/message/merkle_block.hpp>
+#include <bitcoin/bitcoin/message/message_pool.hpp>
 #include <bitcoin/bitcoin/message/network_address.hpp>
 #include <bitcoin/bitcoin/message/not_found.hpp>
 #include <bitcoin/bitcoin/message/ping.hpp>
 #include <bitcoin/bitcoin/message/pong.hpp>
 #include <bitcoin/bitcoin/message/prefilled_transaction.hpp>
+#include <bitcoin/bitcoin/message/registry.hpp>
 #include <bitcoin/bitcoin/message/reject.hpp>
+#include <bitcoin/bitcoin/message/relay_cache.hpp>
+#include <bitcoin/bitcoin/message/rolling_bloom_filter.hpp>
 #include <bitcoin/bitcoin/message/send_compact_blocks.hpp>
 #include <bitcoin/bitcoin/message/send_headers.hpp>
 #include <bitcoin/bitcoin/message/transaction_message.hpp>
@@ -113,6 +133,8 @@
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/deadline.hpp>
 #include <bitcoin/bitcoin/utility/decorator.hpp>
 #include <bitcoin/bitcoin/utility/delegates.hpp>
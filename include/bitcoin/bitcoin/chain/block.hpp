@@ -20,6 +20,8 @@
 #ifndef LIBBITCOIN_CHAIN_BLOCK_HPP
 #define LIBBITCOIN_CHAIN_BLOCK_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <istream>
 #include <memory>
@@ -27,8 +29,14 @@
 #include <vector>
 #include <bitcoin/bitcoin/chain/header.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash_number.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -41,6 +49,8 @@ public:
 	typedef std::vector<block> list;
 	typedef std::shared_ptr<block> ptr;
 	typedef std::vector<ptr> ptr_list;
+	typedef std::shared_ptr<const block> const_ptr;
+	typedef std::vector<const_ptr> const_ptr_list;
 	typedef std::vector<size_t> indexes;
 
 	// TODO: remove
@@ -131,6 +141,17 @@ public:
 		return build_merkle_tree(tx_hashes);
 	}
 
+	static hash_digest generate_merkle_root(const transaction::const_ptr_list& transactions)
+	{
+		// Shared transactions reuse their cached hashes.
+		hash_list tx_hashes;
+		tx_hashes.reserve(transactions.size());
+		for (const auto& tx: transactions)
+			tx_hashes.push_back(tx->hash());
+
+		return build_merkle_tree(tx_hashes);
+	}
+
 	block genesis_mainnet()
 	{
 		data_chunk raw_block;
@@ -158,6 +179,7 @@ public:
 	}
 
 	block()
+		: transactions_size_(0)
 	{
 	}
 
@@ -167,21 +189,24 @@ public:
 	{
 	}
 
-	block(const chain::header& header, const chain::transaction::list& transactions)
+	block(const chain::header& header, const chain::transaction::const_ptr_list& transactions)
 		: header(header)
 		, transactions(transactions)
+		, transactions_size_(0)
 	{
 	}
 
 	block(block&& other)
 		: block(std::forward<chain::header>(other.header)
-		, std::forward<chain::transaction::list>(other.transactions))
+		, std::forward<chain::transaction::const_ptr_list>(other.transactions))
 	{
+		transactions_size_ = other.transactions_size_.exchange(0);
 	}
 
-	block(chain::header&& header, chain::transaction::list&& transactions)
+	block(chain::header&& header, chain::transaction::const_ptr_list&& transactions)
 		: header(std::forward<chain::header>(header))
-		, transactions(std::forward<chain::transaction::list>(transactions))
+		, transactions(std::forward<chain::transaction::const_ptr_list>(transactions))
+		, transactions_size_(0)
 	{
 	}
 
@@ -190,14 +215,15 @@ public:
 	{
 		header = std::move(other.header);
 		transactions = std::move(other.transactions);
+		transactions_size_ = other.transactions_size_.exchange(0);
 		return *this;
 	}
 	void operator=(const block&) = delete;
 
 	bool from_data(const data_chunk& data, bool with_transaction_count=true)
 	{
-		data_source istream(data);
-		return from_data(istream, with_transaction_count);
+		data_reader source(data);
+		return from_data(source, with_transaction_count);
 	}
 
 	bool from_data(std::istream& stream, bool with_transaction_count=true)
@@ -208,37 +234,28 @@ public:
 
 	bool from_data(reader& source, bool with_transaction_count=true)
 	{
-		reset();
+		return read(source, with_transaction_count);
+	}
 
-		auto result = header.from_data(source, with_transaction_count);
+	/// Parsing from contiguous memory caches the transaction sizes, and so
+	/// the block caches their sum.
+	bool from_data(data_reader& source, bool with_transaction_count=true)
+	{
+		const auto result = read(source, with_transaction_count);
 
 		if (result)
-		{
-			transactions.resize(header.transaction_count);
-
-			for (auto& tx: transactions)
-			{
-				result = tx.from_data(source);
-
-				if (!result)
-					break;
-			}
-		}
-
-		if (!result)
-			reset();
+			transactions_size_ = transactions_serialized_size();
 
 		return result;
 	}
 
 	data_chunk to_data(bool with_transaction_count=true) const
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream, with_transaction_count);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size(with_transaction_count));
-		return data;
+		const auto size = serialized_size(with_transaction_count);
+		return write_chunk(size, [&](data_writer& sink)
+		{
+			to_data(sink, with_transaction_count);
+		});
 	}
 
 	void to_data(std::ostream& stream, bool with_transaction_count=true) const
@@ -249,10 +266,12 @@ public:
 
 	void to_data(writer& sink, bool with_transaction_count=true) const
 	{
-		header.to_data(sink, with_transaction_count);
+		write(sink, with_transaction_count);
+	}
 
-		for (const auto& tx: transactions)
-			tx.to_data(sink);
+	void to_data(data_writer& sink, bool with_transaction_count=true) const
+	{
+		write(sink, with_transaction_count);
 	}
 
 	bool is_valid() const
@@ -260,25 +279,174 @@ public:
 		return !transactions.empty() || header.is_valid();
 	}
 
+	/// True if the header hash satisfies its own (bounded) target.
+	bool is_valid_proof_of_work() const
+	{
+		hash_number target;
+		if (!target.set_compact(header.bits) || target > max_target())
+			return false;
+
+		hash_number value;
+		value.set_hash(header.hash());
+		return value <= target;
+	}
+
+	/// Context free checks, independent of chain state.
+	/// Transaction hashes are computed once and point and hash duplicates
+	/// are found by sorting flat arrays, so the cost is linear in the inputs
+	/// apart from the sort.
+	code check() const
+	{
+		if (transactions.empty() || serialized_size() > max_block_size)
+			return error::size_limits;
+
+		if (!is_valid_proof_of_work())
+			return error::proof_of_work;
+
+		if (!transactions.front()->is_coinbase())
+			return error::first_not_coinbase;
+
+		for (auto tx = transactions.begin() + 1; tx != transactions.end(); ++tx)
+			if ((*tx)->is_coinbase())
+				return error::extra_coinbases;
+
+		size_t spends = 0;
+
+		for (const auto& tx: transactions)
+		{
+			const auto ec = tx->check();
+
+			if (ec)
+				return ec;
+
+			spends += tx->inputs.size();
+		}
+
+		hash_list hashes;
+		hashes.reserve(transactions.size());
+
+		for (const auto& tx: transactions)
+			hashes.push_back(tx->hash());
+
+		auto sorted = hashes;
+		std::sort(sorted.begin(), sorted.end());
+
+		// Duplicate transactions also preclude merkle tree malleation.
+		if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+			return error::duplicate;
+
+		// Transactions are individually free of duplicate inputs, so any
+		// duplicate here is a spend of the same output by two transactions.
+		point::list points;
+		points.reserve(spends);
+
+		for (auto tx = transactions.begin() + 1; tx != transactions.end(); ++tx)
+			for (const auto& input: (*tx)->inputs)
+				points.push_back(input.previous_output);
+
+		std::sort(points.begin(), points.end());
+
+		if (std::adjacent_find(points.begin(), points.end()) != points.end())
+			return error::double_spend;
+
+		if (build_merkle_tree(hashes) != header.merkle)
+			return error::merkle_mismatch;
+
+		return error::success;
+	}
+
 	void reset()
 	{
 		header.reset();
 		transactions.clear();
 		transactions.shrink_to_fit();
+		invalidate_cache();
+	}
+
+	/// Reset, retaining the capacity of the transaction list, so that an
+	/// instance may be reused for parsing without reallocating the list.
+	void clear()
+	{
+		header.reset();
+		transactions.clear();
+		invalidate_cache();
+	}
+
+	/// Clear the cached size, required after changing the transactions of a
+	/// parsed block.
+	void invalidate_cache()
+	{
+		transactions_size_ = 0;
 	}
 
 	uint64_t serialized_size(bool with_transaction_count=true) const
 	{
-		auto block_size = header.serialized_size(with_transaction_count);
+		// The header size is constant time, the transactions size is set
+		// only by parsing.
+		const auto block_size = header.serialized_size(with_transaction_count);
+		const uint64_t cached = transactions_size_;
 
-		for (const auto& tx: transactions)
-			block_size += tx.serialized_size();
+		if (cached != 0)
+			return block_size + cached;
 
-		return block_size;
+		return block_size + transactions_serialized_size();
 	}
 
 	chain::header header;
-	transaction::list transactions;
+
+	/// The transactions are shared and immutable, so that a transaction is
+	/// one allocation from parsing through the pool, relay and assembly,
+	/// and a copy of the block shares them.
+	transaction::const_ptr_list transactions;
+
+private:
+	template <typename Source>
+	bool read(Source& source, bool with_transaction_count)
+	{
+		clear();
+
+		auto result = header.from_data(source, with_transaction_count);
+
+		if (result)
+		{
+			const auto count = header.transaction_count;
+			const auto available = std::min(source.remaining(), max_block_size);
+			bounded_reserve(transactions, count, available, min_transaction_size);
+
+			for (uint64_t index = 0; index < count && result; ++index)
+			{
+				const auto tx = std::make_shared<transaction>();
+				result = tx->from_data(source);
+				transactions.push_back(tx);
+			}
+		}
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	uint64_t transactions_serialized_size() const
+	{
+		uint64_t size = 0;
+
+		for (const auto& tx: transactions)
+			size += tx->serialized_size();
+
+		return size;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink, bool with_transaction_count) const
+	{
+		header.to_data(sink, with_transaction_count);
+
+		for (const auto& tx: transactions)
+			tx->to_data(sink);
+	}
+
+	std::atomic<uint64_t> transactions_size_;
 };
 
 } // namspace chain
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_ASSEMBLER_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_ASSEMBLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/script/script.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/chain/transaction_pool.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Assembles block templates from a transaction pool. Transactions are
+/// selected greedily by ancestor score, the fee rate of a transaction with
+/// its unselected ancestors, as in the satoshi client: a package is added
+/// whole, ancestors first, if it fits within the size and signature operation
+/// limits, and the scores of its descendants are then raised by the removal
+/// of the selected ancestors from their packages.
+/// New arrivals are appended by update without reselection, so a template
+/// is refreshed cheaply between blocks. After a block the pool should be
+/// updated and the selection rebuilt.
+/// This class is not thread safe, and the pool must not change during a
+/// rebuild or update.
+class BC_API block_assembler
+{
+public:
+    /// Space and signature operations reserved for the coinbase.
+    static const size_t coinbase_reserved_size;
+    static const size_t coinbase_reserved_sigops;
+
+    block_assembler(const transaction_pool& pool,
+        size_t max_size=max_block_size, size_t max_sigops=max_block_sigops);
+
+    /// This class is not copyable.
+    block_assembler(const block_assembler&) = delete;
+    void operator=(const block_assembler&) = delete;
+
+    /// Select from the whole pool, discarding any prior selection.
+    void rebuild();
+
+    /// Append the pooled arrivals (each with any unselected ancestors) that
+    /// fit within the remaining limits. Selected transactions are not
+    /// displaced, so better paying arrivals that do not fit wait for the
+    /// next rebuild. Returns the number of transactions appended.
+    size_t update(const hash_list& arrivals);
+
+    /// A block of the header, with its merkle root, and the selection
+    /// following a coinbase that pays the subsidy and fees to the script.
+    /// The coinbase script commits to the height (bip34).
+    block assemble(const header& header, size_t height,
+        const script& output_script) const;
+
+    /// The selected transactions, in dependency order.
+    const transaction::const_ptr_list& transactions() const;
+
+    /// The total fees of the selected transactions.
+    uint64_t fees() const;
+
+    /// The total serialized size of the selected transactions.
+    size_t size() const;
+
+    /// The total signature operations of the selected transactions.
+    size_t sigops() const;
+
+private:
+    typedef std::unordered_set<hash_digest> hash_set;
+
+    hash_list package(const hash_digest& hash) const;
+    bool fits(const hash_list& package) const;
+    void select(hash_list& package);
+    void reset();
+
+    const transaction_pool& pool_;
+    const size_t max_size_;
+    const size_t max_sigops_;
+
+    transaction::const_ptr_list transactions_;
+    hash_set selected_;
+    uint64_t fees_;
+    size_t size_;
+    size_t sigops_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
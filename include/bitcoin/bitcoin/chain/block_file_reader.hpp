@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_FILE_READER_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_FILE_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Imports blocks from bitcoind block files (blk*.dat), in which each block
+/// is framed by the network magic and a four byte payload size.
+/// Files are memory mapped and the framing is scanned into an offset index.
+/// Headers are hashed and blocks are parsed in parallel on the threadpool,
+/// and blocks are delivered in height order of the longest chain linked
+/// from genesis, regardless of their order in the files.
+/// Methods block the calling thread, which must not be a pool thread.
+/// This class is not thread safe.
+class BC_API block_file_reader
+{
+public:
+    typedef boost::filesystem::path path;
+    typedef std::function<bool(block::const_ptr, size_t)> block_handler;
+
+    static const size_t default_window;
+
+    block_file_reader(threadpool& pool, uint32_t magic);
+
+    /// This class is not copyable.
+    block_file_reader(const block_file_reader&) = delete;
+    void operator=(const block_file_reader&) = delete;
+
+    /// Map the files and index their framed blocks, false if not mappable.
+    bool open(const std::vector<path>& files);
+
+    /// The number of framed blocks indexed (including stale and orphans).
+    size_t size() const;
+
+    /// Hash headers and link the longest chain from genesis, returning its
+    /// number of blocks. Stale and orphan blocks are excluded.
+    size_t link();
+
+    /// Parse linked blocks in parallel, a window at a time (overlapping
+    /// delivery of one window with parsing of the next), and invoke the
+    /// handler for each in height order on this thread. Returns false if a
+    /// block fails to parse or the handler returns false.
+    bool read(block_handler handler, size_t window=default_window);
+
+private:
+    struct entry
+    {
+        size_t file;
+        size_t offset;
+        size_t size;
+        hash_digest hash;
+        hash_digest previous;
+    };
+
+    typedef std::vector<block::const_ptr> block_list;
+    typedef std::shared_ptr<block_list> block_list_ptr;
+
+    typedef std::function<void(const code&)> result_handler;
+
+    void scan(size_t file);
+    void hash_headers(size_t first, result_handler handler);
+    void parse_block(block_list_ptr blocks, size_t first, size_t position,
+        result_handler handler);
+    std::future<void> parse_window(block_list_ptr blocks, size_t first);
+
+    const uint32_t magic_;
+    dispatcher dispatch_;
+    std::vector<boost::iostreams::mapped_file_source> files_;
+    std::vector<entry> entries_;
+    std::vector<size_t> chain_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
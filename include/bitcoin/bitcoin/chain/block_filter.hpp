@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_FILTER_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// BIP158 basic compact block filter, a Golomb-Rice coded set of the
+/// siphashed output scripts of a block and the previous output scripts
+/// spent by it, keyed by the block hash. Queries are hashed and sorted so
+/// that any number of them are tested in a single pass over the coded set.
+/// The filter is immutable once built or loaded, so is thread safe.
+class BC_API block_filter
+{
+public:
+    typedef std::vector<block_filter> list;
+
+    /// The Golomb-Rice parameter (P) of the basic filter.
+    static const uint8_t golomb_bits;
+
+    /// The inverse false positive rate (M) of the basic filter.
+    static const uint64_t inverse_rate;
+
+    /// The basic filter elements of the block, sorted and unique. The spent
+    /// scripts are the (unprefixed) previous output scripts of its inputs,
+    /// in any order, as the coinbase spends none.
+    static data_stack basic_elements(const block& block,
+        const data_stack& spent_scripts);
+
+    /// The basic filter of the block.
+    static block_filter factory_from_block(const block& block,
+        const data_stack& spent_scripts);
+
+    /// The basic filters of the blocks, built in parallel on the threadpool,
+    /// with the spent scripts of each block at its position. This blocks
+    /// the calling thread, which must not be a pool thread.
+    static list factory_from_blocks(threadpool& pool,
+        const block::const_ptr_list& blocks,
+        const std::vector<data_stack>& spent_scripts);
+
+    /// The headers of the filters of successive blocks, each committing to
+    /// its filter and the header before it, starting from the previous.
+    static hash_list headers(const list& filters,
+        const hash_digest& previous_header);
+
+    /// An empty filter of the null hash.
+    block_filter();
+
+    /// The filter of the set of elements, which must be unique.
+    block_filter(const hash_digest& block_hash, const data_stack& elements);
+
+    /// Load a serialized filter of the block, false if the set size does
+    /// not parse (the coded set is not validated until matched).
+    bool from_data(const hash_digest& block_hash, const data_chunk& data);
+
+    /// The serialized filter, the set size followed by the coded set.
+    const data_chunk& to_data() const;
+
+    /// The hash of the block to which the filter belongs.
+    const hash_digest& block_hash() const;
+
+    /// The number of elements in the set.
+    uint64_t size() const;
+
+    /// The hash of the serialized filter.
+    const hash_digest& hash() const;
+
+    /// The header of the filter, given the header of the previous filter.
+    hash_digest header(const hash_digest& previous_header) const;
+
+    /// True if the element is probably in the set.
+    bool match(data_slice element) const;
+
+    /// True if any of the elements is probably in the set.
+    bool match_any(const data_stack& elements) const;
+
+private:
+    typedef std::vector<uint64_t> value_list;
+    typedef std::function<void(const code&)> result_handler;
+
+    static void build(list& filters, const block::const_ptr_list& blocks,
+        const std::vector<data_stack>& spent_scripts, size_t position,
+        result_handler handler);
+
+    value_list hash_elements(const data_stack& elements) const;
+    bool match_any(const value_list& sorted) const;
+
+    hash_digest block_hash_;
+    hash_digest hash_;
+    uint64_t size_;
+    data_chunk data_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_PARSER_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/chain/transaction_parser.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Resumable parser for a serialized block received in fragments, such as
+/// successive socket reads of a block message payload.
+/// The header is available once its 80 bytes arrive and each transaction
+/// (with its hash) is emitted as soon as its last byte arrives, so parsing
+/// and hashing overlap the transfer. Framing errors are reported early.
+/// This class is not thread safe.
+class BC_API block_parser
+{
+public:
+    typedef std::function<void(transaction::const_ptr, const hash_digest&)>
+        transaction_handler;
+
+    block_parser(transaction_handler handler);
+
+    /// Consume a fragment, invoking the handler for each completed
+    /// transaction. Returns the framing error, which is sticky, if any.
+    /// Bytes beyond the end of the block are a framing error.
+    code write(data_slice data);
+
+    /// True once the header has been received.
+    bool has_header() const;
+
+    /// The block header, valid once received.
+    const chain::header& block_header() const;
+
+    /// The number of transactions declared by the block.
+    uint64_t transaction_count() const;
+
+    /// The number of transactions emitted.
+    uint64_t transactions_parsed() const;
+
+    /// True once all declared transactions have been emitted.
+    bool complete() const;
+
+    /// Prepare for another block, retaining buffer capacity.
+    void reset();
+
+private:
+    enum class stage
+    {
+        header,
+        transaction_count,
+        transactions,
+        complete,
+        failed
+    };
+
+    code read_header(data_slice data, size_t& offset);
+    code read_count(data_slice data, size_t& offset);
+    code fail(const code& ec);
+
+    transaction_handler handler_;
+    stage stage_;
+    code error_;
+    bool has_header_;
+    chain::header header_;
+    uint64_t count_;
+    uint64_t parsed_;
+    data_chunk buffer_;
+    transaction_parser transaction_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_PIPELINE_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_PIPELINE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/enable_shared_from_base.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Staged validation of a stream of serialized blocks.
+/// The decode stage (deserialization, hashing and context free checks) runs
+/// concurrently across blocks on the threadpool. The connect stage (caller
+/// supplied, such as prevout resolution and script verification) runs on a
+/// strand in push order, so decoding of later blocks overlaps connection of
+/// earlier ones and throughput is bounded by the slowest stage.
+/// Each stage queue is bounded, push fails (without side effect) when full.
+/// Once a block fails, each later block completes as previous_block_invalid.
+/// This class is thread safe.
+class BC_API block_pipeline
+  : public enable_shared_from_base<block_pipeline>
+{
+public:
+    typedef std::shared_ptr<block_pipeline> ptr;
+    typedef std::function<code(const block&)> connect_handler;
+    typedef std::function<void(const code&, block::const_ptr)>
+        complete_handler;
+
+    /// The connect and complete handlers are invoked in push order.
+    block_pipeline(threadpool& pool, connect_handler connect,
+        complete_handler complete, size_t decode_capacity,
+        size_t connect_capacity);
+
+    /// This class is not copyable.
+    block_pipeline(const block_pipeline&) = delete;
+    void operator=(const block_pipeline&) = delete;
+
+    /// Queue a serialized block, false if stopped or a stage queue is full.
+    bool push(data_chunk&& data);
+
+    /// The number of blocks pushed and not yet completed.
+    size_t pending() const;
+
+    /// Reject pushes, pending blocks complete in order as service_stopped.
+    void stop();
+
+private:
+    struct slot
+    {
+        bool ready;
+        code result;
+        block::const_ptr instance;
+    };
+
+    void decode(size_t sequence, std::shared_ptr<data_chunk> data);
+    void connect();
+
+    // These are thread safe.
+    const connect_handler connect_;
+    const complete_handler complete_;
+    const size_t decode_capacity_;
+    const size_t window_;
+    dispatcher dispatch_;
+
+    // These are protected by mutex.
+    std::vector<slot> slots_;
+    size_t decoding_;
+    size_t pushed_;
+    size_t completed_;
+    bool connecting_;
+    bool failed_;
+    bool stopped_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
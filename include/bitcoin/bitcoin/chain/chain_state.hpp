@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_CHAIN_STATE_HPP
+#define LIBBITCOIN_CHAIN_CHAIN_STATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Contextual header state over a header sequence beginning at genesis.
+/// Each header is reduced to a 12 byte record (timestamp, bits and testnet
+/// reference bits), so any height can be queried without the headers.
+/// The median time past of the top is maintained incrementally so that
+/// streaming validation does not collect and sort timestamps per header.
+/// This class is not thread safe.
+class BC_API chain_state
+{
+public:
+    chain_state(bool testnet=false);
+
+    /// Reserve record space for the expected number of headers.
+    void reserve(size_t headers);
+
+    /// Append the header at the next height (the first header is genesis).
+    void push(const header& header);
+
+    /// Remove all headers above the given height (for reorganization).
+    void pop_to(size_t height);
+
+    /// True if no header has been pushed.
+    bool empty() const;
+
+    /// The number of headers pushed.
+    size_t size() const;
+
+    /// The height of the top header, zero if empty.
+    size_t height() const;
+
+    /// The median time past at the top header, computed in constant time.
+    uint32_t median_time_past() const;
+
+    /// The median time past at the header of the given height.
+    uint32_t median_time_past(size_t height) const;
+
+    /// The compact work required of the next header given its timestamp.
+    uint32_t work_required(uint32_t timestamp) const;
+
+    /// The compact work required of the header at the given height.
+    /// The height may not exceed size(), the timestamp applies to testnet.
+    uint32_t work_required(size_t height, uint32_t timestamp) const;
+
+    /// Check the timestamp and work of the next header against the top.
+    code check(const header& header) const;
+
+private:
+    struct record
+    {
+        uint32_t timestamp;
+        uint32_t bits;
+        uint32_t reference_bits;
+    };
+
+    uint32_t retarget(size_t height) const;
+    void rebuild_window();
+
+    const bool testnet_;
+    std::vector<record> records_;
+
+    // The timestamps of the top median_time_past_interval records, sorted.
+    std::vector<uint32_t> window_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
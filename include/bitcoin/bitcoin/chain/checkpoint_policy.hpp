@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_CHECKPOINT_POLICY_HPP
+#define LIBBITCOIN_CHAIN_CHECKPOINT_POLICY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <bitcoin/bitcoin/config/checkpoint.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Assumed-valid validation policy over a list of trusted checkpoints.
+/// Checkpoints are held sorted by height, so lookups are O(log n).
+/// Once a header branch is linked to a checkpoint, every block at or below
+/// that checkpoint on the branch is an ancestor of it and may skip script
+/// and signature verification. Merkle, proof of work and unspent output
+/// accounting are unaffected and remain the caller's responsibility.
+/// Callers must only apply verify_scripts to blocks of the linked branch.
+/// This class is thread safe.
+class BC_API checkpoint_policy
+{
+public:
+    checkpoint_policy(const config::checkpoint::list& checkpoints);
+
+    /// This class is not copyable.
+    checkpoint_policy(const checkpoint_policy&) = delete;
+    void operator=(const checkpoint_policy&) = delete;
+
+    /// False if a checkpoint exists at the height with a different hash.
+    bool validate(const hash_digest& hash, size_t height) const;
+
+    /// True if a checkpoint exists at the height with the same hash.
+    bool is_checkpoint(const hash_digest& hash, size_t height) const;
+
+    /// The height of the highest checkpoint, zero if there are none.
+    size_t top_height() const;
+
+    /// Validate the header and link the branch if it is a checkpoint.
+    /// Returns false if the header conflicts with a checkpoint.
+    bool link(const hash_digest& hash, size_t height);
+
+    /// The height of the highest checkpoint linked, zero if none.
+    size_t linked_height() const;
+
+    /// False if the block at the height is an ancestor of a linked
+    /// checkpoint, in which case script verification may be skipped.
+    bool verify_scripts(size_t height) const;
+
+private:
+    typedef config::checkpoint::list::const_iterator iterator;
+    typedef std::pair<iterator, iterator> range;
+
+    range find(size_t height) const;
+
+    const config::checkpoint::list checkpoints_;
+    std::atomic<size_t> linked_height_;
+    std::atomic<bool> linked_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
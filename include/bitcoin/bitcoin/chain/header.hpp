@@ -28,6 +28,8 @@
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -144,8 +146,8 @@ public:
 
 	bool from_data(const data_chunk& data, bool with_transaction_count = true)
 	{
-		data_source istream(data);
-		return from_data(istream, with_transaction_count);
+		data_reader source(data);
+		return from_data(source, with_transaction_count);
 	}
 
 	bool from_data(std::istream& stream, bool with_transaction_count = true)
@@ -156,34 +158,21 @@ public:
 
 	bool from_data(reader& source, bool with_transaction_count = true)
 	{
-		reset();
-
-		version = source.read_4_bytes_little_endian();
-		previous_block_hash = source.read_hash();
-		merkle = source.read_hash();
-		timestamp = source.read_4_bytes_little_endian();
-		bits = source.read_4_bytes_little_endian();
-		nonce = source.read_4_bytes_little_endian();
-		transaction_count = 0;
-		if (with_transaction_count)
-			transaction_count = source.read_variable_uint_little_endian();
-
-		const auto result = static_cast<bool>(source);
-
-		if (!result)
-			reset();
+		return read(source, with_transaction_count);
+	}
 
-		return result;
+	bool from_data(data_reader& source, bool with_transaction_count = true)
+	{
+		return read(source, with_transaction_count);
 	}
 
 	data_chunk to_data(bool with_transaction_count = true) const
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream, with_transaction_count);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size(with_transaction_count));
-		return data;
+		const auto size = serialized_size(with_transaction_count);
+		return write_chunk(size, [&](data_writer& sink)
+		{
+			to_data(sink, with_transaction_count);
+		});
 	}
 
 	void to_data(std::ostream& stream, bool with_transaction_count = true) const
@@ -194,15 +183,12 @@ public:
 
 	void to_data(writer& sink, bool with_transaction_count = true) const
 	{
-		sink.write_4_bytes_little_endian(version);
-		sink.write_hash(previous_block_hash);
-		sink.write_hash(merkle);
-		sink.write_4_bytes_little_endian(timestamp);
-		sink.write_4_bytes_little_endian(bits);
-		sink.write_4_bytes_little_endian(nonce);
+		write(sink, with_transaction_count);
+	}
 
-		if (with_transaction_count)
-			sink.write_variable_uint_little_endian(transaction_count);
+	void to_data(data_writer& sink, bool with_transaction_count = true) const
+	{
+		write(sink, with_transaction_count);
 	}
 
 	hash_digest hash() const
@@ -273,6 +259,43 @@ public:
 	uint64_t transaction_count;
 
 private:
+	template <typename Source>
+	bool read(Source& source, bool with_transaction_count)
+	{
+		reset();
+
+		version = source.read_4_bytes_little_endian();
+		previous_block_hash = source.read_hash();
+		merkle = source.read_hash();
+		timestamp = source.read_4_bytes_little_endian();
+		bits = source.read_4_bytes_little_endian();
+		nonce = source.read_4_bytes_little_endian();
+		transaction_count = 0;
+		if (with_transaction_count)
+			transaction_count = source.read_variable_uint_little_endian();
+
+		const auto result = static_cast<bool>(source);
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink, bool with_transaction_count) const
+	{
+		sink.write_4_bytes_little_endian(version);
+		sink.write_hash(previous_block_hash);
+		sink.write_hash(merkle);
+		sink.write_4_bytes_little_endian(timestamp);
+		sink.write_4_bytes_little_endian(bits);
+		sink.write_4_bytes_little_endian(nonce);
+
+		if (with_transaction_count)
+			sink.write_variable_uint_little_endian(transaction_count);
+	}
+
 	mutable upgrade_mutex mutex_;
 	mutable std::shared_ptr<hash_digest> hash_;
 };
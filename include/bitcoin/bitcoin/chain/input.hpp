@@ -26,6 +26,8 @@
 #include <bitcoin/bitcoin/chain/script/script.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -71,8 +73,8 @@ public:
 
 	bool from_data(const data_chunk& data)
 	{
-		data_source istream(data);
-		return from_data(istream);
+		data_reader source(data);
+		return from_data(source);
 	}
 
 	bool from_data(std::istream& stream)
@@ -83,40 +85,20 @@ public:
 
 	bool from_data(reader& source)
 	{
-		reset();
-
-		auto result = previous_output.from_data(source);
-
-		if (result)
-		{
-			auto mode = script::parse_mode::raw_data_fallback;
-
-			if (previous_output.is_null())
-				mode = script::parse_mode::raw_data;
-
-			result = script.from_data(source, true, mode);
-		}
-
-		if (result)
-		{
-			sequence = source.read_4_bytes_little_endian();
-			result = source;
-		}
-
-		if (!result)
-			reset();
+		return read(source);
+	}
 
-		return result;
+	bool from_data(data_reader& source)
+	{
+		return read(source);
 	}
 
 	data_chunk to_data() const
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size());
-		return data;
+		return write_chunk(serialized_size(), [&](data_writer& sink)
+		{
+			to_data(sink);
+		});
 	}
 
 	void to_data(std::ostream& stream) const
@@ -127,9 +109,12 @@ public:
 
 	void to_data(writer& sink) const
 	{
-		previous_output.to_data(sink);
-		script.to_data(sink, true);
-		sink.write_4_bytes_little_endian(sequence);
+		write(sink);
+	}
+
+	void to_data(data_writer& sink) const
+	{
+		write(sink);
 	}
 
 	std::string to_string(uint32_t flags) const
@@ -172,6 +157,44 @@ public:
 	output_point previous_output;
 	chain::script script;
 	uint32_t sequence;
+
+private:
+	template <typename Source>
+	bool read(Source& source)
+	{
+		reset();
+
+		auto result = previous_output.from_data(source);
+
+		if (result)
+		{
+			auto mode = script::parse_mode::raw_data_fallback;
+
+			if (previous_output.is_null())
+				mode = script::parse_mode::raw_data;
+
+			result = script.from_data(source, true, mode);
+		}
+
+		if (result)
+		{
+			sequence = source.read_4_bytes_little_endian();
+			result = source;
+		}
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink) const
+	{
+		previous_output.to_data(sink);
+		script.to_data(sink, true);
+		sink.write_4_bytes_little_endian(sequence);
+	}
 };
 
 } // namspace chain
@@ -26,6 +26,8 @@
 #include <bitcoin/bitcoin/chain/point.hpp>
 #include <bitcoin/bitcoin/chain/script/script.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -63,8 +65,8 @@ public:
 
 	bool from_data(const data_chunk& data)
 	{
-		data_source istream(data);
-		return from_data(istream);
+		data_reader source(data);
+		return from_data(source);
 	}
 
 	bool from_data(std::istream& stream)
@@ -75,29 +77,20 @@ public:
 
 	bool from_data(reader& source)
 	{
-		reset();
-
-		value = source.read_8_bytes_little_endian();
-		auto result = static_cast<bool>(source);
-
-		if (result)
-			result = script.from_data(source, true,
-				script::parse_mode::raw_data_fallback);
-
-		if (!result)
-			reset();
+		return read(source);
+	}
 
-		return result;
+	bool from_data(data_reader& source)
+	{
+		return read(source);
 	}
 
 	data_chunk to_data() const
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size());
-		return data;
+		return write_chunk(serialized_size(), [&](data_writer& sink)
+		{
+			to_data(sink);
+		});
 	}
 
 	void to_data(std::ostream& stream) const
@@ -108,8 +101,12 @@ public:
 
 	void to_data(writer& sink) const
 	{
-		sink.write_8_bytes_little_endian(value);
-		script.to_data(sink, true);
+		write(sink);
+	}
+
+	void to_data(data_writer& sink) const
+	{
+		write(sink);
 	}
 
 	bool is_valid() const
@@ -140,6 +137,32 @@ public:
 
 	uint64_t value;
 	chain::script script;
+
+private:
+	template <typename Source>
+	bool read(Source& source)
+	{
+		reset();
+
+		value = source.read_8_bytes_little_endian();
+		auto result = static_cast<bool>(source);
+
+		if (result)
+			result = script.from_data(source, true,
+				script::parse_mode::raw_data_fallback);
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink) const
+	{
+		sink.write_8_bytes_little_endian(value);
+		script.to_data(sink, true);
+	}
 };
 
 struct BC_API output_info
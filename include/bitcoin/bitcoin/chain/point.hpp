@@ -29,6 +29,8 @@
 #include <bitcoin/bitcoin/chain/point_iterator.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -110,8 +112,8 @@ public:
 
 	bool from_data(const data_chunk& data)
 	{
-		data_source istream(data);
-		return from_data(istream);
+		data_reader source(data);
+		return from_data(source);
 	}
 
 	bool from_data(std::istream& stream)
@@ -122,26 +124,20 @@ public:
 
 	bool from_data(reader& source)
 	{
-		reset();
-
-		hash = source.read_hash();
-		index = source.read_4_bytes_little_endian();
-		const auto result = static_cast<bool>(source);
-
-		if (!result)
-			reset();
+		return read(source);
+	}
 
-		return result;
+	bool from_data(data_reader& source)
+	{
+		return read(source);
 	}
 
 	data_chunk to_data() const
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size());
-		return data;
+		return write_chunk(serialized_size(), [&](data_writer& sink)
+		{
+			to_data(sink);
+		});
 	}
 
 	void to_data(std::ostream& stream) const
@@ -152,8 +148,12 @@ public:
 
 	void to_data(writer& sink) const
 	{
-		sink.write_hash(hash);
-		sink.write_4_bytes_little_endian(index);
+		write(sink);
+	}
+
+	void to_data(data_writer& sink) const
+	{
+		write(sink);
 	}
 
 	std::string to_string() const
@@ -186,6 +186,29 @@ public:
 
 	hash_digest hash;
 	uint32_t index;
+
+private:
+	template <typename Source>
+	bool read(Source& source)
+	{
+		reset();
+
+		hash = source.read_hash();
+		index = source.read_4_bytes_little_endian();
+		const auto result = static_cast<bool>(source);
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink) const
+	{
+		sink.write_hash(hash);
+		sink.write_4_bytes_little_endian(index);
+	}
 };
 
 
@@ -194,6 +217,13 @@ bool operator==(const point& left, const point& right)
 	return left.hash == right.hash && left.index == right.index;
 }
 
+// Orders points for sorted duplicate detection, not by any chain order.
+inline bool operator<(const point& left, const point& right)
+{
+	return left.hash < right.hash ||
+		(left.hash == right.hash && left.index < right.index);
+}
+
 // TODO: remove
 //bool operator!=(const point& left, const point& right)
 //{
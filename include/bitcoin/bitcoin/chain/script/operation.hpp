@@ -27,6 +27,8 @@
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -331,8 +333,8 @@ public:
 
 	bool from_data(const data_chunk& data)
 	{
-		data_source istream(data);
-		return from_data(istream);
+		data_reader source(data);
+		return from_data(source);
 	}
 
 	bool from_data(std::istream& stream)
@@ -343,39 +345,20 @@ public:
 
 	bool from_data(reader& source)
 	{
-		reset();
-
-		const auto byte = source.read_byte();
-		auto result = static_cast<bool>(source);
-		auto op_code = static_cast<opcode>(byte);
-
-		if (byte == 0 && op_code != opcode::zero)
-			return false;
-
-		code = ((0 < byte && byte <= 75) ? opcode::special : op_code);
-
-		if (must_read_data(code))
-		{
-			uint32_t size;
-			read_opcode_data_size(size, code, byte, source);
-			data = source.read_data(size);
-			result = (source && (data.size() == size));
-		}
-
-		if (!result)
-			reset();
+		return read(source);
+	}
 
-		return result;
+	bool from_data(data_reader& source)
+	{
+		return read(source);
 	}
 
 	data_chunk to_data() const
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size());
-		return data;
+		return write_chunk(serialized_size(), [&](data_writer& sink)
+		{
+			to_data(sink);
+		});
 	}
 
 	void to_data(std::ostream& stream) const
@@ -386,36 +369,12 @@ public:
 
 	void to_data(writer& sink) const
 	{
-		if (code != opcode::raw_data)
-		{
-			auto raw_byte = static_cast<uint8_t>(code);
-			if (code == opcode::special)
-				raw_byte = static_cast<uint8_t>(data.size());
-
-			sink.write_byte(raw_byte);
-
-			switch (code)
-			{
-				case opcode::pushdata1:
-					sink.write_byte(static_cast<uint8_t>(data.size()));
-					break;
-
-				case opcode::pushdata2:
-					sink.write_2_bytes_little_endian(
-						static_cast<uint16_t>(data.size()));
-					break;
-
-				case opcode::pushdata4:
-					sink.write_4_bytes_little_endian(
-						static_cast<uint32_t>(data.size()));
-					break;
-
-				default:
-					break;
-			}
-		}
+		write(sink);
+	}
 
-		sink.write_data(data);
+	void to_data(data_writer& sink) const
+	{
+		write(sink);
 	}
 
 	std::string to_string(uint32_t flags) const
@@ -477,7 +436,71 @@ public:
 	data_chunk data;
 
 private:
-	static bool read_opcode_data_size(uint32_t& count, opcode code, uint8_t raw_byte, reader& source)
+	template <typename Source>
+	bool read(Source& source)
+	{
+		reset();
+
+		const auto byte = source.read_byte();
+		auto result = static_cast<bool>(source);
+		auto op_code = static_cast<opcode>(byte);
+
+		if (byte == 0 && op_code != opcode::zero)
+			return false;
+
+		code = ((0 < byte && byte <= 75) ? opcode::special : op_code);
+
+		if (must_read_data(code))
+		{
+			uint32_t size;
+			read_opcode_data_size(size, code, byte, source);
+			data = source.read_data(size);
+			result = (source && (data.size() == size));
+		}
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink) const
+	{
+		if (code != opcode::raw_data)
+		{
+			auto raw_byte = static_cast<uint8_t>(code);
+			if (code == opcode::special)
+				raw_byte = static_cast<uint8_t>(data.size());
+
+			sink.write_byte(raw_byte);
+
+			switch (code)
+			{
+				case opcode::pushdata1:
+					sink.write_byte(static_cast<uint8_t>(data.size()));
+					break;
+
+				case opcode::pushdata2:
+					sink.write_2_bytes_little_endian(
+						static_cast<uint16_t>(data.size()));
+					break;
+
+				case opcode::pushdata4:
+					sink.write_4_bytes_little_endian(
+						static_cast<uint32_t>(data.size()));
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		sink.write_data(data);
+	}
+
+	template <typename Source>
+	static bool read_opcode_data_size(uint32_t& count, opcode code, uint8_t raw_byte, Source& source)
 	{
 		switch (code)
 		{
@@ -28,6 +28,8 @@
 #include <bitcoin/bitcoin/chain/script/operation.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -125,9 +127,11 @@ public:
     bool from_data(const data_chunk& data, bool prefix, parse_mode mode);
     bool from_data(std::istream& stream, bool prefix, parse_mode mode);
     bool from_data(reader& source, bool prefix, parse_mode mode);
+    bool from_data(data_reader& source, bool prefix, parse_mode mode);
     data_chunk to_data(bool prefix) const;
     void to_data(std::ostream& stream, bool prefix) const;
     void to_data(writer& sink, bool prefix) const;
+    void to_data(data_writer& sink, bool prefix) const;
 
     bool from_string(const std::string& human_readable);
     std::string to_string(uint32_t flags) const;
@@ -139,6 +143,12 @@ public:
     operation::stack operations;
 
 private:
+    template <typename Source>
+    bool read(Source& source, bool prefix, parse_mode mode);
+
+    template <typename Sink>
+    void write(Sink& sink, bool prefix) const;
+
     bool deserialize(const data_chunk& raw_script, parse_mode mode);
     bool parse(const data_chunk& raw_script);
 };
@@ -20,15 +20,24 @@
 #ifndef LIBBITCOIN_CHAIN_TRANSACTION_HPP
 #define LIBBITCOIN_CHAIN_TRANSACTION_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <istream>
 #include <memory>
 #include <string>
 #include <vector>
+#include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/script/opcode.hpp>
+#include <bitcoin/bitcoin/chain/script/script.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -42,6 +51,13 @@ public:
 	typedef std::vector<transaction> list;
 	typedef std::shared_ptr<transaction> ptr;
 	typedef std::vector<ptr> ptr_list;
+
+	/// Immutable shared transactions, for handoff between relay, the pool
+	/// and blocks without copying scripts or recomputing the hash. Blocks
+	/// and transaction messages hold transactions by this pointer, so one
+	/// transaction is one allocation throughout.
+	typedef std::shared_ptr<const transaction> const_ptr;
+	typedef std::vector<const_ptr> const_ptr_list;
 	typedef std::vector<size_t> indexes;
 
 	// TODO: remove
@@ -81,9 +97,12 @@ public:
 		: version(0)
 		, locktime(0)
 		, hash_(nullptr)
+		, size_(0)
 	{
 	}
 
+	/// The fields are mutable, so a copy does not share the cached hash or
+	/// size.
 	transaction::transaction(const transaction& other)
 		: transaction(other.version, other.locktime, other.inputs, other.outputs)
 	{
@@ -95,12 +114,14 @@ public:
 		, inputs(inputs)
 		, outputs(outputs)
 		, hash_(nullptr)
+		, size_(0)
 	{
 	}
 
 	transaction::transaction(transaction&& other)
 		: transaction(other.version, other.locktime, std::forward<input::list>(other.inputs), std::forward<output::list>(other.outputs))
 	{
+		size_ = other.size_.exchange(0);
 	}
 
 	transaction::transaction(uint32_t version, uint32_t locktime, input::list&& inputs, output::list&& outputs)
@@ -109,6 +130,7 @@ public:
 	  , inputs(std::forward<input::list>(inputs))
 	  , outputs(std::forward<output::list>(outputs))
 	  , hash_(nullptr)
+	  , size_(0)
 	{
 	}
 
@@ -119,6 +141,8 @@ public:
 		locktime = other.locktime;
 		inputs = std::move(other.inputs);
 		outputs = std::move(other.outputs);
+		set_cached_hash(nullptr);
+		size_ = other.size_.exchange(0);
 		return *this;
 	}
 
@@ -131,86 +155,75 @@ public:
 		locktime = other.locktime;
 		inputs = other.inputs;
 		outputs = other.outputs;
+		set_cached_hash(nullptr);
+		size_ = 0;
 		return *this;
 	}
 
 	bool transaction::from_data(const data_chunk& data)
 	{
-		data_source istream(data);
-		return from_data(istream);
-	}
-
-	bool transaction::from_data(std::istream& stream)
-	{
-		istream_reader source(stream);
+		data_reader source(data);
 		return from_data(source);
 	}
 
-	bool transaction::from_data(reader& source)
+	/// Parsing from contiguous memory caches the serialized size, provided
+	/// that it matches the bytes consumed. It does not if the source encodes
+	/// a count or length with a non-minimal variable integer, in which case
+	/// the size is computed on demand.
+	bool transaction::from_data(data_reader& source)
 	{
-		reset();
-		version = source.read_4_bytes_little_endian();
-		auto result = static_cast<bool>(source);
+		const auto remaining = source.remaining();
+		const auto result = read(source);
 
 		if (result)
 		{
-			const auto tx_in_count = source.read_variable_uint_little_endian();
-			result = source;
-
-			if (result)
-			{
-				inputs.resize(tx_in_count);
-
-				for (auto& input: inputs)
-				{
-					result = input.from_data(source);
+			const auto size = serialized_size();
 
-					if (!result)
-						break;
-				}
-			}
+			if (size == remaining - source.remaining())
+				size_ = size;
 		}
 
-		if (result)
-		{
-			const auto tx_out_count = source.read_variable_uint_little_endian();
-			result = source;
-
-			if (result)
-			{
-				outputs.resize(tx_out_count);
-
-				for (auto& output: outputs)
-				{
-					result = output.from_data(source);
+		return result;
+	}
 
-					if (!result)
-						break;
-				}
-			}
-		}
+	/// Parse a complete serialization whose hash is already known, such as
+	/// from the checksum of a network frame, caching the hash and size.
+	/// Fails unless the serialization is consumed exactly. The hash is of
+	/// the bytes parsed, so it is cached only if they are the canonical
+	/// serialization, otherwise it is computed on demand as usual.
+	bool transaction::from_data(data_slice data, const hash_digest& hash)
+	{
+		data_reader source(data);
 
-		if (result)
+		if (!from_data(source) || !source.is_exhausted())
 		{
-			locktime = source.read_4_bytes_little_endian();
-			result = source;
+			reset();
+			return false;
 		}
 
-		if (!result)
-			reset();
+		if (serialized_size() == data.size())
+			set_cached_hash(std::make_shared<hash_digest>(hash));
 
-		return result;
+		return true;
 	}
 
-	data_chunk transaction::to_data() const
+	bool transaction::from_data(std::istream& stream)
 	{
-		data_chunk data;
-		data_sink ostream(data);
-		to_data(ostream);
-		ostream.flush();
-		BITCOIN_ASSERT(data.size() == serialized_size());
+		istream_reader source(stream);
+		return from_data(source);
+	}
 
-		return data;
+	bool transaction::from_data(reader& source)
+	{
+		return read(source);
+	}
+
+	data_chunk transaction::to_data() const
+	{
+		return write_chunk(serialized_size(), [&](data_writer& sink)
+		{
+			to_data(sink);
+		});
 	}
 
 	void transaction::to_data(std::ostream& stream) const
@@ -221,18 +234,12 @@ public:
 
 	void transaction::to_data(writer& sink) const
 	{
-		sink.write_4_bytes_little_endian(version);
-		sink.write_variable_uint_little_endian(inputs.size());
-
-		for (const auto& input: inputs)
-			input.to_data(sink);
-
-		sink.write_variable_uint_little_endian(outputs.size());
-
-		for (const auto& output: outputs)
-			output.to_data(sink);
+		write(sink);
+	}
 
-		sink.write_4_bytes_little_endian(locktime);
+	void transaction::to_data(data_writer& sink) const
+	{
+		write(sink);
 	}
 
 	std::string transaction::to_string(uint32_t flags) const
@@ -269,9 +276,29 @@ public:
 		outputs.clear();
 		outputs.shrink_to_fit();
 
+		invalidate_cache();
+	}
+
+	/// Reset, retaining the capacity of the input and output lists, so that
+	/// an instance may be reused for parsing without reallocation.
+	void transaction::clear()
+	{
+		version = 0;
+		locktime = 0;
+		inputs.clear();
+		outputs.clear();
+
+		invalidate_cache();
+	}
+
+	/// Clear the cached hash and size, required after mutating a parsed
+	/// or hashed transaction.
+	void transaction::invalidate_cache()
+	{
 		mutex_.lock();
 		hash_.reset();
 		mutex_.unlock();
+		size_ = 0;
 	}
 
 	hash_digest transaction::hash() const
@@ -341,6 +368,106 @@ public:
 		return locktime_set;
 	}
 
+	/// True if any previous output is spent by more than one input.
+	bool has_duplicate_inputs() const
+	{
+		// Small input sets are compared pairwise, avoiding allocation.
+		if (inputs.size() <= pairwise_duplicate_limit)
+		{
+			for (auto it = inputs.begin(); it != inputs.end(); ++it)
+				for (auto other = it + 1; other != inputs.end(); ++other)
+					if (it->previous_output == other->previous_output)
+						return true;
+
+			return false;
+		}
+
+		point::list points;
+		points.reserve(inputs.size());
+
+		for (const auto& input: inputs)
+			points.push_back(input.previous_output);
+
+		std::sort(points.begin(), points.end());
+		return std::adjacent_find(points.begin(), points.end()) != points.end();
+	}
+
+	/// Context free checks, independent of chain state and other transactions.
+	code check() const
+	{
+		if (inputs.empty() || outputs.empty())
+			return error::empty_transaction;
+
+		if (serialized_size() > max_block_size)
+			return error::size_limits;
+
+		// Each value is limited, so the total cannot overflow before the test.
+		uint64_t total = 0;
+
+		for (const auto& output: outputs)
+		{
+			if (output.value > max_money())
+				return error::output_value_overflow;
+
+			total += output.value;
+
+			if (total > max_money())
+				return error::output_value_overflow;
+		}
+
+		if (is_coinbase())
+		{
+			const auto size = inputs.front().script.serialized_size(false);
+
+			if (size < min_coinbase_size || size > max_coinbase_size)
+				return error::invalid_coinbase_script_size;
+		}
+		else
+		{
+			for (const auto& input: inputs)
+				if (input.previous_output.is_null())
+					return error::previous_output_null;
+		}
+
+		if (has_duplicate_inputs())
+			return error::double_spend;
+
+		return error::success;
+	}
+
+	/// The legacy count of signature operations in the input and output
+	/// scripts, as limited by max_block_sigops. Each multisig counts as the
+	/// maximum number of keys, as the count is not known without execution.
+	size_t signature_operations() const
+	{
+		const auto count = [](const script& script)
+		{
+			size_t total = 0;
+
+			for (const auto& op: script.operations)
+			{
+				if (op.code == opcode::checksig ||
+					op.code == opcode::checksigverify)
+					++total;
+				else if (op.code == opcode::checkmultisig ||
+					op.code == opcode::checkmultisigverify)
+					total += multisig_default_sigops;
+			}
+
+			return total;
+		};
+
+		size_t total = 0;
+
+		for (const auto& input: inputs)
+			total += count(input.script);
+
+		for (const auto& output: outputs)
+			total += count(output.script);
+
+		return total;
+	}
+
 	uint64_t transaction::total_output_value() const
 	{
 		const auto value = [](uint64_t total, const output& output)
@@ -353,6 +480,13 @@ public:
 
 	uint64_t transaction::serialized_size() const
 	{
+		// Set only by parsing, and not guarded by the mutex as hash()
+		// serializes while holding it. No transaction size is zero.
+		const uint64_t cached = size_;
+
+		if (cached != 0)
+			return cached;
+
 		uint64_t tx_size = 8;
 		tx_size += variable_uint_size(inputs.size());
 		for (const auto& input: inputs)
@@ -371,8 +505,93 @@ public:
 	output::list outputs;
 
 private:
+	static constexpr size_t pairwise_duplicate_limit = 16;
+
+	template <typename Source>
+	bool read(Source& source)
+	{
+		clear();
+		version = source.read_4_bytes_little_endian();
+		auto result = static_cast<bool>(source);
+
+		if (result)
+		{
+			const auto tx_in_count = source.read_variable_uint_little_endian();
+			result = source;
+
+			if (result)
+			{
+				const auto available = std::min(source.remaining(), max_block_size);
+				bounded_reserve(inputs, tx_in_count, available, min_input_size);
+
+				for (uint64_t index = 0; index < tx_in_count && result; ++index)
+				{
+					inputs.emplace_back();
+					result = inputs.back().from_data(source);
+				}
+			}
+		}
+
+		if (result)
+		{
+			const auto tx_out_count = source.read_variable_uint_little_endian();
+			result = source;
+
+			if (result)
+			{
+				const auto available = std::min(source.remaining(), max_block_size);
+				bounded_reserve(outputs, tx_out_count, available, min_output_size);
+
+				for (uint64_t index = 0; index < tx_out_count && result; ++index)
+				{
+					outputs.emplace_back();
+					result = outputs.back().from_data(source);
+				}
+			}
+		}
+
+		if (result)
+		{
+			locktime = source.read_4_bytes_little_endian();
+			result = source;
+		}
+
+		if (!result)
+			reset();
+
+		return result;
+	}
+
+	template <typename Sink>
+	void write(Sink& sink) const
+	{
+		sink.write_4_bytes_little_endian(version);
+		sink.write_variable_uint_little_endian(inputs.size());
+
+		for (const auto& input: inputs)
+			input.to_data(sink);
+
+		sink.write_variable_uint_little_endian(outputs.size());
+
+		for (const auto& output: outputs)
+			output.to_data(sink);
+
+		sink.write_4_bytes_little_endian(locktime);
+	}
+
+	void set_cached_hash(std::shared_ptr<hash_digest> hash)
+	{
+		///////////////////////////////////////////////////////////////////////////
+		// Critical Section
+		mutex_.lock();
+		hash_ = hash;
+		mutex_.unlock();
+		///////////////////////////////////////////////////////////////////////////
+	}
+
 	mutable upgrade_mutex mutex_;
 	mutable std::shared_ptr<hash_digest> hash_;
+	mutable std::atomic<uint64_t> size_;
 };
 
 } // namspace chain
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_TRANSACTION_GRAPH_HPP
+#define LIBBITCOIN_CHAIN_TRANSACTION_GRAPH_HPP
+
+#include <cstddef>
+#include <vector>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// The dependency graph of an ordered transaction set, such as a block.
+/// An input depends on the transaction of the set that created its previous
+/// output, if any. Transactions of one level depend only on lower levels, so
+/// each level may resolve prevouts and verify scripts concurrently, waiting
+/// only at level boundaries. Level zero holds all independent transactions.
+/// Txids are matched by binary search of a sorted array (no tree or hash
+/// table allocation per transaction).
+/// This class is not thread safe.
+class BC_API transaction_graph
+{
+public:
+    typedef std::vector<size_t> indexes;
+    typedef std::vector<indexes> level_list;
+
+    /// The source of an input that spends an output not created in the set.
+    static const size_t external;
+
+    transaction_graph(const transaction::const_ptr_list& transactions);
+
+    /// False if any input spends a transaction at or after its own position,
+    /// which is invalid in a block. Such inputs are not linked as parents.
+    bool is_valid() const;
+
+    /// The number of transactions in the set.
+    size_t size() const;
+
+    /// The position of the transaction that the input spends, or external.
+    size_t source(size_t transaction, size_t input) const;
+
+    /// The distinct positions, in ascending order, of the transactions that
+    /// this one spends.
+    const indexes& parents(size_t transaction) const;
+
+    /// The level of the transaction, one greater than its highest parent.
+    size_t level(size_t transaction) const;
+
+    /// Transaction positions grouped by level, ascending within each level.
+    const level_list& levels() const;
+
+private:
+    bool valid_;
+    indexes offsets_;
+    indexes sources_;
+    indexes levels_of_;
+    level_list parents_;
+    level_list levels_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_TRANSACTION_PARSER_HPP
+#define LIBBITCOIN_CHAIN_TRANSACTION_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Resumable parser for one serialized transaction received in fragments.
+/// Field boundaries are tracked as bytes arrive, so counts and script sizes
+/// that cannot fit in a block are rejected before the rest is received.
+/// Once the final byte arrives the transaction is deserialized and hashed
+/// from the buffered bytes, without reserialization.
+/// This class is not thread safe.
+class BC_API transaction_parser
+{
+public:
+    transaction_parser();
+
+    /// Consume bytes up to the end of the transaction and return the number
+    /// consumed. Bytes beyond the transaction are left to the caller.
+    size_t write(data_slice data);
+
+    /// True once the transaction is complete.
+    bool complete() const;
+
+    /// The framing error, success if none.
+    code error() const;
+
+    /// The parsed transaction, null until complete.
+    transaction::const_ptr result() const;
+
+    /// The transaction hash (txid), valid once complete. This is of the
+    /// canonical serialization, even if the parsed counts are non-minimal.
+    const hash_digest& hash() const;
+
+    /// The number of bytes consumed for the transaction.
+    size_t size() const;
+
+    /// Prepare for another transaction, retaining buffer capacity.
+    void reset();
+
+private:
+    enum class stage
+    {
+        version,
+        input_count,
+        previous_output,
+        input_script_size,
+        input_script,
+        sequence,
+        output_count,
+        value,
+        output_script_size,
+        output_script,
+        lock_time,
+        complete,
+        failed
+    };
+
+    static bool is_variable(stage value);
+
+    void expect(stage next, size_t bytes);
+    bool read_variable(uint64_t& value);
+    bool advance();
+    bool advance(uint64_t value);
+    bool finish();
+    bool fail(const code& ec);
+
+    stage stage_;
+    code error_;
+    size_t need_;
+    size_t field_;
+    uint64_t inputs_;
+    uint64_t outputs_;
+    data_chunk buffer_;
+    transaction::const_ptr result_;
+    hash_digest hash_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_TRANSACTION_POOL_HPP
+#define LIBBITCOIN_CHAIN_TRANSACTION_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Unconfirmed transactions keyed by txid and indexed by the outputs they
+/// spend and by fee rate. The fee and size of the in-pool ancestors and
+/// descendants of each transaction are maintained as packages, so that:
+/// the lowest fee rate package is evicted in O(log n) to keep the pool within
+/// its byte budget, the transactions that pass a peer's fee filter are found
+/// without a scan, and block templates may be selected by ancestor fee rate.
+/// Fee rates are in satoshis per kilobyte, the units of fee_filter, and sizes
+/// are serialized sizes. Fees are provided by the caller, as the pool has no
+/// access to previous outputs.
+/// This class is not thread safe.
+class BC_API transaction_pool
+{
+public:
+    /// The totals of a transaction and its ancestors, or its descendants.
+    struct package
+    {
+        uint64_t fee;
+        uint64_t size;
+        size_t count;
+
+        /// The fee rate of the package in satoshis per kilobyte.
+        uint64_t rate() const;
+    };
+
+    struct entry
+    {
+        chain::transaction::const_ptr transaction;
+        uint64_t fee;
+        uint64_t size;
+        size_t sigops;
+
+        /// Including the transaction itself.
+        package ancestors;
+        package descendants;
+
+        /// Transactions of the pool spent by, and spending, this one.
+        hash_list parents;
+        hash_list children;
+
+        /// The fee rate of the transaction alone.
+        uint64_t rate() const;
+    };
+
+    /// Entries ordered by fee rate, then txid, lowest first.
+    typedef std::pair<uint64_t, hash_digest> rate_key;
+    typedef std::set<rate_key> rate_index;
+
+    /// The limit on ancestors and on descendants of a transaction, each
+    /// including the transaction itself.
+    static const size_t max_package_count;
+
+    transaction_pool(uint64_t byte_budget);
+
+    /// This class is not copyable.
+    transaction_pool(const transaction_pool&) = delete;
+    void operator=(const transaction_pool&) = delete;
+
+    /// Add a transaction with the fee it pays, then evict the lowest fee rate
+    /// packages until the pool is within budget. Returns duplicate if it is
+    /// pooled, coinbase_transaction for a coinbase, double_spend if it spends
+    /// an output spent in the pool, size_limits if a package limit would be
+    /// exceeded, and pool_filled if the transaction itself was evicted.
+    code store(transaction::const_ptr tx, uint64_t fee);
+
+    /// Remove the confirmed transactions of the block, retaining their
+    /// descendants, and remove pooled transactions (with descendants) that
+    /// conflict with the block.
+    void remove(const block& block);
+
+    /// Remove the transaction and its descendants, false if not pooled.
+    bool remove(const hash_digest& hash);
+
+    /// The entry of the transaction, or nullptr if it is not pooled.
+    /// The pointer is invalidated by any change to the pool.
+    const entry* find(const hash_digest& hash) const;
+
+    /// True if the transaction is pooled.
+    bool exists(const hash_digest& hash) const;
+
+    /// The txid of the pooled transaction that spends the output, if any.
+    bool spender(hash_digest& out, const output_point& outpoint) const;
+
+    /// The txids of all pooled ancestors of the entry, excluding itself.
+    hash_list ancestors(const entry& entry) const;
+
+    /// The txids of all pooled descendants of the entry, excluding itself.
+    hash_list descendants(const entry& entry) const;
+
+    /// Txids of transactions with a fee rate of at least the minimum fee
+    /// (of a fee_filter), in descending order of fee rate.
+    hash_list filter(uint64_t minimum_fee) const;
+
+    /// Entries by ancestor score, the lower of the fee rate of the
+    /// transaction and of its ancestor package, for block selection.
+    const rate_index& ancestor_scores() const;
+
+    /// The number of pooled transactions.
+    size_t size() const;
+
+    /// The total serialized size of pooled transactions.
+    uint64_t bytes() const;
+
+private:
+    typedef std::unordered_map<hash_digest, entry> entry_map;
+    typedef std::unordered_map<output_point, hash_digest> spend_map;
+
+    static rate_key ancestor_key(const hash_digest& hash,
+        const entry& entry);
+    static rate_key descendant_key(const hash_digest& hash,
+        const entry& entry);
+
+    void remove_entry(const hash_digest& hash);
+    void remove_package(const hash_digest& hash);
+
+    const uint64_t byte_budget_;
+    uint64_t bytes_;
+    entry_map entries_;
+    spend_map spends_;
+    rate_index fee_rates_;
+    rate_index ancestor_scores_;
+    rate_index descendant_scores_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_UTXO_SNAPSHOT_HPP
+#define LIBBITCOIN_CHAIN_UTXO_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/math/multiset_hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// An unspent output with the context required to validate its spend.
+/// Serialized as the point followed by varints of (height << 1 | coinbase)
+/// and value, and the prefixed script. The serialization is also the element
+/// of the unspent output set commitment, so a node may maintain the
+/// commitment per block by inserting created and removing spent records.
+struct BC_API utxo_record
+{
+    typedef std::vector<utxo_record> list;
+
+    bool from_data(reader& source);
+    data_chunk to_data() const;
+    void to_data(writer& sink) const;
+    uint64_t serialized_size() const;
+
+    /// True if the point of this record sorts before that of the other.
+    bool precedes(const utxo_record& other) const;
+
+    output_point point;
+    uint32_t height;
+    bool coinbase;
+    chain::output output;
+};
+
+/// The fixed size header of an unspent output set snapshot.
+struct BC_API snapshot_header
+{
+    static const uint32_t current_version;
+    static const size_t satoshi_fixed_size;
+
+    bool from_data(reader& source);
+    void to_data(writer& sink) const;
+
+    uint32_t version;
+    uint32_t height;
+    hash_digest block_hash;
+
+    /// The multiset_hash digest of the serialized records.
+    hash_digest commitment;
+    uint64_t count;
+};
+
+/// Writes a snapshot as the header followed by chunks, each a varint record
+/// count and that many records, in strictly ascending point order.
+/// This class is not thread safe.
+class BC_API snapshot_writer
+{
+public:
+    static const size_t default_chunk_records;
+
+    /// The header is written immediately, it must carry the final count and
+    /// commitment (such as from the commitment maintained per block).
+    snapshot_writer(std::ostream& stream, const snapshot_header& header,
+        size_t chunk_records=default_chunk_records);
+
+    /// Append a record, false if out of order or the stream has failed.
+    bool write(const utxo_record& record);
+
+    /// Flush the last chunk, false unless the records written match the
+    /// count and commitment of the header.
+    bool finish();
+
+private:
+    bool flush();
+
+    ostream_writer sink_;
+    const snapshot_header header_;
+    const size_t chunk_records_;
+    data_chunk chunk_;
+    size_t pending_;
+    uint64_t written_;
+    utxo_record last_;
+    multiset_hash commitment_;
+    bool failed_;
+};
+
+/// Streams a snapshot one chunk at a time, so that the set is never held in
+/// memory. Order and commitment are verified as records are read, the
+/// commitment is confirmed by complete() once the last chunk is consumed.
+/// Callers should stage loaded records until the snapshot is complete.
+/// This class is not thread safe.
+class BC_API snapshot_reader
+{
+public:
+    /// Chunks larger than this are rejected, bounding memory per read.
+    static const size_t max_chunk_records;
+
+    snapshot_reader(std::istream& stream);
+
+    /// Read and validate the header, must precede reading records.
+    bool start();
+
+    /// The header read by start().
+    const snapshot_header& header() const;
+
+    /// Read the next chunk (reusing capacity), false if there are no more
+    /// records or the stream is invalid, unsorted or exceeds the count.
+    bool read(utxo_record::list& records);
+
+    /// True once all records have been read and match the commitment.
+    bool complete() const;
+
+private:
+    bool fail();
+
+    istream_reader source_;
+    snapshot_header header_;
+    uint64_t remaining_;
+    utxo_record last_;
+    multiset_hash commitment_;
+    bool started_;
+    bool failed_;
+    bool complete_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -52,6 +52,32 @@ constexpr uint32_t coinbase_maturity = 100;
 constexpr uint32_t initial_block_reward = 50;
 constexpr uint32_t max_work_bits = 0x1d00ffff;
 constexpr uint32_t max_input_sequence = max_uint32;
+constexpr size_t max_block_size = 1000000;
+constexpr size_t min_coinbase_size = 2;
+constexpr size_t max_coinbase_size = 100;
+constexpr size_t max_block_sigops = max_block_size / 50;
+constexpr size_t multisig_default_sigops = 20;
+
+// The smallest serializations, which bound counts read from untrusted input
+// by the chain and message readers and the streaming parsers alike. An input
+// is a point (36), empty script (1) and sequence (4), an output a value (8)
+// and empty script (1), and a transaction a version (4), input and output
+// counts (1 each) and a locktime (4), as a transaction of no inputs or
+// outputs is well formed, though invalid.
+constexpr size_t min_input_size = 41;
+constexpr size_t min_output_size = 9;
+constexpr size_t min_transaction_size = 10;
+
+// Timestamp and work consensus constants.
+constexpr size_t median_time_past_interval = 11;
+constexpr uint32_t retargeting_factor = 4;
+constexpr uint32_t target_spacing_seconds = 10 * 60;
+constexpr uint32_t target_timespan_seconds = 2 * 7 * 24 * 60 * 60;
+constexpr size_t retargeting_interval =
+    target_timespan_seconds / target_spacing_seconds;
+
+// The testnet minimum difficulty block is allowed after twice the spacing.
+constexpr uint32_t easy_spacing_seconds = 2 * target_spacing_seconds;
 
 // Threshold for nLockTime: below this value it is interpreted as block number,
 // otherwise as UNIX timestamp. [Tue Nov 5 00:53:20 1985 UTC]
@@ -73,6 +99,13 @@ constexpr uint64_t max_money()
         max_money_recursive(coin_price(initial_block_reward));
 }
 
+// The reward halves each interval, until it is shifted out entirely.
+constexpr uint64_t block_subsidy(size_t height)
+{
+    return height / reward_interval >= 64 ? 0 :
+        coin_price(initial_block_reward) >> (height / reward_interval);
+}
+
 // For configuration settings initialization.
 enum class settings
 {
@@ -23,9 +23,11 @@
 #include <algorithm>
 #include <iterator>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <iostream>
 #include <vector>
+#include <bitcoin/bitcoin/utility/assert.hpp>
 
 namespace libbitcoin {
 
@@ -80,6 +82,15 @@ void move_append(std::vector<Type>& target, std::vector<Type>& source)
     source.clear();
 }
 
+template <typename Type>
+void bounded_reserve(std::vector<Type>& list, uint64_t count,
+    size_t available, size_t minimum_size)
+{
+    BITCOIN_ASSERT(minimum_size > 0);
+    const uint64_t bound = available / minimum_size;
+    list.reserve(static_cast<size_t>(std::min(count, bound)));
+}
+
 ////template <typename Collection>
 ////Collection reverse(const Collection& list)
 ////{
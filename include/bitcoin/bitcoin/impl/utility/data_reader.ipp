@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATA_READER_IPP
+#define LIBBITCOIN_DATA_READER_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+inline data_reader::data_reader(data_slice data)
+  : position_(data.begin()), end_(data.end()), valid_(true)
+{
+}
+
+inline data_reader::operator bool() const
+{
+    return valid_;
+}
+
+inline bool data_reader::operator!() const
+{
+    return !valid_;
+}
+
+inline bool data_reader::is_exhausted() const
+{
+    return valid_ && position_ == end_;
+}
+
+inline size_t data_reader::remaining() const
+{
+    return static_cast<size_t>(end_ - position_);
+}
+
+inline bool data_reader::consume(size_t size)
+{
+    if (valid_ && size <= remaining())
+        return true;
+
+    valid_ = false;
+    position_ = end_;
+    return false;
+}
+
+inline uint8_t data_reader::read_byte()
+{
+    return consume(1) ? *position_++ : 0;
+}
+
+template <typename T>
+T data_reader::read_big_endian()
+{
+    if (!consume(sizeof(T)))
+        return 0;
+
+    const auto value = from_big_endian_unsafe<T>(position_);
+    position_ += sizeof(T);
+    return value;
+}
+
+template <typename T>
+T data_reader::read_little_endian()
+{
+    if (!consume(sizeof(T)))
+        return 0;
+
+    const auto value = from_little_endian_unsafe<T>(position_);
+    position_ += sizeof(T);
+    return value;
+}
+
+template <unsigned Size>
+byte_array<Size> data_reader::read_bytes()
+{
+    byte_array<Size> out;
+
+    if (consume(Size))
+    {
+        std::copy(position_, position_ + Size, out.begin());
+        position_ += Size;
+    }
+    else
+        out.fill(0);
+
+    return out;
+}
+
+inline uint16_t data_reader::read_2_bytes_little_endian()
+{
+    return read_little_endian<uint16_t>();
+}
+
+inline uint32_t data_reader::read_4_bytes_little_endian()
+{
+    return read_little_endian<uint32_t>();
+}
+
+inline uint64_t data_reader::read_8_bytes_little_endian()
+{
+    return read_little_endian<uint64_t>();
+}
+
+inline uint64_t data_reader::read_variable_uint_little_endian()
+{
+    const auto length = read_byte();
+
+    if (length < 0xfd)
+        return length;
+    else if (length == 0xfd)
+        return read_2_bytes_little_endian();
+    else if (length == 0xfe)
+        return read_4_bytes_little_endian();
+
+    // length should be 0xff
+    return read_8_bytes_little_endian();
+}
+
+inline uint16_t data_reader::read_2_bytes_big_endian()
+{
+    return read_big_endian<uint16_t>();
+}
+
+inline uint32_t data_reader::read_4_bytes_big_endian()
+{
+    return read_big_endian<uint32_t>();
+}
+
+inline uint64_t data_reader::read_8_bytes_big_endian()
+{
+    return read_big_endian<uint64_t>();
+}
+
+inline uint64_t data_reader::read_variable_uint_big_endian()
+{
+    const auto length = read_byte();
+
+    if (length < 0xfd)
+        return length;
+    else if (length == 0xfd)
+        return read_2_bytes_big_endian();
+    else if (length == 0xfe)
+        return read_4_bytes_big_endian();
+
+    // length should be 0xff
+    return read_8_bytes_big_endian();
+}
+
+// A short read returns the bytes that remained, as with istream_reader.
+inline data_chunk data_reader::read_data(size_t size)
+{
+    const auto count = std::min(size, remaining());
+    data_chunk out(position_, position_ + count);
+    position_ += count;
+    consume(size - count);
+    return out;
+}
+
+inline size_t data_reader::read_data(uint8_t* data, size_t size)
+{
+    const auto count = std::min(size, remaining());
+    std::copy(position_, position_ + count, data);
+    position_ += count;
+    consume(size - count);
+    return count;
+}
+
+inline data_chunk data_reader::read_data_to_eof()
+{
+    data_chunk out(position_, end_);
+    position_ = end_;
+    return out;
+}
+
+inline hash_digest data_reader::read_hash()
+{
+    return read_bytes<hash_size>();
+}
+
+inline short_hash data_reader::read_short_hash()
+{
+    return read_bytes<short_hash_size>();
+}
+
+inline mini_hash data_reader::read_mini_hash()
+{
+    return read_bytes<mini_hash_size>();
+}
+
+inline std::string data_reader::read_fixed_string(size_t length)
+{
+    const auto count = std::min(length, remaining());
+    std::string result(position_, position_ + count);
+    position_ += count;
+    consume(length - count);
+
+    // Removes trailing 0s... Needed for string comparisons
+    return result.c_str();
+}
+
+inline std::string data_reader::read_string()
+{
+    const auto size = read_variable_uint_little_endian();
+    const auto length = size > remaining() ? remaining() + 1 :
+        static_cast<size_t>(size);
+
+    return read_fixed_string(length);
+}
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATA_WRITER_IPP
+#define LIBBITCOIN_DATA_WRITER_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+inline data_writer::data_writer(uint8_t* begin, uint8_t* end)
+  : begin_(begin), position_(begin), end_(end), valid_(true)
+{
+}
+
+inline data_writer::data_writer(data_chunk& data)
+  : data_writer(data.data(), data.data() + data.size())
+{
+}
+
+inline data_writer::operator bool() const
+{
+    return valid_;
+}
+
+inline bool data_writer::operator!() const
+{
+    return !valid_;
+}
+
+inline size_t data_writer::size() const
+{
+    return static_cast<size_t>(position_ - begin_);
+}
+
+inline bool data_writer::reserve(size_t size)
+{
+    if (valid_ && size <= static_cast<size_t>(end_ - position_))
+        return true;
+
+    valid_ = false;
+    return false;
+}
+
+inline void data_writer::write_byte(uint8_t value)
+{
+    if (reserve(1))
+        *position_++ = value;
+}
+
+template <typename T>
+void data_writer::write_big_endian(T value)
+{
+    const auto bytes = to_big_endian(value);
+    write_data(bytes.data(), bytes.size());
+}
+
+template <typename T>
+void data_writer::write_little_endian(T value)
+{
+    const auto bytes = to_little_endian(value);
+    write_data(bytes.data(), bytes.size());
+}
+
+inline void data_writer::write_2_bytes_little_endian(uint16_t value)
+{
+    write_little_endian<uint16_t>(value);
+}
+
+inline void data_writer::write_4_bytes_little_endian(uint32_t value)
+{
+    write_little_endian<uint32_t>(value);
+}
+
+inline void data_writer::write_8_bytes_little_endian(uint64_t value)
+{
+    write_little_endian<uint64_t>(value);
+}
+
+inline void data_writer::write_variable_uint_little_endian(uint64_t value)
+{
+    if (value < 0xfd)
+    {
+        write_byte(static_cast<uint8_t>(value));
+    }
+    else if (value <= 0xffff)
+    {
+        write_byte(0xfd);
+        write_2_bytes_little_endian(static_cast<uint16_t>(value));
+    }
+    else if (value <= 0xffffffff)
+    {
+        write_byte(0xfe);
+        write_4_bytes_little_endian(static_cast<uint32_t>(value));
+    }
+    else
+    {
+        write_byte(0xff);
+        write_8_bytes_little_endian(value);
+    }
+}
+
+inline void data_writer::write_2_bytes_big_endian(uint16_t value)
+{
+    write_big_endian<uint16_t>(value);
+}
+
+inline void data_writer::write_4_bytes_big_endian(uint32_t value)
+{
+    write_big_endian<uint32_t>(value);
+}
+
+inline void data_writer::write_8_bytes_big_endian(uint64_t value)
+{
+    write_big_endian<uint64_t>(value);
+}
+
+inline void data_writer::write_variable_uint_big_endian(uint64_t value)
+{
+    if (value < 0xfd)
+    {
+        write_byte(static_cast<uint8_t>(value));
+    }
+    else if (value <= 0xffff)
+    {
+        write_byte(0xfd);
+        write_2_bytes_big_endian(static_cast<uint16_t>(value));
+    }
+    else if (value <= 0xffffffff)
+    {
+        write_byte(0xfe);
+        write_4_bytes_big_endian(static_cast<uint32_t>(value));
+    }
+    else
+    {
+        write_byte(0xff);
+        write_8_bytes_big_endian(value);
+    }
+}
+
+inline void data_writer::write_data(const data_chunk& data)
+{
+    write_data(data.data(), data.size());
+}
+
+inline void data_writer::write_data(const uint8_t* data, size_t size)
+{
+    if (reserve(size))
+        position_ = std::copy(data, data + size, position_);
+}
+
+inline void data_writer::write_hash(const hash_digest& value)
+{
+    write_data(value.data(), value.size());
+}
+
+inline void data_writer::write_short_hash(const short_hash& value)
+{
+    write_data(value.data(), value.size());
+}
+
+inline void data_writer::write_mini_hash(const mini_hash& value)
+{
+    write_data(value.data(), value.size());
+}
+
+inline void data_writer::write_fixed_string(const std::string& value,
+    size_t size)
+{
+    if (!reserve(size))
+        return;
+
+    const auto count = std::min(size, value.size());
+    position_ = std::copy_n(value.begin(), count, position_);
+    position_ = std::fill_n(position_, size - count, 0);
+}
+
+inline void data_writer::write_string(const std::string& value)
+{
+    write_variable_uint_little_endian(value.size());
+    write_fixed_string(value, value.size());
+}
+
+template <typename Serializer>
+data_chunk write_chunk(size_t expected_size, Serializer serialize)
+{
+    data_chunk data(expected_size);
+
+    while (true)
+    {
+        data_writer sink(data);
+        serialize(sink);
+
+        if (sink)
+        {
+            data.resize(sink.size());
+            return data;
+        }
+
+        data.resize(std::max(data.size() * 2, size_t(1)));
+    }
+}
+
+} // namespace libbitcoin
+
+#endif
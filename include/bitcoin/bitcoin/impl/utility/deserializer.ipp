@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <boost/asio/streambuf.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
@@ -62,6 +63,12 @@ bool deserializer<Iterator, SafeCheckLast>::is_exhausted() const
     return (iterator_ == end_);
 }
 
+template <typename Iterator, bool SafeCheckLast>
+size_t deserializer<Iterator, SafeCheckLast>::remaining() const
+{
+    return static_cast<size_t>(std::distance(iterator_, end_));
+}
+
 template <typename Iterator, bool SafeCheckLast>
 uint8_t deserializer<Iterator, SafeCheckLast>::read_byte()
 {
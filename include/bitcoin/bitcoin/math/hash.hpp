@@ -21,6 +21,7 @@
 #define LIBBITCOIN_HASH_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <boost/functional/hash_fwd.hpp>
@@ -181,6 +182,22 @@ BC_API long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
  */
 BC_API hash_digest bitcoin_hash(data_slice data);
 
+/**
+ * Generate a siphash-2-4 hash of data with a 128 bit key. This hash function
+ * is used in bip152 short transaction ids and bip158 filters.
+ *
+ * siphash_2_4(key, data)
+ */
+BC_API uint64_t siphash(const half_hash& key, data_slice data);
+
+/**
+ * Generate a murmur3 (x86 32 bit) hash of data with a seed. This hash
+ * function is used in bip37 bloom filters.
+ *
+ * murmur3_32(data, seed)
+ */
+BC_API uint32_t murmur3(data_slice data, uint32_t seed);
+
 /**
  * Generate a bitcoin short hash. This hash function is used in a
  * few specific cases where short hashes are desired.
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MULTISET_HASH_HPP
+#define LIBBITCOIN_MULTISET_HASH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+
+/// Incremental multiset hash (MuHash) over the multiplicative group of
+/// integers modulo the 3072 bit prime 2^3072 - 1103717, the group of the
+/// satoshi client's MuHash. A group of this size is required for the digest
+/// to commit to the set, as discrete logarithms (and so collisions) are
+/// computable in a group of 256 bit integers. Each element is mapped to the
+/// group by sha512 expansion of its sha256 and multiplied into a numerator
+/// (insert) or a denominator (remove), so the result is independent of order
+/// and may be updated per block without revisiting the set. The single
+/// modular inversion is deferred until the digest is taken.
+class BC_API multiset_hash
+{
+public:
+    /// The empty set.
+    multiset_hash();
+
+    /// Add one instance of the element to the set.
+    void insert(data_slice element);
+
+    /// Remove one instance of the element from the set.
+    void remove(data_slice element);
+
+    /// Add all elements of the other set to this set.
+    multiset_hash& operator+=(const multiset_hash& other);
+
+    /// Remove all elements of the other set from this set.
+    multiset_hash& operator-=(const multiset_hash& other);
+
+    /// True if both represent the same multiset (no inversion required).
+    bool operator==(const multiset_hash& other) const;
+    bool operator!=(const multiset_hash& other) const;
+
+    /// The sha256 of the normalized group element (set commitment).
+    hash_digest digest() const;
+
+    /// Serialize the unnormalized state for persistence between blocks.
+    data_chunk to_data() const;
+
+    /// Restore persisted state, false if the size is not that of the state
+    /// or either value is out of range.
+    bool from_data(const data_chunk& data);
+
+private:
+    // Little endian 32 bit limbs of an integer modulo the prime.
+    typedef std::array<uint32_t, 3072 / 32> number;
+
+    number numerator_;
+    number denominator_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_ADDRESS_TABLE_HPP
+#define LIBBITCOIN_MESSAGE_ADDRESS_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/address.hpp>
+#include <bitcoin/bitcoin/message/network_address.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Table of gossiped peer addresses for outbound selection, of fixed memory.
+/// Each address has one slot in a fixed number of fixed size buckets, chosen
+/// by salted hash of the address and of the group (/16 of IPv4, /32 of IPv6)
+/// of the peer that announced it. Each source group reaches only a few
+/// buckets, so no one peer can displace much of the table. A stored address
+/// is refreshed in place, and the addresses are also held densely so that a
+/// uniform random sample is O(1).
+/// The serialization holds the salt and the slot of each address, so a
+/// loaded table has the same buckets.
+/// This class is thread safe.
+class BC_API address_table
+{
+public:
+    static const size_t bucket_count;
+    static const size_t bucket_size;
+
+    /// The number of buckets that the addresses of one source group reach.
+    static const size_t buckets_per_group;
+
+    /// The age, at the time of a store, by which an address may be displaced
+    /// from its slot by another.
+    static const uint32_t stale_seconds;
+
+    /// The most that an announced timestamp may lead the time of a store,
+    /// and the age given to an announced timestamp that leads by more or is
+    /// implausibly old.
+    static const uint32_t future_seconds;
+    static const uint32_t penalty_seconds;
+
+    /// A table with a random salt.
+    address_table();
+
+    /// A table with the salt, for reproducible bucketing.
+    address_table(const half_hash& salt);
+
+    /// This class is not copyable.
+    address_table(const address_table&) = delete;
+    void operator=(const address_table&) = delete;
+
+    /// Store the address announced by the source at the time now (unix
+    /// seconds). The announced timestamp is first clamped to now, as peers
+    /// may claim any time. If it is stored, refresh its timestamp and
+    /// services. Returns true if the address was added.
+    bool store(const network_address& address, const ip_address& source,
+        uint32_t now);
+
+    /// Store each address of the message, returning the number added.
+    size_t store(const address& message, const ip_address& source,
+        uint32_t now);
+
+    /// Remove the address (of the same ip and port), false if not stored.
+    bool remove(const network_address& address);
+
+    /// True if the address (of the same ip and port) is stored.
+    bool exists(const network_address& address) const;
+
+    /// A uniformly random address, false if the table is empty.
+    bool sample(network_address& out) const;
+
+    /// The number of stored addresses.
+    size_t size() const;
+
+    /// The maximum number of stored addresses.
+    size_t capacity() const;
+
+    /// Remove all addresses, retaining the salt.
+    void clear();
+
+    bool from_data(const data_chunk& data);
+    bool from_data(std::istream& stream);
+    bool from_data(reader& source);
+    bool from_data(data_reader& source);
+    data_chunk to_data() const;
+    void to_data(std::ostream& stream) const;
+    void to_data(writer& sink) const;
+    void to_data(data_writer& sink) const;
+    uint64_t serialized_size() const;
+
+private:
+    typedef byte_array<18> endpoint;
+
+    struct entry
+    {
+        network_address address;
+        uint32_t slot;
+    };
+
+    static endpoint to_endpoint(const network_address& address);
+
+    uint32_t locate(const network_address& address,
+        const ip_address& source) const;
+    bool do_store(const network_address& address, const ip_address& source,
+        uint32_t now);
+    void erase(size_t index);
+    void do_clear();
+    uint64_t do_serialized_size() const;
+
+    template <typename Source>
+    bool read(Source& source);
+
+    template <typename Sink>
+    void do_to_data(Sink& sink) const;
+
+    // These are protected by mutex.
+    half_hash salt_;
+    std::vector<entry> entries_;
+    std::vector<uint32_t> slots_;
+    std::unordered_map<endpoint, uint32_t> index_;
+    mutable std::mt19937_64 random_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
@@ -25,6 +25,8 @@
 #include <string>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -43,9 +45,11 @@ public:
     bool from_data(uint32_t version, const data_chunk& data);
     bool from_data(uint32_t version, std::istream& stream);
     bool from_data(uint32_t version, reader& source);
+    bool from_data(uint32_t version, data_reader& source);
     data_chunk to_data(uint32_t version) const;
     void to_data(uint32_t version, std::ostream& stream) const;
     void to_data(uint32_t version, writer& sink) const;
+    void to_data(uint32_t version, data_writer& sink) const;
     bool is_valid() const;
     void reset();
     uint64_t serialized_size(uint32_t version) const;
@@ -56,6 +60,13 @@ public:
 
     data_chunk payload;
     data_chunk signature;
+
+private:
+    template <typename Source>
+    bool read(uint32_t version, Source& source);
+
+    template <typename Sink>
+    void write(uint32_t version, Sink& sink) const;
 };
 
 BC_API bool operator==(const alert& left, const alert& right);
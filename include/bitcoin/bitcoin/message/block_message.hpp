@@ -29,6 +29,8 @@
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 
 namespace libbitcoin {
@@ -41,6 +43,8 @@ public:
     typedef std::vector<block_message> list;
     typedef std::shared_ptr<block_message> ptr;
     typedef std::vector<ptr> ptr_list;
+    typedef std::shared_ptr<const block_message> const_ptr;
+    typedef std::vector<const_ptr> const_ptr_list;
     typedef std::vector<size_t> indexes;
 
     static block_message factory_from_data(uint32_t version,
@@ -54,12 +58,12 @@ public:
     block_message(const chain::block& other);
     block_message(const block_message& other);
     block_message(const chain::header& header,
-        const chain::transaction::list& transactions);
+        const chain::transaction::const_ptr_list& transactions);
 
     block_message(chain::block&& other);
     block_message(block_message&& other);
     block_message(chain::header&& header,
-        chain::transaction::list&& transactions);
+        chain::transaction::const_ptr_list&& transactions);
 
     /// This class is move assignable but not copy assignable.
     block_message& operator=(block_message&& other);
@@ -71,15 +75,20 @@ public:
         bool with_transaction_count = true);
     bool from_data(uint32_t version, reader& source,
         bool with_transaction_count = true);
+    bool from_data(uint32_t version, data_reader& source,
+        bool with_transaction_count = true);
     data_chunk to_data(uint32_t version,
         bool with_transaction_count = true) const;
     void to_data(uint32_t version, std::ostream& stream,
         bool with_transaction_count = true) const;
     void to_data(uint32_t version, writer& sink,
         bool with_transaction_count = true) const;
+    void to_data(uint32_t version, data_writer& sink,
+        bool with_transaction_count = true) const;
     uint64_t serialized_size(uint32_t version,
         bool with_transaction_count = true) const;
 
+    void clear();
     uint64_t originator() const;
     void set_originator(uint64_t value);
 
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_BLOCK_RECONSTRUCTOR_HPP
+#define LIBBITCOIN_MESSAGE_BLOCK_RECONSTRUCTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/block_transactions.hpp>
+#include <bitcoin/bitcoin/message/compact_block.hpp>
+#include <bitcoin/bitcoin/message/get_block_transactions.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// BIP152 reconstruction of a block from a compact block. The short ids of
+/// the compact block are indexed by value, so matching a pool of candidate
+/// transactions is one siphash and one lookup per candidate. Transactions
+/// that are not matched are requested by get_block_transactions and placed
+/// from the block_transactions response.
+/// This class is not thread safe.
+class BC_API block_reconstructor
+{
+public:
+    block_reconstructor();
+
+    /// Load the compact block, placing prefilled transactions and indexing
+    /// short ids. Returns bad_stream for an invalid prefilled index and
+    /// duplicate for colliding short ids, in which case the full block must
+    /// be requested and the reconstructor is left empty.
+    code load(const compact_block& block);
+
+    /// Place the transaction if it matches a missing short id. A second
+    /// distinct match of a short id unplaces it, so that it is requested.
+    bool fill(chain::transaction::const_ptr tx);
+
+    /// Place matching transactions of the pool, returning the number placed.
+    size_t fill(const chain::transaction::const_ptr_list& pool);
+
+    /// Place the requested transactions, in the order of request().
+    /// Returns bad_stream if the response is not for the missing set.
+    code fill(const block_transactions& response);
+
+    /// True if all transactions are placed.
+    bool complete() const;
+
+    /// The number of transactions not placed.
+    size_t missing() const;
+
+    /// The request for all transactions not placed.
+    get_block_transactions request() const;
+
+    /// Assemble the block once complete. Returns merkle_mismatch if a short
+    /// id collision placed a wrong transaction, in which case the full block
+    /// must be requested.
+    code reconstruct(chain::block& out) const;
+
+private:
+    bool place(size_t slot, chain::transaction::const_ptr tx);
+    code fail(const code& ec);
+
+    chain::header header_;
+    half_hash key_;
+    chain::transaction::const_ptr_list slots_;
+    std::vector<bool> ambiguous_;
+    std::unordered_map<uint64_t, size_t> index_;
+    size_t missing_;
+};
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
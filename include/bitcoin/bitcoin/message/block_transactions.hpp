@@ -24,6 +24,8 @@
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -45,9 +47,11 @@ public:
     bool from_data(uint32_t version, const data_chunk& data);
     bool from_data(uint32_t version, std::istream& stream);
     bool from_data(uint32_t version, reader& source);
+    bool from_data(uint32_t version, data_reader& source);
     data_chunk to_data(uint32_t version) const;
     void to_data(uint32_t version, std::ostream& stream) const;
     void to_data(uint32_t version, writer& sink) const;
+    void to_data(uint32_t version, data_writer& sink) const;
     bool is_valid() const;
     void reset();
     uint64_t serialized_size(uint32_t version) const;
@@ -57,7 +61,14 @@ public:
     static const uint32_t version_maximum;
 
     hash_digest block_hash;
-    chain::transaction::list transactions;
+    chain::transaction::const_ptr_list transactions;
+
+private:
+    template <typename Source>
+    bool read(uint32_t version, Source& source);
+
+    template <typename Sink>
+    void write(uint32_t version, Sink& sink) const;
 };
 
 } // namspace message
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_BLOOM_FILTER_HPP
+#define LIBBITCOIN_MESSAGE_BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/script/script.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/message/filter_add.hpp>
+#include <bitcoin/bitcoin/message/filter_load.hpp>
+#include <bitcoin/bitcoin/message/merkle_block.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// BIP37 bloom filter of a peer, loaded by filter_load, extended by
+/// filter_add and unloaded by filter_clear. A transaction matches on its
+/// hash, a data push of an output script, a previous output or a data push
+/// of an input script. Outputs that match are inserted as outpoints,
+/// according to the update flags, so that spends of them also match.
+/// An unloaded filter matches every transaction, as relay is unfiltered.
+/// This class is not thread safe.
+class BC_API bloom_filter
+{
+public:
+    enum update : uint8_t
+    {
+        none = 0,
+        all = 1,
+        pay_public_key_only = 2
+    };
+
+    static const size_t max_filter_size;
+    static const size_t max_element_size;
+    static const uint32_t max_hash_functions;
+
+    bloom_filter();
+
+    /// Load the filter, returns size_limits if it exceeds the bip37 limits.
+    code load(const filter_load& message);
+
+    /// Insert the element, returns size_limits if it exceeds the bip37 limit
+    /// and not_found if no filter is loaded.
+    code add(const filter_add& message);
+
+    /// Unload the filter.
+    void clear();
+
+    /// True if a filter is loaded.
+    bool is_loaded() const;
+
+    /// The filter bits.
+    const data_chunk& data() const;
+
+    /// Set the bits of the element.
+    void insert(data_slice element);
+
+    /// True if all bits of the element are set.
+    bool contains(data_slice element) const;
+
+    /// True if the transaction matches, inserting matched outputs.
+    bool match(const chain::transaction& tx);
+
+    /// A merkle block of the transactions that match, in block order, whose
+    /// indexes are also returned (to send the matched transactions).
+    merkle_block match(const chain::block& block,
+        chain::transaction::indexes& matched);
+
+private:
+    typedef byte_array<hash_size + sizeof(uint32_t)> outpoint;
+
+    static outpoint to_outpoint(const hash_digest& hash, uint32_t index);
+    uint32_t bit(uint32_t function, data_slice element) const;
+    bool contains_push(const chain::script& script) const;
+    bool is_update(const chain::script& script) const;
+    void refresh();
+
+    data_chunk data_;
+    uint32_t hash_functions_;
+    uint32_t tweak_;
+    uint8_t flags_;
+    bool loaded_;
+    bool full_;
+    bool empty_;
+};
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
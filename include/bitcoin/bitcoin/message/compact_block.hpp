@@ -20,11 +20,16 @@
 #ifndef LIBBITCOIN_MESSAGE_COMPACT_BLOCK_HPP
 #define LIBBITCOIN_MESSAGE_COMPACT_BLOCK_HPP
 
+#include <cstdint>
 #include <istream>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/message/prefilled_transaction.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -45,12 +50,33 @@ public:
     static compact_block factory_from_data(uint32_t version,
         reader& source);
 
+    /// A compact block of the block with the coinbase prefilled and short
+    /// ids for all other transactions.
+    static compact_block factory_from_block(const chain::block& block,
+        uint64_t nonce);
+
+    /// The siphash key of short ids, from the header and nonce.
+    static half_hash short_id_key(const chain::header& header,
+        uint64_t nonce);
+
+    /// The short id of a transaction hash, the low 48 bits of its siphash.
+    static uint64_t short_id_value(const half_hash& key,
+        const hash_digest& hash);
+
+    /// The wire encoding of a short id value.
+    static short_id to_short_id(uint64_t value);
+
+    /// The short id value of a wire encoding.
+    static uint64_t from_short_id(const short_id& id);
+
     bool from_data(uint32_t version, const data_chunk& data);
     bool from_data(uint32_t version, std::istream& stream);
     bool from_data(uint32_t version, reader& source);
+    bool from_data(uint32_t version, data_reader& source);
     data_chunk to_data(uint32_t version) const;
     void to_data(uint32_t version, std::ostream& stream) const;
     void to_data(uint32_t version, writer& sink) const;
+    void to_data(uint32_t version, data_writer& sink) const;
     bool is_valid() const;
     void reset();
     uint64_t serialized_size(uint32_t version) const;
@@ -63,6 +89,13 @@ public:
     uint64_t nonce;
     short_id_list short_ids;
     prefilled_transaction::list transactions;
+
+private:
+    template <typename Source>
+    bool read(uint32_t version, Source& source);
+
+    template <typename Sink>
+    void write(uint32_t version, Sink& sink) const;
 };
 
 } // namspace message
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_FRAME_HPP
+#define LIBBITCOIN_MESSAGE_FRAME_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
+#include <bitcoin/bitcoin/message/transaction_message.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Decoder of a wire protocol message (heading and payload) in place over a
+/// contiguous receive buffer, which must outlive the use of the frame.
+/// The heading is validated and the command resolved by the registry without
+/// allocation, and the payload is exposed as a slice of the buffer for
+/// parsing. The payload double sha256 is computed once over the buffer to
+/// verify the checksum and is retained, as it is also the hash of a
+/// transaction payload.
+/// This class is not thread safe.
+class BC_API frame
+{
+public:
+    frame(uint32_t magic);
+
+    /// Decode the frame at the front of the buffer, which may be partial.
+    /// Returns success with complete() false if more bytes are required, in
+    /// which case size() is the buffer size required to progress. Returns
+    /// bad_stream for a magic, command or checksum mismatch and size_limits
+    /// for a payload size above the registered maximum for the command.
+    code decode(uint32_t version, data_slice buffer);
+
+    /// Clear the decoded state, for the next frame.
+    void reset();
+
+    /// True if a valid heading and payload have been decoded.
+    bool complete() const;
+
+    /// The size of the frame once the heading is decoded, otherwise the
+    /// size of a heading.
+    size_t size() const;
+
+    /// The message type of the command, unknown until the heading decodes.
+    message_type type() const;
+
+    /// The command, for logging (this allocates).
+    std::string command() const;
+
+    /// The payload within the buffer, empty until complete.
+    data_slice payload() const;
+
+    /// The double sha256 of the payload, null until complete.
+    const hash_digest& payload_hash() const;
+
+    /// Parse the payload of a complete frame of the message's command.
+    template <typename Message>
+    bool parse(uint32_t version, Message& instance) const;
+
+    /// Parse a transaction payload, caching the verified payload hash as the
+    /// transaction hash so that it is not recomputed by serialization.
+    bool parse(uint32_t version, transaction_message& instance) const;
+
+private:
+    bool decode_heading(uint32_t version, data_slice buffer, code& ec);
+    bool is_command(const std::string& command) const;
+
+    const uint32_t magic_;
+    message_type type_;
+    bool heading_;
+    bool complete_;
+    byte_array<command_size> command_;
+    uint32_t payload_size_;
+    uint32_t checksum_;
+    const uint8_t* payload_;
+    hash_digest payload_hash_;
+};
+
+template <typename Message>
+bool frame::parse(uint32_t version, Message& instance) const
+{
+    if (!complete_ || !is_command(Message::command))
+        return false;
+
+    data_reader source(payload());
+    return instance.from_data(version, source);
+}
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
@@ -27,6 +27,8 @@
 #include <bitcoin/bitcoin/chain/header.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 
 namespace libbitcoin {
@@ -70,12 +72,16 @@ public:
         bool with_transaction_count = true);
     bool from_data(const uint32_t version, reader& source,
         bool with_transaction_count = true);
+    bool from_data(const uint32_t version, data_reader& source,
+        bool with_transaction_count = true);
     data_chunk to_data(const uint32_t version,
         bool with_transaction_count = true) const;
     void to_data(const uint32_t version, std::ostream& stream,
         bool with_transaction_count = true) const;
     void to_data(const uint32_t version, writer& sink,
         bool with_transaction_count = true) const;
+    void to_data(const uint32_t version, data_writer& sink,
+        bool with_transaction_count = true) const;
     uint64_t serialized_size(const uint32_t version,
         bool with_transaction_count = true) const;
 
@@ -29,6 +29,8 @@
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/checksum.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -80,9 +82,11 @@ public:
     bool from_data(const data_chunk& data);
     bool from_data(std::istream& stream);
     bool from_data(reader& source);
+    bool from_data(data_reader& source);
     data_chunk to_data() const;
     void to_data(std::ostream& stream) const;
     void to_data(writer& sink) const;
+    void to_data(data_writer& sink) const;
     bool is_valid() const;
     void reset();
     message_type type() const;
@@ -91,6 +95,13 @@ public:
     std::string command;
     uint32_t payload_size;
     uint32_t checksum;
+
+private:
+    template <typename Source>
+    bool read(Source& source);
+
+    template <typename Sink>
+    void write(Sink& sink) const;
 };
 
 BC_API bool operator==(const heading& left, const heading& right);
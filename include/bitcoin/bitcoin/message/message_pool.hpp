@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_MESSAGE_POOL_HPP
+#define LIBBITCOIN_MESSAGE_MESSAGE_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <boost/thread.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Per thread pool of message instances for reuse in parsing, so that a
+/// steady stream of messages does not allocate for each. An instance is
+/// reused once the pool holds its only reference, and is cleared (which
+/// retains the capacity of its lists) before it is returned. Callers must
+/// not retain weak references to acquired instances.
+/// Thread specific storage is used because threads are boost threads.
+/// This class is thread safe.
+template <typename Message, size_t Capacity=16>
+class message_pool
+{
+public:
+    typedef std::shared_ptr<Message> ptr;
+
+    /// A cleared instance, reused from the pool of the calling thread if one
+    /// is free, otherwise newly allocated (and pooled if there is room).
+    static ptr acquire();
+
+    /// The number of instances pooled by the calling thread.
+    static size_t size();
+
+private:
+    typedef std::vector<ptr> list;
+
+    static list& instances();
+
+    static boost::thread_specific_ptr<list> pool_;
+};
+
+template <typename Message, size_t Capacity>
+boost::thread_specific_ptr<typename message_pool<Message, Capacity>::list>
+    message_pool<Message, Capacity>::pool_;
+
+template <typename Message, size_t Capacity>
+typename message_pool<Message, Capacity>::list&
+    message_pool<Message, Capacity>::instances()
+{
+    if (pool_.get() == nullptr)
+    {
+        pool_.reset(new list);
+        pool_->reserve(Capacity);
+    }
+
+    return *pool_;
+}
+
+template <typename Message, size_t Capacity>
+typename message_pool<Message, Capacity>::ptr
+    message_pool<Message, Capacity>::acquire()
+{
+    auto& pool = instances();
+
+    for (const auto& instance: pool)
+    {
+        if (instance.use_count() == 1)
+        {
+            // Order the release of the last other reference before reuse.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            instance->clear();
+            return instance;
+        }
+    }
+
+    const auto instance = std::make_shared<Message>();
+
+    if (pool.size() < Capacity)
+        pool.push_back(instance);
+
+    return instance;
+}
+
+template <typename Message, size_t Capacity>
+size_t message_pool<Message, Capacity>::size()
+{
+    return pool_.get() == nullptr ? 0 : pool_->size();
+}
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
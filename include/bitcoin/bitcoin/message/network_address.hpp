@@ -25,6 +25,8 @@
 #include <vector>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
 
@@ -59,12 +61,16 @@ public:
         bool with_timestamp /*= true*/);
     bool from_data(uint32_t version, reader& source,
         bool with_timestamp /*= true*/);
+    bool from_data(uint32_t version, data_reader& source,
+        bool with_timestamp /*= true*/);
     data_chunk to_data(uint32_t version,
         bool with_timestamp /*= true*/) const;
     void to_data(uint32_t version, std::ostream& stream,
         bool with_timestamp /*= true*/) const;
     void to_data(uint32_t version, writer& sink,
         bool with_timestamp /*= true*/) const;
+    void to_data(uint32_t version, data_writer& sink,
+        bool with_timestamp /*= true*/) const;
     bool is_valid() const;
     void reset();
     uint64_t serialized_size(uint32_t version,
@@ -75,6 +81,13 @@ public:
     uint64_t services;
     ip_address ip;
     uint16_t port;
+
+private:
+    template <typename Source>
+    bool read(uint32_t version, Source& source, bool with_timestamp);
+
+    template <typename Sink>
+    void write(uint32_t version, Sink& sink, bool with_timestamp) const;
 };
 
 } // namspace message
@@ -53,10 +53,15 @@ public:
     bool from_data(uint32_t version, const data_chunk& data) override;
     bool from_data(uint32_t version, std::istream& stream) override;
     bool from_data(uint32_t version, reader& source) override;
+    bool from_data(uint32_t version, data_reader& source) override;
 
     static const std::string command;
     static const uint32_t version_minimum;
     static const uint32_t version_maximum;
+
+private:
+    template <typename Source>
+    bool read(uint32_t version, Source& source);
 };
 
 } // namspace message
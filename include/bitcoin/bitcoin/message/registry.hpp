@@ -0,0 +1,410 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_REGISTRY_HPP
+#define LIBBITCOIN_MESSAGE_REGISTRY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/message/frame.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
+#include <bitcoin/bitcoin/message/message_pool.hpp>
+#include <bitcoin/bitcoin/messages.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// A message class, its message type and the maximum size of its payload.
+/// Instances of a pooled message class are drawn from a per thread pool of
+/// reusable instances, for high volume messages with large lists.
+template <typename Message, message_type Type, size_t MaximumPayload,
+    bool Pooled=false>
+struct registration
+{
+    typedef Message message;
+    static constexpr message_type type = Type;
+    static constexpr size_t maximum_payload = MaximumPayload;
+    static constexpr bool pooled = Pooled;
+};
+
+/// Compile time registry of message classes, in message_type order.
+/// A command resolves by perfect hash of its zero padded bytes, with the
+/// hash seed found once on first use, so lookup is one hash and one compare.
+/// Dispatch is through a table of typed invokers indexed by message type.
+template <typename... Registrations>
+class basic_registry
+{
+public:
+    static constexpr size_t size = sizeof...(Registrations);
+
+    /// The type of the zero padded command, unknown if not registered.
+    static message_type type(const byte_array<command_size>& command);
+
+    /// The type of the command, unknown if not registered.
+    static message_type type(const std::string& command);
+
+    /// The command of a registered type.
+    static const std::string& command(message_type type);
+
+    /// The maximum payload size of the type (heading maximum if unknown).
+    static size_t maximum_payload_size(message_type type, uint32_t version);
+
+    /// True if the type is registered and the version is at least its
+    /// minimum. Message maxima are the latest level implemented, which a
+    /// peer may exceed, so they do not bound support.
+    static bool is_supported(message_type type, uint32_t version);
+
+    /// Parse the payload of a complete frame into a new instance of its
+    /// message class and invoke handler(std::shared_ptr<const Message>).
+    /// Returns not_found for an unregistered command, operation_failed for
+    /// a version below the message's minimum and bad_stream for a payload
+    /// that does not parse.
+    template <typename Handler>
+    static code dispatch(uint32_t version, const frame& frame,
+        Handler& handler);
+
+private:
+    template <size_t Index, typename... Entries>
+    struct is_ordered
+      : std::true_type
+    {
+    };
+
+    template <size_t Index, typename Head, typename... Tail>
+    struct is_ordered<Index, Head, Tail...>
+      : std::integral_constant<bool,
+            static_cast<size_t>(Head::type) == Index &&
+            is_ordered<Index + 1, Tail...>::value>
+    {
+    };
+
+    static_assert(is_ordered<1, Registrations...>::value,
+        "registrations must be in message_type order");
+    static_assert(size < max_uint8, "too many registrations");
+
+    template <size_t Value, size_t Power=1>
+    struct power_of_two
+      : std::conditional<(Power >= Value),
+            std::integral_constant<size_t, Power>,
+            power_of_two<Value, (Power << 1)>>::type
+    {
+    };
+
+    // Four slots per registration gives a sparse table to seed quickly.
+    static constexpr size_t slots = power_of_two<4 * size>::value;
+
+    struct table
+    {
+        table();
+        bool is_perfect(uint32_t candidate);
+
+        uint32_t seed;
+        std::array<uint8_t, slots> indexes;
+        std::array<byte_array<command_size>, size> commands;
+        std::array<const std::string*, size> names;
+        std::array<size_t, size> maximums;
+        std::array<uint32_t, size> version_minimums;
+    };
+
+    static const table& instance();
+    static size_t slot(const byte_array<command_size>& command,
+        uint32_t seed);
+    static bool is_registered(message_type type);
+
+    template <typename Message>
+    static std::shared_ptr<Message> create(std::true_type pooled);
+
+    template <typename Message>
+    static std::shared_ptr<Message> create(std::false_type pooled);
+
+    template <typename Registration, typename Handler>
+    static code invoke(uint32_t version, const frame& frame,
+        Handler& handler);
+};
+
+template <typename... Registrations>
+basic_registry<Registrations...>::table::table()
+  : seed(0),
+    names{ { &Registrations::message::command... } },
+    maximums{ { Registrations::maximum_payload... } },
+    version_minimums{ { Registrations::message::version_minimum... } }
+{
+    for (size_t index = 0; index < size; ++index)
+    {
+        const auto& name = *names[index];
+        BITCOIN_ASSERT(name.size() <= command_size);
+        commands[index].fill(0x00);
+        std::copy(name.begin(), name.end(), commands[index].begin());
+    }
+
+    // Find a seed for which no two commands share a slot.
+    while (!is_perfect(seed))
+        ++seed;
+}
+
+template <typename... Registrations>
+bool basic_registry<Registrations...>::table::is_perfect(
+    uint32_t candidate)
+{
+    indexes.fill(0);
+
+    for (size_t index = 0; index < size; ++index)
+    {
+        auto& entry = indexes[slot(commands[index], candidate)];
+
+        if (entry != 0)
+            return false;
+
+        entry = static_cast<uint8_t>(index + 1);
+    }
+
+    return true;
+}
+
+template <typename... Registrations>
+const typename basic_registry<Registrations...>::table&
+    basic_registry<Registrations...>::instance()
+{
+    // Initialized on first use, as the commands are defined in other units.
+    static const table registered;
+    return registered;
+}
+
+template <typename... Registrations>
+size_t basic_registry<Registrations...>::slot(
+    const byte_array<command_size>& command, uint32_t seed)
+{
+    static_assert(command_size == 3 * sizeof(uint32_t), "command size");
+    const auto word = [&command](size_t offset)
+    {
+        return from_little_endian_unsafe<uint32_t>(command.begin() + offset);
+    };
+
+    // The seed is mixed through each word, so no pair of commands can
+    // collide independently of the seed.
+    auto hash = seed;
+    hash = (hash ^ word(0)) * 0x9e3779b1;
+    hash ^= hash >> 15;
+    hash = (hash ^ word(4)) * 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash = (hash ^ word(8)) * 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash & (slots - 1);
+}
+
+template <typename... Registrations>
+message_type basic_registry<Registrations...>::type(
+    const byte_array<command_size>& command)
+{
+    const auto& registered = instance();
+    const auto index = registered.indexes[slot(command, registered.seed)];
+
+    if (index == 0 || registered.commands[index - 1] != command)
+        return message_type::unknown;
+
+    return static_cast<message_type>(index);
+}
+
+template <typename... Registrations>
+message_type basic_registry<Registrations...>::type(
+    const std::string& command)
+{
+    if (command.size() > command_size)
+        return message_type::unknown;
+
+    byte_array<command_size> padded;
+    padded.fill(0x00);
+    std::copy(command.begin(), command.end(), padded.begin());
+    return type(padded);
+}
+
+template <typename... Registrations>
+bool basic_registry<Registrations...>::is_registered(message_type type)
+{
+    const auto value = static_cast<size_t>(type);
+    return value != 0 && value <= size;
+}
+
+template <typename... Registrations>
+const std::string& basic_registry<Registrations...>::command(
+    message_type type)
+{
+    BITCOIN_ASSERT(is_registered(type));
+    return *instance().names[static_cast<size_t>(type) - 1];
+}
+
+template <typename... Registrations>
+size_t basic_registry<Registrations...>::maximum_payload_size(
+    message_type type, uint32_t version)
+{
+    if (!is_registered(type))
+        return heading::maximum_payload_size(version);
+
+    return instance().maximums[static_cast<size_t>(type) - 1];
+}
+
+template <typename... Registrations>
+bool basic_registry<Registrations...>::is_supported(message_type type,
+    uint32_t version)
+{
+    if (!is_registered(type))
+        return false;
+
+    const auto index = static_cast<size_t>(type) - 1;
+    return version >= instance().version_minimums[index];
+}
+
+template <typename... Registrations>
+template <typename Handler>
+code basic_registry<Registrations...>::dispatch(uint32_t version,
+    const frame& frame, Handler& handler)
+{
+    typedef code (*invoker)(uint32_t, const message::frame&, Handler&);
+    static const invoker invokers[] =
+    {
+        &invoke<Registrations, Handler>...
+    };
+
+    const auto type = frame.type();
+
+    if (!is_registered(type))
+        return error::not_found;
+
+    if (!is_supported(type, version))
+        return error::operation_failed;
+
+    return invokers[static_cast<size_t>(type) - 1](version, frame, handler);
+}
+
+template <typename... Registrations>
+template <typename Message>
+std::shared_ptr<Message> basic_registry<Registrations...>::create(
+    std::true_type)
+{
+    return message_pool<Message>::acquire();
+}
+
+template <typename... Registrations>
+template <typename Message>
+std::shared_ptr<Message> basic_registry<Registrations...>::create(
+    std::false_type)
+{
+    return std::make_shared<Message>();
+}
+
+template <typename... Registrations>
+template <typename Registration, typename Handler>
+code basic_registry<Registrations...>::invoke(uint32_t version,
+    const frame& frame, Handler& handler)
+{
+    typedef typename Registration::message Message;
+    const auto instance = create<Message>(
+        std::integral_constant<bool, Registration::pooled>());
+
+    if (!frame.parse(version, *instance))
+        return error::bad_stream;
+
+    handler(std::shared_ptr<const Message>(instance));
+    return error::success;
+}
+
+// A maximal inventory of 50,000 entries, also the heading maximum.
+static constexpr size_t max_inventory_payload = 3u +
+    (sizeof(uint32_t) + hash_size) * 50000u;
+
+// A locator of up to 500 hashes and a stop hash.
+static constexpr size_t max_locator_payload = sizeof(uint32_t) + 3u +
+    hash_size * 501u;
+
+/// The message registry. To add a message class, add its message_type and
+/// register it here, in message_type order. A pooled message class must
+/// implement clear().
+typedef basic_registry<
+    registration<address, message_type::address,
+        3u + 1000u * (sizeof(uint32_t) + 26u)>,
+    registration<alert, message_type::alert,
+        max_inventory_payload>,
+    registration<block_message, message_type::block_message,
+        max_block_size, true>,
+    registration<block_transactions, message_type::block_transactions,
+        max_block_size>,
+    registration<compact_block, message_type::compact_block,
+        max_block_size>,
+    registration<fee_filter, message_type::fee_filter,
+        sizeof(uint64_t)>,
+    registration<filter_add, message_type::filter_add,
+        3u + 520u>,
+    registration<filter_clear, message_type::filter_clear,
+        0u>,
+    registration<filter_load, message_type::filter_load,
+        3u + 36000u + sizeof(uint32_t) + sizeof(uint32_t) + 1u>,
+    registration<get_address, message_type::get_address,
+        0u>,
+    registration<get_block_transactions,
+        message_type::get_block_transactions,
+        max_inventory_payload>,
+    registration<get_blocks, message_type::get_blocks,
+        max_locator_payload>,
+    registration<get_data, message_type::get_data,
+        max_inventory_payload>,
+    registration<get_headers, message_type::get_headers,
+        max_locator_payload>,
+    registration<headers, message_type::headers,
+        3u + 2000u * 81u, true>,
+    registration<inventory, message_type::inventory,
+        max_inventory_payload, true>,
+    registration<memory_pool, message_type::memory_pool,
+        0u>,
+    registration<merkle_block, message_type::merkle_block,
+        max_block_size>,
+    registration<not_found, message_type::not_found,
+        max_inventory_payload>,
+    registration<ping, message_type::ping,
+        sizeof(uint64_t)>,
+    registration<pong, message_type::pong,
+        sizeof(uint64_t)>,
+    registration<reject, message_type::reject,
+        max_inventory_payload>,
+    registration<send_compact_blocks, message_type::send_compact_blocks,
+        1u + sizeof(uint64_t)>,
+    registration<send_headers, message_type::send_headers,
+        0u>,
+    registration<transaction_message, message_type::transaction_message,
+        max_block_size, true>,
+    registration<verack, message_type::verack,
+        0u>,
+    registration<version, message_type::version,
+        sizeof(uint32_t) + 2u * sizeof(uint64_t) + 2u * 26u +
+        sizeof(uint64_t) + 3u + 256u + sizeof(uint32_t) + 1u>
+> registry;
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_RELAY_CACHE_HPP
+#define LIBBITCOIN_MESSAGE_RELAY_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/block_message.hpp>
+#include <bitcoin/bitcoin/message/compact_block.hpp>
+#include <bitcoin/bitcoin/message/headers.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
+#include <bitcoin/bitcoin/message/transaction_message.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Cache of fully framed wire messages (heading and payload) for relay,
+/// keyed by message type, protocol version and inventory hash, so that an
+/// object announced to or served to many peers is serialized and checksummed
+/// once per version. Messages are shared and immutable, and are evicted in
+/// least recently used order to keep the total size of cached messages
+/// within the budget.
+/// This class is thread safe.
+class BC_API relay_cache
+{
+public:
+    typedef std::shared_ptr<const data_chunk> message_ptr;
+
+    relay_cache(uint32_t magic, size_t budget);
+
+    /// This class is not copyable.
+    relay_cache(const relay_cache&) = delete;
+    void operator=(const relay_cache&) = delete;
+
+    /// The framed message, serialized and cached on first request.
+    message_ptr get(uint32_t version, const block_message& block);
+    message_ptr get(uint32_t version, const compact_block& block);
+    message_ptr get(uint32_t version, const transaction_message& tx);
+
+    /// Headers have no inventory hash, so are keyed by headers_key.
+    message_ptr get(uint32_t version, const headers& headers);
+
+    /// The hash of the first and last header hashes, which identifies the
+    /// connected sequence of headers of a headers message, regardless of the
+    /// locator that requested it.
+    static hash_digest headers_key(const headers& headers);
+
+    /// The hash of the header hash and nonce, since the short ids of a
+    /// compact block vary by nonce, so are keyed by compact_block_key.
+    static hash_digest compact_block_key(const compact_block& block);
+
+    /// The cached framed message, or nullptr if not cached.
+    message_ptr find(message_type type, uint32_t version,
+        const hash_digest& hash);
+
+    /// Remove the cached messages of all versions if present.
+    void remove(message_type type, const hash_digest& hash);
+
+    /// Remove all cached messages.
+    void clear();
+
+    /// The total size of the cached messages.
+    size_t size() const;
+
+    /// The number of cached messages.
+    size_t count() const;
+
+private:
+    struct key
+    {
+        bool operator==(const key& other) const;
+
+        message_type type;
+        uint32_t version;
+        hash_digest hash;
+    };
+
+    typedef std::pair<key, message_ptr> entry;
+    typedef std::list<entry> list;
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::unordered_map<key, list::iterator, key_hash> map;
+
+    template <typename Message>
+    message_ptr get(const Message& packet, const key& id);
+
+    message_ptr store(const key& id, message_ptr message);
+    void erase(map::iterator it);
+
+    const uint32_t magic_;
+    const size_t budget_;
+
+    // These are protected by mutex.
+    size_t size_;
+    list entries_;
+    map index_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_ROLLING_BLOOM_FILTER_HPP
+#define LIBBITCOIN_MESSAGE_ROLLING_BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/inventory.hpp>
+#include <bitcoin/bitcoin/message/inventory_vector.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Probabilistic set of the most recent inventory hashes known to a peer,
+/// of fixed memory for the capacity and false positive rate.
+/// Each cell holds a two bit generation, and the capacity is divided over
+/// three generations, so that when the current one fills the cells of the
+/// oldest are cleared. At least the last capacity hashes inserted are
+/// retained, and hashes older than one and a half capacities are forgotten.
+/// The cells of a hash all lie in one 64 byte block, so a lookup touches a
+/// single cache line. Hashes are keyed with a siphash key, random unless
+/// specified, so peers cannot construct colliding inventory.
+/// This class is not thread safe.
+class BC_API rolling_bloom_filter
+{
+public:
+    /// The false positive rate applies when the capacity is retained.
+    rolling_bloom_filter(size_t capacity, double false_positive_rate);
+
+    /// A filter with the siphash key, for reproducible positions.
+    rolling_bloom_filter(size_t capacity, double false_positive_rate,
+        const half_hash& key);
+
+    /// This class is not copyable, as the cells are aligned within the
+    /// storage of the instance.
+    rolling_bloom_filter(const rolling_bloom_filter&) = delete;
+    void operator=(const rolling_bloom_filter&) = delete;
+
+    /// Insert the hash into the current generation.
+    void insert(const hash_digest& hash);
+
+    /// Insert the hashes of each inventory vector.
+    void insert(const inventory& inventory);
+
+    /// True if the hash is probably in the set.
+    bool contains(const hash_digest& hash) const;
+
+    /// Append each inventory vector whose hash is not in the set to out.
+    void filter(inventory_vector::list& out,
+        const inventory& inventory) const;
+
+    /// Clear all generations, retaining the allocation.
+    void clear();
+
+    /// The number of hash functions (cells per hash).
+    size_t hash_functions() const;
+
+    /// The number of bytes of cell storage.
+    size_t size() const;
+
+private:
+    struct cell
+    {
+        size_t block;
+        uint64_t seed;
+    };
+
+    cell locate(const hash_digest& hash) const;
+    void age();
+
+    const size_t generation_size_;
+    const size_t hash_functions_;
+    const size_t blocks_;
+    const half_hash key_;
+    std::vector<uint64_t> data_;
+    size_t offset_;
+    size_t entries_;
+    uint8_t generation_;
+};
+
+} // namspace message
+} // namspace libbitcoin
+
+#endif
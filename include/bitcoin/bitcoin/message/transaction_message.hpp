@@ -28,19 +28,28 @@
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 
 namespace libbitcoin {
 namespace message {
 
+/// A transaction message holds its transaction shared and immutable, so that
+/// a relayed transaction is one allocation with the transaction of the pool
+/// and of blocks. A reused (pooled) message parses into its transaction in
+/// place once the transaction is no longer shared, retaining the capacity
+/// of its lists, and otherwise into a new transaction.
 class BC_API transaction_message
-  : public chain::transaction
 {
 public:
     typedef std::vector<transaction_message> list;
     typedef std::shared_ptr<transaction_message> ptr;
     typedef std::vector<ptr> ptr_list;
+    typedef std::shared_ptr<const transaction_message> const_ptr;
+    typedef std::vector<const_ptr> const_ptr_list;
     typedef std::vector<size_t> indexes;
 
     static transaction_message factory_from_data(uint32_t version,
@@ -51,12 +60,13 @@ public:
         reader& source);
 
     transaction_message();
-    transaction_message(const transaction& other);
+    transaction_message(chain::transaction::const_ptr transaction);
+    transaction_message(const chain::transaction& other);
     transaction_message(const transaction_message& other);
     transaction_message(uint32_t version, uint32_t locktime,
         const chain::input::list& inputs, const chain::output::list& outputs);
 
-    transaction_message(transaction&& other);
+    transaction_message(chain::transaction&& other);
     transaction_message(transaction_message&& other);
     transaction_message(uint32_t version, uint32_t locktime,
         chain::input::list&& inputs, chain::output::list&& outputs);
@@ -65,13 +75,27 @@ public:
     transaction_message& operator=(transaction_message&& other);
     void operator=(const transaction_message&) = delete;
 
+    /// The shared transaction, never null.
+    chain::transaction::const_ptr transaction() const;
+
     bool from_data(uint32_t version, const data_chunk& data);
     bool from_data(uint32_t version, std::istream& stream);
     bool from_data(uint32_t version, reader& source);
+    bool from_data(uint32_t version, data_reader& source);
+
+    /// Parse a complete payload with a known hash (from frame checksum
+    /// verification), which is cached as the transaction hash if the payload
+    /// is the canonical serialization of the transaction.
+    bool from_data(uint32_t version, data_slice payload,
+        const hash_digest& hash);
+
     data_chunk to_data(uint32_t version) const;
     void to_data(uint32_t version, std::ostream& stream) const;
     void to_data(uint32_t version, writer& sink) const;
+    void to_data(uint32_t version, data_writer& sink) const;
     uint64_t serialized_size(uint32_t version) const;
+    bool is_valid() const;
+    void clear();
     uint64_t originator() const;
     void set_originator(uint64_t value);
 
@@ -80,6 +104,19 @@ public:
     static const uint32_t version_maximum;
 
 private:
+    chain::transaction::ptr writable();
+
+    template <typename Source>
+    bool read(uint32_t version, Source& source);
+
+    template <typename Sink>
+    void write(uint32_t version, Sink& sink) const;
+
+    chain::transaction::const_ptr transaction_;
+
+    // True if the transaction was allocated by a message, and so may be
+    // written once it is no longer shared.
+    bool owned_;
     uint64_t originator_;
 };
 
@@ -20,7 +20,9 @@
 #ifndef LIBBITCOIN_MESSAGES_HPP
 #define LIBBITCOIN_MESSAGES_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <bitcoin/bitcoin/math/checksum.hpp>
 #include <bitcoin/bitcoin/message/address.hpp>
 #include <bitcoin/bitcoin/message/alert.hpp>
 #include <bitcoin/bitcoin/message/alert_payload.hpp>
@@ -52,7 +54,9 @@
 #include <bitcoin/bitcoin/message/transaction_message.hpp>
 #include <bitcoin/bitcoin/message/verack.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 
 // Minimum conditional protocol version: 31800
 
@@ -102,13 +106,67 @@
 namespace libbitcoin {
 namespace message {
 
+/**
+* The size of the Bitcoin wire protocol encoding of a message object.
+*/
+template <typename Message>
+size_t serialized_size(uint32_t version, const Message& packet)
+{
+    return heading::serialized_size() +
+        static_cast<size_t>(packet.serialized_size(version));
+}
+
+/**
+* Serialize a message object to the Bitcoin wire protocol encoding, in place
+* in a caller-provided buffer of exactly serialized_size(version, packet).
+* The payload is written behind the heading space, then checksummed in
+* place, so the message is neither copied nor reallocated.
+*/
+template <typename Message>
+bool serialize(uint8_t* buffer, size_t size, uint32_t version,
+    const Message& packet, uint32_t magic)
+{
+    const auto heading_size = heading::serialized_size();
+    const auto payload_size = packet.serialized_size(version);
+
+    if (size < heading_size || size - heading_size != payload_size)
+        return false;
+
+    const auto payload = buffer + heading_size;
+    const auto end = buffer + size;
+    data_writer payload_sink(payload, end);
+    packet.to_data(version, payload_sink);
+
+    if (!payload_sink || payload_sink.size() != payload_size)
+        return false;
+
+    // Construct the payload header.
+    heading head;
+    head.magic = magic;
+    head.command = Message::command;
+    head.payload_size = static_cast<uint32_t>(payload_size);
+    head.checksum = bitcoin_checksum(data_slice(payload, end));
+
+    data_writer heading_sink(buffer, payload);
+    head.to_data(heading_sink);
+    return heading_sink && heading_sink.size() == heading_size;
+}
+
 /**
 * Serialize a message object to the Bitcoin wire protocol encoding.
+* This is a single allocation of the message size unless the message predicts
+* its payload size incorrectly, in which case the payload is serialized and
+* framed separately, so that the heading always describes the payload sent.
 */
 template <typename Message>
 data_chunk serialize(uint32_t version, const Message& packet,
     uint32_t magic)
 {
+    data_chunk message(serialized_size(version, packet));
+
+    if (serialize(message.data(), message.size(), version, packet, magic))
+        return message;
+
     // Serialize the payload (required for header size).
     const auto payload = packet.to_data(version);
 
@@ -120,7 +178,7 @@ data_chunk serialize(uint32_t version, const Message& packet,
     head.checksum = bitcoin_checksum(payload);
 
     // Serialize header and copy the payload into a single message buffer.
-    auto message = head.to_data();
+    message = head.to_data();
     extend_data(message, payload);
     return message;
 }
@@ -20,6 +20,8 @@
 #ifndef LIBBITCOIN_COLLECTION_HPP
 #define LIBBITCOIN_COLLECTION_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <iostream>
 #include <vector>
@@ -83,6 +85,21 @@ typename std::vector<Type>::iterator insert_sorted(std::vector<Type>& list,
 template <typename Type>
 void move_append(std::vector<Type>& target, std::vector<Type>& source);
 
+/**
+ * Reserve for a count of elements read from untrusted input, no more than
+ * could be deserialized from the bytes available. The list then grows
+ * geometrically as elements actually parse, so allocation is bounded by the
+ * input present rather than by the count.
+ * @param      <Type>          The type of list member elements.
+ * @param[in]  list            The list to reserve.
+ * @param[in]  count           The element count read from the input.
+ * @param[in]  available       The number of bytes that may yet be read.
+ * @param[in]  minimum_size    The minimum serialized size of an element.
+ */
+template <typename Type>
+void bounded_reserve(std::vector<Type>& list, uint64_t count,
+    size_t available, size_t minimum_size);
+
 /////**
 //// * Reverse a list, returning the new list.
 //// * @param      <Collection> The type of list.
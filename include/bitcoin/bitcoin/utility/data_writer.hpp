@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATA_WRITER_HPP
+#define LIBBITCOIN_DATA_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+
+/**
+ * Bounds checked writer over preallocated contiguous memory, which must
+ * outlive it. The buffer is never resized, writes copy directly into it.
+ * Writing beyond the end invalidates the writer and all subsequent writes.
+ * The class is final and inline, so writes through a data_writer (rather
+ * than a writer) are resolved at compile time. Chain and message types
+ * overload to_data on data_writer and template their serializers on the sink
+ * type, so that this holds through nested serialization.
+ */
+class BC_API data_writer final
+  : public writer
+{
+public:
+    data_writer(uint8_t* begin, uint8_t* end);
+    data_writer(data_chunk& data);
+
+    operator bool() const;
+    bool operator!() const;
+
+    void write_byte(uint8_t value);
+    void write_data(const data_chunk& data);
+    void write_data(const uint8_t* data, size_t size);
+    void write_hash(const hash_digest& value);
+    void write_short_hash(const short_hash& value);
+    void write_mini_hash(const mini_hash& value);
+
+    // These write data in little endian format:
+    void write_2_bytes_little_endian(uint16_t value);
+    void write_4_bytes_little_endian(uint32_t value);
+    void write_8_bytes_little_endian(uint64_t value);
+    void write_variable_uint_little_endian(uint64_t value);
+
+    // These write data in big endian format:
+    void write_2_bytes_big_endian(uint16_t value);
+    void write_4_bytes_big_endian(uint32_t value);
+    void write_8_bytes_big_endian(uint64_t value);
+    void write_variable_uint_big_endian(uint64_t value);
+
+    /**
+     * Write a fixed size string padded with zeroes.
+     */
+    void write_fixed_string(const std::string& value, size_t size);
+
+    /**
+     * Write a variable length string.
+     */
+    void write_string(const std::string& value);
+
+    /**
+     * Writes an unsigned integer in big endian format.
+     */
+    template <typename T>
+    void write_big_endian(T value);
+
+    /**
+     * Writes an unsigned integer in little endian format.
+     */
+    template <typename T>
+    void write_little_endian(T value);
+
+    /**
+     * The number of bytes written.
+     */
+    size_t size() const;
+
+private:
+    // Invalidates the writer if fewer than size bytes remain.
+    bool reserve(size_t size);
+
+    uint8_t* const begin_;
+    uint8_t* position_;
+    uint8_t* const end_;
+    bool valid_;
+};
+
+/**
+ * Serialize into a new buffer of the expected size through a data_writer.
+ * The expected size is a prediction, so if fewer bytes are written the result
+ * is trimmed, and if the buffer is exhausted the serialization is repeated in
+ * a buffer of twice the size. A wrong prediction costs a reallocation but
+ * never truncates or pads the result.
+ */
+template <typename Serializer>
+data_chunk write_chunk(size_t expected_size, Serializer serialize);
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/data_writer.ipp>
+
+#endif
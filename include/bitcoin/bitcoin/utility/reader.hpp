@@ -20,6 +20,7 @@
 #ifndef LIBBITCOIN_READER_HPP
 #define LIBBITCOIN_READER_HPP
 
+#include <cstddef>
 #include <string>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
@@ -33,6 +34,13 @@ public:
     virtual bool operator!() const = 0;
 
     virtual bool is_exhausted() const = 0;
+
+    /**
+     * The number of bytes not yet read, or max_size_t if not known.
+     * This bounds allocation against sizes read from untrusted input.
+     */
+    virtual size_t remaining() const = 0;
+
     virtual uint8_t read_byte() = 0;
     virtual data_chunk read_data(size_t size) = 0;
     virtual size_t read_data(uint8_t* data, size_t size) = 0;
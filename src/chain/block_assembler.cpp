@@ -0,0 +1,330 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_assembler.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/script/opcode.hpp>
+#include <bitcoin/bitcoin/chain/script/operation.hpp>
+#include <bitcoin/bitcoin/chain/script/script.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/chain/transaction_pool.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/math/script_number.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+typedef transaction_pool::package package_totals;
+
+// As in the satoshi client.
+const size_t block_assembler::coinbase_reserved_size = 1000;
+const size_t block_assembler::coinbase_reserved_sigops = 100;
+
+// Selection stops once the block is nearly full and packages repeatedly fail
+// to fit, as the remainder of the pool is unlikely to fit either.
+static constexpr size_t max_consecutive_failures = 1000;
+static constexpr size_t nearly_full_size = 4000;
+
+// The push of a height, as the minimal push of its script number.
+static operation to_height_operation(size_t height)
+{
+    static constexpr auto op_1 = static_cast<uint8_t>(opcode::op_1);
+
+    if (height == 0)
+        return{ opcode::zero, {} };
+
+    if (height <= 16)
+        return{ static_cast<opcode>(op_1 + height - 1), {} };
+
+    return{ opcode::special, script_number(height).data() };
+}
+
+// The score of a transaction given the package of its unselected ancestors.
+static uint64_t to_score(const transaction_pool::entry& entry,
+    const package_totals& ancestors)
+{
+    return std::min(entry.rate(), ancestors.rate());
+}
+
+block_assembler::block_assembler(const transaction_pool& pool,
+    size_t max_size, size_t max_sigops)
+  : pool_(pool),
+    max_size_(max_size),
+    max_sigops_(max_sigops),
+    fees_(0),
+    size_(0),
+    sigops_(0)
+{
+}
+
+void block_assembler::reset()
+{
+    transactions_.clear();
+    selected_.clear();
+    fees_ = 0;
+    size_ = 0;
+    sigops_ = 0;
+}
+
+// The transaction and its unselected ancestors.
+hash_list block_assembler::package(const hash_digest& hash) const
+{
+    hash_list out;
+    hash_set visited;
+    hash_list pending{ hash };
+
+    while (!pending.empty())
+    {
+        const auto member = pending.back();
+        pending.pop_back();
+
+        if (selected_.count(member) != 0 || !visited.insert(member).second)
+            continue;
+
+        out.push_back(member);
+        const auto& parents = pool_.find(member)->parents;
+        pending.insert(pending.end(), parents.begin(), parents.end());
+    }
+
+    return out;
+}
+
+bool block_assembler::fits(const hash_list& package) const
+{
+    size_t size = 0;
+    size_t sigops = 0;
+
+    for (const auto& member: package)
+    {
+        const auto& entry = *pool_.find(member);
+        size += entry.size;
+        sigops += entry.sigops;
+    }
+
+    return size_ + size + coinbase_reserved_size <= max_size_ &&
+        sigops_ + sigops + coinbase_reserved_sigops <= max_sigops_;
+}
+
+void block_assembler::select(hash_list& package)
+{
+    // A transaction has more ancestors than any of its ancestors, so this
+    // places each member after those that it spends.
+    const auto by_ancestors = [this](const hash_digest& left,
+        const hash_digest& right)
+    {
+        return pool_.find(left)->ancestors.count <
+            pool_.find(right)->ancestors.count;
+    };
+
+    std::sort(package.begin(), package.end(), by_ancestors);
+
+    for (const auto& member: package)
+    {
+        const auto& entry = *pool_.find(member);
+        transactions_.push_back(entry.transaction);
+        selected_.insert(member);
+        fees_ += entry.fee;
+        size_ += entry.size;
+        sigops_ += entry.sigops;
+    }
+}
+
+void block_assembler::rebuild()
+{
+    reset();
+
+    // Ancestor packages reduced by selection, and their scores.
+    std::unordered_map<hash_digest, package_totals> modified;
+    transaction_pool::rate_index modified_scores;
+    hash_set failed;
+    size_t failures = 0;
+
+    const auto& scores = pool_.ancestor_scores();
+    auto it = scores.rbegin();
+
+    while (true)
+    {
+        while (it != scores.rend() && (selected_.count(it->second) != 0 ||
+            failed.count(it->second) != 0 ||
+            modified.count(it->second) != 0))
+            ++it;
+
+        const auto use_modified = !modified_scores.empty() &&
+            (it == scores.rend() || *it < *modified_scores.rbegin());
+
+        if (!use_modified && it == scores.rend())
+            break;
+
+        hash_digest hash;
+
+        if (use_modified)
+        {
+            hash = modified_scores.rbegin()->second;
+            modified_scores.erase(std::prev(modified_scores.end()));
+            modified.erase(hash);
+        }
+        else
+        {
+            hash = it->second;
+            ++it;
+        }
+
+        auto members = package(hash);
+
+        if (!fits(members))
+        {
+            failed.insert(hash);
+
+            if (++failures > max_consecutive_failures && size_ +
+                coinbase_reserved_size + nearly_full_size > max_size_)
+                break;
+
+            continue;
+        }
+
+        failures = 0;
+        select(members);
+
+        for (const auto& member: members)
+        {
+            const auto& entry = *pool_.find(member);
+            const auto selected = modified.find(member);
+
+            // A selected ancestor of the package is no longer a candidate.
+            if (selected != modified.end())
+            {
+                modified_scores.erase(std::make_pair(
+                    to_score(entry, selected->second), member));
+                modified.erase(selected);
+            }
+
+            for (const auto& descendant: pool_.descendants(entry))
+            {
+                if (selected_.count(descendant) != 0 ||
+                    failed.count(descendant) != 0)
+                    continue;
+
+                const auto& child = *pool_.find(descendant);
+                auto found = modified.find(descendant);
+
+                if (found == modified.end())
+                    found = modified.emplace(descendant,
+                        child.ancestors).first;
+                else
+                    modified_scores.erase(std::make_pair(
+                        to_score(child, found->second), descendant));
+
+                found->second.fee -= entry.fee;
+                found->second.size -= entry.size;
+                --found->second.count;
+                modified_scores.emplace(to_score(child, found->second),
+                    descendant);
+            }
+        }
+    }
+}
+
+size_t block_assembler::update(const hash_list& arrivals)
+{
+    size_t appended = 0;
+
+    for (const auto& hash: arrivals)
+    {
+        if (selected_.count(hash) != 0 || !pool_.exists(hash))
+            continue;
+
+        auto members = package(hash);
+
+        if (!fits(members))
+            continue;
+
+        appended += members.size();
+        select(members);
+    }
+
+    return appended;
+}
+
+block block_assembler::assemble(const header& header, size_t height,
+    const script& output_script) const
+{
+    transaction coinbase;
+    coinbase.version = 1;
+    coinbase.locktime = 0;
+    coinbase.inputs.emplace_back();
+    auto& input = coinbase.inputs.back();
+    input.previous_output = point{ null_hash, max_uint32 };
+    input.sequence = max_input_sequence;
+
+    // The height followed by a placeholder for an extra nonce. The height is
+    // pushed as the satoshi client does (bip34), so small heights are pushed
+    // by their opcode.
+    input.script.operations.push_back(to_height_operation(height));
+
+    input.script.operations.push_back({ opcode::zero, {} });
+    coinbase.outputs.emplace_back();
+    coinbase.outputs.back().value = block_subsidy(height) + fees_;
+    coinbase.outputs.back().script = output_script;
+
+    // The selected transactions are shared with the pool, so their hashes
+    // are cached for the merkle root.
+    block out;
+    out.header = header;
+    out.transactions.reserve(transactions_.size() + 1);
+    out.transactions.push_back(
+        std::make_shared<const transaction>(std::move(coinbase)));
+    out.transactions.insert(out.transactions.end(), transactions_.begin(),
+        transactions_.end());
+    out.header.transaction_count = out.transactions.size();
+    out.header.merkle = block::generate_merkle_root(out.transactions);
+    return out;
+}
+
+const transaction::const_ptr_list& block_assembler::transactions() const
+{
+    return transactions_;
+}
+
+uint64_t block_assembler::fees() const
+{
+    return fees_;
+}
+
+size_t block_assembler::size() const
+{
+    return size_;
+}
+
+size_t block_assembler::sigops() const
+{
+    return sigops_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
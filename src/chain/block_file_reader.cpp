@@ -0,0 +1,328 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_file_reader.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+#define NAME "block_file_reader"
+
+typedef std::pair<hash_digest, size_t> hash_position;
+
+static constexpr size_t frame_size = 2 * sizeof(uint32_t);
+static constexpr size_t header_size = 80;
+static constexpr size_t previous_offset = sizeof(uint32_t);
+static constexpr size_t hash_batch_size = 1024;
+static constexpr size_t unlinked = max_size_t;
+
+const size_t block_file_reader::default_window = 256;
+
+block_file_reader::block_file_reader(threadpool& pool, uint32_t magic)
+  : magic_(magic), dispatch_(pool, NAME)
+{
+}
+
+bool block_file_reader::open(const std::vector<path>& files)
+{
+    files_.clear();
+    entries_.clear();
+    chain_.clear();
+    files_.reserve(files.size());
+
+    for (const auto& file: files)
+    {
+        try
+        {
+            // An empty file cannot be mapped, so it remains closed.
+            if (boost::filesystem::file_size(file) == 0)
+                files_.emplace_back();
+            else
+                files_.emplace_back(file.string());
+        }
+        catch (const std::exception&)
+        {
+            // Both mapping and sizing throw on failure.
+            files_.clear();
+            entries_.clear();
+            return false;
+        }
+
+        scan(files_.size() - 1);
+    }
+
+    return true;
+}
+
+// Unframed bytes (such as bitcoind's zero preallocation) are skipped.
+void block_file_reader::scan(size_t file)
+{
+    const auto& map = files_[file];
+    const auto data = reinterpret_cast<const uint8_t*>(map.data());
+    const auto size = map.is_open() ? map.size() : 0;
+    size_t offset = 0;
+
+    while (offset + frame_size <= size)
+    {
+        const auto magic = from_little_endian_unsafe<uint32_t>(data + offset);
+
+        if (magic != magic_)
+        {
+            ++offset;
+            continue;
+        }
+
+        const auto payload = from_little_endian_unsafe<uint32_t>(
+            data + offset + sizeof(uint32_t));
+
+        if (payload < header_size || payload > max_block_size ||
+            offset + frame_size + payload > size)
+        {
+            ++offset;
+            continue;
+        }
+
+        entries_.push_back({ file, offset + frame_size, payload, null_hash,
+            null_hash });
+        offset += frame_size + payload;
+    }
+}
+
+size_t block_file_reader::size() const
+{
+    return entries_.size();
+}
+
+void block_file_reader::hash_headers(size_t first, result_handler handler)
+{
+    const auto end = std::min(first + hash_batch_size, entries_.size());
+
+    for (auto index = first; index < end; ++index)
+    {
+        auto& entry = entries_[index];
+        const auto data = reinterpret_cast<const uint8_t*>(
+            files_[entry.file].data()) + entry.offset;
+
+        entry.hash = bitcoin_hash(data_slice(data, data + header_size));
+        std::copy(data + previous_offset, data + previous_offset + hash_size,
+            entry.previous.begin());
+    }
+
+    handler(error::success);
+}
+
+size_t block_file_reader::link()
+{
+    chain_.clear();
+    const auto count = entries_.size();
+
+    if (count == 0)
+        return 0;
+
+    std::vector<size_t> batches;
+
+    for (size_t first = 0; first < count; first += hash_batch_size)
+        batches.push_back(first);
+
+    const auto hashed = std::make_shared<std::promise<void>>();
+    const auto complete = [hashed](const code&) { hashed->set_value(); };
+    const auto done = hashed->get_future();
+    dispatch_.parallel(batches, NAME, complete,
+        &block_file_reader::hash_headers, this);
+    done.wait();
+
+    // Sorted array of hashes for parent lookup.
+    std::vector<hash_position> hashes;
+    hashes.reserve(count);
+
+    for (size_t index = 0; index < count; ++index)
+        hashes.emplace_back(entries_[index].hash, index);
+
+    std::sort(hashes.begin(), hashes.end());
+
+    std::vector<size_t> parents(count, unlinked);
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto& previous = entries_[index].previous;
+        const auto it = std::lower_bound(hashes.begin(), hashes.end(),
+            hash_position(previous, 0));
+
+        if (it != hashes.end() && it->first == previous)
+            parents[index] = it->second;
+    }
+
+    // Heights are resolved iteratively, as parents may follow children.
+    std::vector<size_t> heights(count, unlinked);
+    std::vector<bool> resolved(count, false);
+    std::vector<size_t> pending;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        auto current = index;
+
+        while (!resolved[current] && parents[current] != unlinked &&
+            pending.size() < count)
+        {
+            pending.push_back(current);
+            current = parents[current];
+        }
+
+        // Orphans (and hash cycles) remain unlinked.
+        if (!resolved[current])
+        {
+            resolved[current] = true;
+
+            if (parents[current] == unlinked &&
+                entries_[current].previous == null_hash)
+                heights[current] = 0;
+        }
+
+        auto height = heights[current];
+
+        while (!pending.empty())
+        {
+            if (height != unlinked)
+                ++height;
+
+            heights[pending.back()] = height;
+            resolved[pending.back()] = true;
+            pending.pop_back();
+        }
+    }
+
+    size_t top = unlinked;
+
+    for (size_t index = 0; index < count; ++index)
+        if (heights[index] != unlinked &&
+            (top == unlinked || heights[index] > heights[top]))
+            top = index;
+
+    if (top == unlinked)
+        return 0;
+
+    chain_.resize(heights[top] + 1);
+
+    for (auto index = top; index != unlinked; index = parents[index])
+        chain_[heights[index]] = index;
+
+    return chain_.size();
+}
+
+void block_file_reader::parse_block(block_list_ptr blocks, size_t first,
+    size_t position, result_handler handler)
+{
+    const auto& entry = entries_[chain_[first + position]];
+    const auto data = reinterpret_cast<const uint8_t*>(
+        files_[entry.file].data()) + entry.offset;
+
+    // Parse directly from the mapped file, without a buffer copy or stream.
+    data_reader source(data_slice(data, data + entry.size));
+    const auto instance = std::make_shared<block>();
+
+    if (instance->from_data(source))
+        (*blocks)[position] = instance;
+
+    handler(error::success);
+}
+
+std::future<void> block_file_reader::parse_window(block_list_ptr blocks,
+    size_t first)
+{
+    std::vector<size_t> positions(blocks->size());
+
+    for (size_t position = 0; position < positions.size(); ++position)
+        positions[position] = position;
+
+    const auto parsed = std::make_shared<std::promise<void>>();
+    const auto complete = [parsed](const code&) { parsed->set_value(); };
+    auto done = parsed->get_future();
+
+    if (positions.empty())
+        parsed->set_value();
+    else
+        dispatch_.parallel(positions, NAME, complete,
+            &block_file_reader::parse_block, this, blocks, first);
+
+    return done;
+}
+
+bool block_file_reader::read(block_handler handler, size_t window)
+{
+    window = std::max(window, size_t(1));
+    const auto count = chain_.size();
+    const auto make_window = [count, window](size_t first)
+    {
+        return std::make_shared<block_list>(std::min(window, count - first));
+    };
+
+    auto blocks = make_window(0);
+    auto parsed = parse_window(blocks, 0);
+
+    for (size_t first = 0; first < count; first += window)
+    {
+        parsed.wait();
+
+        // Parse the next window while this one is delivered.
+        const auto current = blocks;
+        const auto next = first + window;
+
+        if (next < count)
+        {
+            blocks = make_window(next);
+            parsed = parse_window(blocks, next);
+        }
+
+        for (size_t position = 0; position < current->size(); ++position)
+        {
+            const auto& instance = (*current)[position];
+
+            if (!instance || !handler(instance, first + position))
+            {
+                // The next window references this object, so let it finish.
+                if (next < count)
+                    parsed.wait();
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+#undef NAME
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,408 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/script/opcode.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/variable_uint_size.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+#define NAME "block_filter"
+
+const uint8_t block_filter::golomb_bits = 19;
+const uint64_t block_filter::inverse_rate = 784931;
+
+// Golomb-Rice coded deltas, with bits written most significant first.
+class golomb_writer
+{
+public:
+    golomb_writer(data_chunk& sink)
+      : sink_(sink), used_(0)
+    {
+    }
+
+    void write(uint64_t delta, uint8_t bits)
+    {
+        // The quotient in unary, terminated by a zero bit.
+        for (auto quotient = delta >> bits; quotient > 0; --quotient)
+            write_bits(1, 1);
+
+        write_bits(0, 1);
+        write_bits(delta, bits);
+    }
+
+private:
+    void write_bits(uint64_t value, uint8_t count)
+    {
+        while (count > 0)
+        {
+            if (used_ == 0)
+                sink_.push_back(0x00);
+
+            const uint8_t free = 8 - used_;
+            const auto take = std::min(free, count);
+            const auto chunk = (value >> (count - take)) & ((1u << take) - 1);
+            sink_.back() |= static_cast<uint8_t>(chunk << (free - take));
+            used_ = (used_ + take) % 8;
+            count -= take;
+        }
+    }
+
+    data_chunk& sink_;
+    uint8_t used_;
+};
+
+class golomb_reader
+{
+public:
+    golomb_reader(const uint8_t* begin, const uint8_t* end)
+      : it_(begin), end_(end), used_(0)
+    {
+    }
+
+    // False if the coded set is exhausted.
+    bool read(uint64_t& delta, uint8_t bits)
+    {
+        uint64_t quotient = 0;
+        uint64_t bit;
+
+        while (true)
+        {
+            if (!read_bits(bit, 1))
+                return false;
+
+            if (bit == 0)
+                break;
+
+            ++quotient;
+        }
+
+        uint64_t remainder;
+
+        if (!read_bits(remainder, bits))
+            return false;
+
+        delta = (quotient << bits) | remainder;
+        return true;
+    }
+
+private:
+    bool read_bits(uint64_t& value, uint8_t count)
+    {
+        value = 0;
+
+        while (count > 0)
+        {
+            if (it_ == end_)
+                return false;
+
+            const uint8_t free = 8 - used_;
+            const auto take = std::min(free, count);
+            const auto chunk = (*it_ >> (free - take)) & ((1u << take) - 1);
+            value = (value << take) | chunk;
+            used_ += take;
+            count -= take;
+
+            if (used_ == 8)
+            {
+                ++it_;
+                used_ = 0;
+            }
+        }
+
+        return true;
+    }
+
+    const uint8_t* it_;
+    const uint8_t* end_;
+    uint8_t used_;
+};
+
+// The high word of the 128 bit product, mapping a hash uniformly to a range
+// without division.
+static uint64_t multiply_high(uint64_t left, uint64_t right)
+{
+    const auto left_low = left & 0xffffffff;
+    const auto left_high = left >> 32;
+    const auto right_low = right & 0xffffffff;
+    const auto right_high = right >> 32;
+
+    const auto low_low = left_low * right_low;
+    const auto high_low = left_high * right_low;
+    const auto low_high = left_low * right_high;
+    const auto high_high = left_high * right_high;
+
+    const auto middle = (low_low >> 32) + (high_low & 0xffffffff) + low_high;
+    return high_high + (high_low >> 32) + (middle >> 32);
+}
+
+static half_hash to_key(const hash_digest& block_hash)
+{
+    half_hash key;
+    std::copy(block_hash.begin(), block_hash.begin() + half_hash_size,
+        key.begin());
+    return key;
+}
+
+data_stack block_filter::basic_elements(const block& block,
+    const data_stack& spent_scripts)
+{
+    static const auto return_ = static_cast<uint8_t>(opcode::return_);
+    data_stack elements;
+
+    for (const auto& tx: block.transactions)
+    {
+        for (const auto& output: tx->outputs)
+        {
+            auto script = output.script.to_data(false);
+
+            // Empty and provably unspendable scripts are excluded.
+            if (!script.empty() && script.front() != return_)
+                elements.push_back(std::move(script));
+        }
+    }
+
+    for (const auto& script: spent_scripts)
+        if (!script.empty())
+            elements.push_back(script);
+
+    std::sort(elements.begin(), elements.end());
+    elements.erase(std::unique(elements.begin(), elements.end()),
+        elements.end());
+    return elements;
+}
+
+block_filter block_filter::factory_from_block(const block& block,
+    const data_stack& spent_scripts)
+{
+    return block_filter(block.header.hash(),
+        basic_elements(block, spent_scripts));
+}
+
+block_filter::list block_filter::factory_from_blocks(threadpool& pool,
+    const block::const_ptr_list& blocks,
+    const std::vector<data_stack>& spent_scripts)
+{
+    BITCOIN_ASSERT(blocks.size() == spent_scripts.size());
+    list filters(blocks.size());
+
+    if (blocks.empty())
+        return filters;
+
+    std::vector<size_t> positions(blocks.size());
+
+    for (size_t position = 0; position < positions.size(); ++position)
+        positions[position] = position;
+
+    // Each job writes only the filter at its position.
+    dispatcher dispatch(pool, NAME);
+    const auto built = std::make_shared<std::promise<void>>();
+    const auto complete = [built](const code&) { built->set_value(); };
+    const auto done = built->get_future();
+    dispatch.parallel(positions, NAME, complete, &block_filter::build,
+        std::ref(filters), std::cref(blocks), std::cref(spent_scripts));
+    done.wait();
+    return filters;
+}
+
+void block_filter::build(list& filters, const block::const_ptr_list& blocks,
+    const std::vector<data_stack>& spent_scripts, size_t position,
+    result_handler handler)
+{
+    filters[position] = factory_from_block(*blocks[position],
+        spent_scripts[position]);
+    handler(error::success);
+}
+
+hash_list block_filter::headers(const list& filters,
+    const hash_digest& previous_header)
+{
+    hash_list result;
+    result.reserve(filters.size());
+    auto previous = previous_header;
+
+    for (const auto& filter: filters)
+    {
+        previous = filter.header(previous);
+        result.push_back(previous);
+    }
+
+    return result;
+}
+
+block_filter::block_filter()
+  : block_filter(null_hash, data_stack{})
+{
+}
+
+block_filter::block_filter(const hash_digest& block_hash,
+    const data_stack& elements)
+  : block_hash_(block_hash), size_(elements.size())
+{
+    const auto values = hash_elements(elements);
+
+    const auto prefix = variable_uint_size(size_);
+
+    // The coded set averages a little over golomb_bits + 1 bits per value.
+    data_.reserve(prefix + (size_ * (golomb_bits + 2) + 7) / 8);
+    data_.resize(prefix);
+    data_writer sink(data_);
+    sink.write_variable_uint_little_endian(size_);
+
+    golomb_writer writer(data_);
+    uint64_t previous = 0;
+
+    for (const auto value: values)
+    {
+        writer.write(value - previous, golomb_bits);
+        previous = value;
+    }
+
+    hash_ = bitcoin_hash(data_);
+}
+
+bool block_filter::from_data(const hash_digest& block_hash,
+    const data_chunk& data)
+{
+    data_reader source(data);
+    const auto size = source.read_variable_uint_little_endian();
+
+    if (!source)
+        return false;
+
+    block_hash_ = block_hash;
+    size_ = size;
+    data_ = data;
+    hash_ = bitcoin_hash(data_);
+    return true;
+}
+
+const data_chunk& block_filter::to_data() const
+{
+    return data_;
+}
+
+const hash_digest& block_filter::block_hash() const
+{
+    return block_hash_;
+}
+
+uint64_t block_filter::size() const
+{
+    return size_;
+}
+
+const hash_digest& block_filter::hash() const
+{
+    return hash_;
+}
+
+hash_digest block_filter::header(const hash_digest& previous_header) const
+{
+    byte_array<2 * hash_size> preimage;
+    std::copy(hash_.begin(), hash_.end(), preimage.begin());
+    std::copy(previous_header.begin(), previous_header.end(),
+        preimage.begin() + hash_size);
+    return bitcoin_hash(preimage);
+}
+
+// Elements are hashed to the range [0, size * inverse_rate) and sorted.
+block_filter::value_list block_filter::hash_elements(
+    const data_stack& elements) const
+{
+    const auto key = to_key(block_hash_);
+    const auto range = size_ * inverse_rate;
+    value_list values;
+    values.reserve(elements.size());
+
+    for (const auto& element: elements)
+        values.push_back(multiply_high(siphash(key, element), range));
+
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+bool block_filter::match(data_slice element) const
+{
+    if (size_ == 0)
+        return false;
+
+    const auto key = to_key(block_hash_);
+    const auto range = size_ * inverse_rate;
+    return match_any(value_list{ multiply_high(siphash(key, element),
+        range) });
+}
+
+bool block_filter::match_any(const data_stack& elements) const
+{
+    if (size_ == 0 || elements.empty())
+        return false;
+
+    return match_any(hash_elements(elements));
+}
+
+// A merge of the sorted queries with the coded set, which is decoded in
+// order, so each is read at most once regardless of the number of queries.
+bool block_filter::match_any(const value_list& sorted) const
+{
+    const auto begin = data_.data() + variable_uint_size(size_);
+    golomb_reader reader(begin, data_.data() + data_.size());
+    auto query = sorted.begin();
+    uint64_t value = 0;
+
+    for (uint64_t index = 0; index < size_; ++index)
+    {
+        uint64_t delta;
+
+        if (!reader.read(delta, golomb_bits))
+            return false;
+
+        value += delta;
+
+        while (*query < value)
+            if (++query == sorted.end())
+                return false;
+
+        if (*query == value)
+            return true;
+    }
+
+    return false;
+}
+
+#undef NAME
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_parser.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+static constexpr size_t header_size = 80;
+
+block_parser::block_parser(transaction_handler handler)
+  : handler_(handler)
+{
+    reset();
+}
+
+void block_parser::reset()
+{
+    stage_ = stage::header;
+    error_ = error::success;
+    header_.reset();
+    has_header_ = false;
+    count_ = 0;
+    parsed_ = 0;
+    buffer_.clear();
+    transaction_.reset();
+}
+
+code block_parser::write(data_slice data)
+{
+    size_t offset = 0;
+
+    while (offset < data.size())
+    {
+        code ec;
+
+        switch (stage_)
+        {
+            case stage::header:
+                ec = read_header(data, offset);
+                break;
+
+            case stage::transaction_count:
+                ec = read_count(data, offset);
+                break;
+
+            case stage::transactions:
+            {
+                offset += transaction_.write(
+                    data_slice(data.begin() + offset, data.end()));
+
+                if (transaction_.error())
+                {
+                    ec = transaction_.error();
+                    break;
+                }
+
+                if (!transaction_.complete())
+                    break;
+
+                handler_(transaction_.result(), transaction_.hash());
+                transaction_.reset();
+
+                if (++parsed_ == count_)
+                    stage_ = stage::complete;
+
+                break;
+            }
+
+            case stage::complete:
+                ec = error::bad_stream;
+                break;
+
+            default:
+                return error_;
+        }
+
+        if (ec)
+            return fail(ec);
+    }
+
+    return error_;
+}
+
+code block_parser::read_header(data_slice data, size_t& offset)
+{
+    const auto count = std::min(header_size - buffer_.size(),
+        data.size() - offset);
+    const auto begin = data.begin() + offset;
+    buffer_.insert(buffer_.end(), begin, begin + count);
+    offset += count;
+
+    if (buffer_.size() < header_size)
+        return error::success;
+
+    if (!header_.from_data(buffer_, false))
+        return error::bad_stream;
+
+    buffer_.clear();
+    has_header_ = true;
+    stage_ = stage::transaction_count;
+    return error::success;
+}
+
+code block_parser::read_count(data_slice data, size_t& offset)
+{
+    buffer_.push_back(*(data.begin() + offset++));
+    const auto prefix = buffer_.front();
+    const size_t width = prefix < 0xfd ? 0 : (prefix == 0xfd ? 2 :
+        (prefix == 0xfe ? 4 : 8));
+
+    if (buffer_.size() < 1 + width)
+        return error::success;
+
+    uint64_t value = width == 0 ? prefix : 0;
+
+    for (auto byte = width; byte > 0; --byte)
+        value = (value << 8) | buffer_[byte];
+
+    if (value > max_block_size / min_transaction_size)
+        return error::size_limits;
+
+    buffer_.clear();
+    count_ = value;
+    stage_ = count_ == 0 ? stage::complete : stage::transactions;
+    return error::success;
+}
+
+code block_parser::fail(const code& ec)
+{
+    stage_ = stage::failed;
+    error_ = ec;
+    return error_;
+}
+
+bool block_parser::has_header() const
+{
+    return has_header_;
+}
+
+const chain::header& block_parser::block_header() const
+{
+    return header_;
+}
+
+uint64_t block_parser::transaction_count() const
+{
+    return count_;
+}
+
+uint64_t block_parser::transactions_parsed() const
+{
+    return parsed_;
+}
+
+bool block_parser::complete() const
+{
+    return stage_ == stage::complete;
+}
+
+} // namespace chain
+} // namespace libbitcoin
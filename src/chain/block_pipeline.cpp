@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_pipeline.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+#define NAME "block_pipeline"
+
+block_pipeline::block_pipeline(threadpool& pool, connect_handler connect,
+    complete_handler complete, size_t decode_capacity,
+    size_t connect_capacity)
+  : connect_(connect),
+    complete_(complete),
+    decode_capacity_(std::max(decode_capacity, size_t(1))),
+    window_(decode_capacity_ + std::max(connect_capacity, size_t(1))),
+    dispatch_(pool, NAME),
+    slots_(window_),
+    decoding_(0),
+    pushed_(0),
+    completed_(0),
+    connecting_(false),
+    failed_(false),
+    stopped_(false)
+{
+    for (auto& entry: slots_)
+        entry.ready = false;
+}
+
+bool block_pipeline::push(data_chunk&& data)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    // The window bounds the decoded blocks awaiting connection.
+    if (stopped_ || decoding_ == decode_capacity_ ||
+        pushed_ - completed_ == window_)
+    {
+        mutex_.unlock();
+        return false;
+    }
+
+    const auto sequence = pushed_++;
+    ++decoding_;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The buffer is moved to the heap so that binding does not copy it.
+    const auto buffer = std::make_shared<data_chunk>(std::move(data));
+    dispatch_.concurrent(&block_pipeline::decode, shared_from_this(),
+        sequence, buffer);
+    return true;
+}
+
+size_t block_pipeline::pending() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    const auto count = pushed_ - completed_;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return count;
+}
+
+void block_pipeline::stop()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    stopped_ = true;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Decode stage: concurrent across blocks.
+void block_pipeline::decode(size_t sequence,
+    std::shared_ptr<data_chunk> data)
+{
+    const auto instance = std::make_shared<block>();
+    code ec(error::success);
+
+    if (!instance->from_data(*data))
+        ec = error::bad_stream;
+    else
+        ec = instance->check();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    auto& entry = slots_[sequence % window_];
+    entry.ready = true;
+    entry.result = ec;
+    entry.instance = instance;
+    --decoding_;
+
+    // Connection resumes only when the next block in order is decoded.
+    const auto resume = !connecting_ && sequence == completed_;
+    connecting_ = connecting_ || resume;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (resume)
+        dispatch_.ordered(&block_pipeline::connect, shared_from_this());
+}
+
+// Connect stage: one block at a time, in push order.
+void block_pipeline::connect()
+{
+    while (true)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        mutex_.lock();
+
+        auto& entry = slots_[completed_ % window_];
+
+        if (!entry.ready)
+        {
+            connecting_ = false;
+            mutex_.unlock();
+            return;
+        }
+
+        auto ec = entry.result;
+        const block::const_ptr instance = entry.instance;
+        entry.ready = false;
+        entry.instance.reset();
+        const auto stopped = stopped_;
+        const auto failed = failed_;
+
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        if (stopped)
+            ec = error::service_stopped;
+        else if (failed)
+            ec = error::previous_block_invalid;
+        else if (!ec)
+            ec = connect_(*instance);
+
+        complete_(ec, instance);
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        mutex_.lock();
+        failed_ = failed_ || ec;
+        ++completed_;
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+#undef NAME
+
+} // namespace chain
+} // namespace libbitcoin
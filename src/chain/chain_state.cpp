@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/chain_state.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash_number.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+chain_state::chain_state(bool testnet)
+  : testnet_(testnet)
+{
+    window_.reserve(median_time_past_interval);
+}
+
+void chain_state::reserve(size_t headers)
+{
+    records_.reserve(headers);
+}
+
+void chain_state::push(const header& header)
+{
+    const auto height = records_.size();
+    auto reference_bits = header.bits;
+
+    // Testnet minimum difficulty blocks defer to the previous reference.
+    if (height > 0 && height % retargeting_interval != 0 &&
+        header.bits == max_work_bits)
+        reference_bits = records_.back().reference_bits;
+
+    // Slide the sorted window, dropping the timestamp that falls out of it.
+    if (window_.size() == median_time_past_interval)
+    {
+        const auto oldest = records_[height - median_time_past_interval];
+        const auto it = std::lower_bound(window_.begin(), window_.end(),
+            oldest.timestamp);
+
+        BITCOIN_ASSERT(it != window_.end() && *it == oldest.timestamp);
+        window_.erase(it);
+    }
+
+    const auto position = std::upper_bound(window_.begin(), window_.end(),
+        header.timestamp);
+
+    window_.insert(position, header.timestamp);
+    records_.push_back({ header.timestamp, header.bits, reference_bits });
+}
+
+void chain_state::pop_to(size_t height)
+{
+    if (height + 1 >= records_.size())
+        return;
+
+    records_.resize(height + 1);
+    rebuild_window();
+}
+
+void chain_state::rebuild_window()
+{
+    window_.clear();
+    const auto count = std::min(records_.size(), median_time_past_interval);
+
+    for (auto it = records_.end() - count; it != records_.end(); ++it)
+        window_.push_back(it->timestamp);
+
+    std::sort(window_.begin(), window_.end());
+}
+
+bool chain_state::empty() const
+{
+    return records_.empty();
+}
+
+size_t chain_state::size() const
+{
+    return records_.size();
+}
+
+size_t chain_state::height() const
+{
+    return empty() ? 0 : records_.size() - 1;
+}
+
+uint32_t chain_state::median_time_past() const
+{
+    return window_.empty() ? 0 : window_[window_.size() / 2];
+}
+
+uint32_t chain_state::median_time_past(size_t height) const
+{
+    BITCOIN_ASSERT(height < records_.size());
+
+    if (height == this->height())
+        return median_time_past();
+
+    std::array<uint32_t, median_time_past_interval> times;
+    const auto count = std::min(height + 1, median_time_past_interval);
+    const auto first = records_.begin() + (height + 1 - count);
+    const auto end = times.begin() + count;
+
+    std::transform(first, first + count, times.begin(),
+        [](const record& row) { return row.timestamp; });
+
+    const auto middle = times.begin() + (count / 2);
+    std::nth_element(times.begin(), middle, end);
+    return *middle;
+}
+
+uint32_t chain_state::work_required(uint32_t timestamp) const
+{
+    return work_required(records_.size(), timestamp);
+}
+
+uint32_t chain_state::work_required(size_t height, uint32_t timestamp) const
+{
+    BITCOIN_ASSERT(height <= records_.size());
+
+    if (height == 0)
+        return max_work_bits;
+
+    if (height % retargeting_interval == 0)
+        return retarget(height);
+
+    const auto& previous = records_[height - 1];
+
+    if (!testnet_)
+        return previous.bits;
+
+    // Testnet allows a minimum difficulty block after twice the spacing.
+    if (timestamp > previous.timestamp + easy_spacing_seconds)
+        return max_work_bits;
+
+    return previous.reference_bits;
+}
+
+// The actual timespan excludes the first interval, as in the satoshi client.
+uint32_t chain_state::retarget(size_t height) const
+{
+    BITCOIN_ASSERT(height >= retargeting_interval);
+
+    const auto& first = records_[height - retargeting_interval];
+    const auto& last = records_[height - 1];
+    const int64_t timespan = int64_t(last.timestamp) - first.timestamp;
+
+    static constexpr int64_t minimum = target_timespan_seconds /
+        retargeting_factor;
+    static constexpr int64_t maximum = target_timespan_seconds *
+        retargeting_factor;
+
+    const auto actual = range_constrain(timespan, minimum, maximum);
+
+    hash_number retarget;
+    retarget.set_compact(last.bits);
+    retarget *= static_cast<uint32_t>(actual);
+    retarget /= target_timespan_seconds;
+
+    const auto maximum_target = max_target();
+    return retarget > maximum_target ? maximum_target.compact() :
+        retarget.compact();
+}
+
+code chain_state::check(const header& header) const
+{
+    if (empty())
+        return error::success;
+
+    if (header.timestamp <= median_time_past())
+        return error::timestamp_too_early;
+
+    if (header.bits != work_required(header.timestamp))
+        return error::incorrect_proof_of_work;
+
+    return error::success;
+}
+
+} // namespace chain
+} // namespace libbitcoin
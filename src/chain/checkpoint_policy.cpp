@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/checkpoint_policy.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <bitcoin/bitcoin/config/checkpoint.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+checkpoint_policy::checkpoint_policy(
+    const config::checkpoint::list& checkpoints)
+  : checkpoints_(config::checkpoint::sort(checkpoints)),
+    linked_height_(0),
+    linked_(false)
+{
+}
+
+checkpoint_policy::range checkpoint_policy::find(size_t height) const
+{
+    const auto lower = [](const config::checkpoint& item, size_t height)
+    {
+        return item.height() < height;
+    };
+
+    const auto upper = [](size_t height, const config::checkpoint& item)
+    {
+        return height < item.height();
+    };
+
+    const auto begin = checkpoints_.begin();
+    const auto end = checkpoints_.end();
+    const auto first = std::lower_bound(begin, end, height, lower);
+    return std::make_pair(first, std::upper_bound(first, end, height, upper));
+}
+
+bool checkpoint_policy::validate(const hash_digest& hash, size_t height) const
+{
+    const auto match = find(height);
+
+    for (auto it = match.first; it != match.second; ++it)
+        if (it->hash() != hash)
+            return false;
+
+    return true;
+}
+
+bool checkpoint_policy::is_checkpoint(const hash_digest& hash,
+    size_t height) const
+{
+    const auto match = find(height);
+    return match.first != match.second && validate(hash, height);
+}
+
+size_t checkpoint_policy::top_height() const
+{
+    return checkpoints_.empty() ? 0 : checkpoints_.back().height();
+}
+
+bool checkpoint_policy::link(const hash_digest& hash, size_t height)
+{
+    if (!validate(hash, height))
+        return false;
+
+    if (!is_checkpoint(hash, height))
+        return true;
+
+    // The linked height only rises, as lower checkpoints are its ancestors.
+    auto linked = linked_height_.load();
+
+    while (linked < height &&
+        !linked_height_.compare_exchange_weak(linked, height))
+    {
+    }
+
+    linked_.store(true);
+    return true;
+}
+
+size_t checkpoint_policy::linked_height() const
+{
+    return linked_height_.load();
+}
+
+bool checkpoint_policy::verify_scripts(size_t height) const
+{
+    return !linked_.load() || height > linked_height_.load();
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -32,6 +32,8 @@
 #include <bitcoin/bitcoin/math/script_number.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/string.hpp>
@@ -131,8 +133,8 @@ bool script::from_data(const data_chunk& data, bool prefix, parse_mode mode)
 
     if (prefix)
     {
-        data_source istream(data);
-        result = from_data(istream, true, mode);
+        data_reader source(data);
+        result = from_data(source, true, mode);
     }
     else
     {
@@ -152,7 +154,8 @@ bool script::from_data(std::istream& stream, bool prefix, parse_mode mode)
     return from_data(source, prefix, mode);
 }
 
-bool script::from_data(reader& source, bool prefix, parse_mode mode)
+template <typename Source>
+bool script::read(Source& source, bool prefix, parse_mode mode)
 {
     reset();
 
@@ -187,14 +190,22 @@ bool script::from_data(reader& source, bool prefix, parse_mode mode)
     return result;
 }
 
+bool script::from_data(reader& source, bool prefix, parse_mode mode)
+{
+    return read(source, prefix, mode);
+}
+
+bool script::from_data(data_reader& source, bool prefix, parse_mode mode)
+{
+    return read(source, prefix, mode);
+}
+
 data_chunk script::to_data(bool prefix) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(ostream, prefix);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(prefix));
-    return data;
+    return write_chunk(serialized_size(prefix), [&](data_writer& sink)
+    {
+        to_data(sink, prefix);
+    });
 }
 
 void script::to_data(std::ostream& stream, bool prefix) const
@@ -203,7 +214,8 @@ void script::to_data(std::ostream& stream, bool prefix) const
     to_data(sink, prefix);
 }
 
-void script::to_data(writer& sink, bool prefix) const
+template <typename Sink>
+void script::write(Sink& sink, bool prefix) const
 {
     if (prefix)
         sink.write_variable_uint_little_endian(satoshi_content_size());
@@ -215,6 +227,16 @@ void script::to_data(writer& sink, bool prefix) const
             op.to_data(sink);
 }
 
+void script::to_data(writer& sink, bool prefix) const
+{
+    write(sink, prefix);
+}
+
+void script::to_data(data_writer& sink, bool prefix) const
+{
+    write(sink, prefix);
+}
+
 uint64_t script::satoshi_content_size() const
 {
     if (operations.size() > 0 && (operations[0].code == opcode::raw_data))
@@ -362,14 +384,6 @@ inline hash_digest one_hash()
     };
 }
 
-inline void nullify_input_sequences(input::list& inputs,
-    uint32_t except_input)
-{
-    for (size_t index = 0; index < inputs.size(); ++index)
-        if (index != except_input)
-            inputs[index].sequence = 0;
-}
-
 inline uint8_t is_sighash_enum(uint8_t sighash_type,
     signature_hash_algorithm value)
 {
@@ -382,12 +396,27 @@ inline uint8_t is_sighash_flag(uint8_t sighash_type,
     return (sighash_type & value) != 0;
 }
 
+// Write an input of the signature hash preimage. The script is replaced by the
+// script code for the signing input and is blanked for all others.
+static void write_signature_input(writer& sink, const input& input,
+    const script& script_code, bool signing, bool nullify_sequence)
+{
+    input.previous_output.to_data(sink);
+
+    if (signing)
+        script_code.to_data(sink, true);
+    else
+        sink.write_variable_uint_little_endian(0);
+
+    const auto sequence = signing || !nullify_sequence ? input.sequence : 0;
+    sink.write_4_bytes_little_endian(sequence);
+}
+
+// The preimage is written directly from the parent transaction, which avoids
+// copying it (including every input and output script) for each signature.
 hash_digest script::generate_signature_hash(const transaction& parent_tx,
     uint32_t input_index, const script& script_code, uint8_t sighash_type)
 {
-    // Copy the parent transaction.
-    transaction parent(parent_tx);
-
     // This is NOT considered an error result and callers should not test
     // for one_hash. This is a bitcoind bug we perpetuate.
     if (input_index >= parent_tx.inputs.size())
@@ -395,56 +424,81 @@ hash_digest script::generate_signature_hash(const transaction& parent_tx,
 
     // FindAndDelete(OP_CODESEPARATOR) done in op_checksigverify(...)
 
-    // Blank all other inputs' signatures
-    for (auto& input: parent.inputs)
-        input.script.reset();
+    const auto none = is_sighash_enum(sighash_type,
+        signature_hash_algorithm::none) != 0;
+    const auto single = is_sighash_enum(sighash_type,
+        signature_hash_algorithm::single) != 0;
+    const auto anyone_can_pay = is_sighash_flag(sighash_type,
+        signature_hash_algorithm::anyone_can_pay) != 0;
+
+    // This is NOT considered an error result and callers should not test
+    // for one_hash. This is a bitcoind bug we perpetuate.
+    if (single && input_index >= parent_tx.outputs.size())
+        return one_hash();
 
-    parent.inputs[input_index].script = script_code;
+    data_chunk data;
+    data.reserve(parent_tx.serialized_size() +
+        script_code.serialized_size(true) + sizeof(uint32_t));
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_4_bytes_little_endian(parent_tx.version);
 
-    // The default sighash::all signs all outputs, and the current input.
-    // Transaction cannot be updated without resigning the input.
-    // (note the lack of nullify_input_sequences() call)
+    // Unless all outputs are signed, the sequences of the other inputs are
+    // zeroed so that they can be updated without resigning this input.
+    const auto& inputs = parent_tx.inputs;
+    const auto nullify = none || single;
 
-    if (is_sighash_enum(sighash_type, signature_hash_algorithm::none))
+    // Flag to ignore the other inputs except our own.
+    if (anyone_can_pay)
     {
-        // Sign no outputs, so they can be changed.
-        parent.outputs.clear();
-        nullify_input_sequences(parent.inputs, input_index);
+        sink.write_variable_uint_little_endian(1);
+        write_signature_input(sink, inputs[input_index], script_code, true,
+            nullify);
     }
-    else if (is_sighash_enum(sighash_type, signature_hash_algorithm::single))
+    else
     {
+        sink.write_variable_uint_little_endian(inputs.size());
 
-        // Sign the single output corresponding to our index.
-        // We don't care about additional inputs or outputs to the tx.
-        auto& outputs = parent.outputs;
-        uint32_t output_index = input_index;
+        for (size_t index = 0; index < inputs.size(); ++index)
+            write_signature_input(sink, inputs[index], script_code,
+                index == input_index, nullify);
+    }
 
-        // This is NOT considered an error result and callers should not test
-        // for one_hash. This is a bitcoind bug we perpetuate.
-        if (output_index >= outputs.size())
-            return one_hash();
+    const auto& outputs = parent_tx.outputs;
 
-        outputs.resize(output_index + 1);
+    if (none)
+    {
+        // Sign no outputs, so they can be changed.
+        sink.write_variable_uint_little_endian(0);
+    }
+    else if (single)
+    {
+        // Sign the single output corresponding to our index. We don't care
+        // about additional inputs or outputs, preceding outputs are blanked.
+        sink.write_variable_uint_little_endian(input_index + 1);
 
-        // Loop through outputs except the last one.
-        for (auto it = outputs.begin(); it != outputs.end() - 1; ++it)
+        for (size_t index = 0; index < input_index; ++index)
         {
-            it->value = std::numeric_limits<uint64_t>::max();
-            it->script.reset();
+            sink.write_8_bytes_little_endian(max_uint64);
+            sink.write_variable_uint_little_endian(0);
         }
 
-        nullify_input_sequences(parent.inputs, input_index);
+        outputs[input_index].to_data(sink);
     }
-
-    // Flag to ignore the other inputs except our own.
-    if (is_sighash_flag(sighash_type,
-        signature_hash_algorithm::anyone_can_pay))
+    else
     {
-        parent.inputs[0] = parent.inputs[input_index];
-        parent.inputs.resize(1);
+        // The default sighash::all signs all outputs, and the current input.
+        // Transaction cannot be updated without resigning the input.
+        sink.write_variable_uint_little_endian(outputs.size());
+
+        for (const auto& output: outputs)
+            output.to_data(sink);
     }
 
-    return parent.hash(sighash_type);
+    sink.write_4_bytes_little_endian(parent_tx.locktime);
+    sink.write_4_bytes_little_endian(sighash_type);
+    ostream.flush();
+    return bitcoin_hash(data);
 }
 
 inline bool cast_to_bool(const data_chunk& values)
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/transaction_graph.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+typedef std::pair<hash_digest, size_t> hash_position;
+
+const size_t transaction_graph::external = max_size_t;
+
+transaction_graph::transaction_graph(
+    const transaction::const_ptr_list& transactions)
+  : valid_(true),
+    levels_of_(transactions.size()),
+    parents_(transactions.size())
+{
+    const auto count = transactions.size();
+    std::vector<hash_position> hashes;
+    hashes.reserve(count);
+    size_t spends = 0;
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto& tx = *transactions[position];
+        hashes.emplace_back(tx.hash(), position);
+        spends += tx.inputs.size();
+    }
+
+    std::sort(hashes.begin(), hashes.end());
+
+    const auto find = [&hashes](const hash_digest& hash)
+    {
+        const auto it = std::lower_bound(hashes.begin(), hashes.end(),
+            hash_position(hash, 0));
+
+        return it == hashes.end() || it->first != hash ? external :
+            it->second;
+    };
+
+    offsets_.reserve(count + 1);
+    sources_.reserve(spends);
+    offsets_.push_back(0);
+
+    // Parents precede their children, so levels resolve in a single pass.
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto& tx = *transactions[position];
+        const auto coinbase = tx.is_coinbase();
+        auto& parents = parents_[position];
+        size_t level = 0;
+
+        for (const auto& input: tx.inputs)
+        {
+            const auto source = coinbase ? external :
+                find(input.previous_output.hash);
+
+            sources_.push_back(source);
+
+            if (source == external)
+                continue;
+
+            if (source >= position)
+            {
+                valid_ = false;
+                continue;
+            }
+
+            parents.push_back(source);
+            level = std::max(level, levels_of_[source] + 1);
+        }
+
+        // Sort and deduplicate once, rather than search per input.
+        std::sort(parents.begin(), parents.end());
+        parents.erase(std::unique(parents.begin(), parents.end()),
+            parents.end());
+
+        offsets_.push_back(sources_.size());
+        levels_of_[position] = level;
+
+        if (level >= levels_.size())
+            levels_.resize(level + 1);
+
+        levels_[level].push_back(position);
+    }
+}
+
+bool transaction_graph::is_valid() const
+{
+    return valid_;
+}
+
+size_t transaction_graph::size() const
+{
+    return levels_of_.size();
+}
+
+size_t transaction_graph::source(size_t transaction, size_t input) const
+{
+    BITCOIN_ASSERT(transaction < size());
+    BITCOIN_ASSERT(offsets_[transaction] + input < offsets_[transaction + 1]);
+    return sources_[offsets_[transaction] + input];
+}
+
+const transaction_graph::indexes& transaction_graph::parents(
+    size_t transaction) const
+{
+    BITCOIN_ASSERT(transaction < size());
+    return parents_[transaction];
+}
+
+size_t transaction_graph::level(size_t transaction) const
+{
+    BITCOIN_ASSERT(transaction < size());
+    return levels_of_[transaction];
+}
+
+const transaction_graph::level_list& transaction_graph::levels() const
+{
+    return levels_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
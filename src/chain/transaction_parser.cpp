@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/transaction_parser.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+static constexpr size_t version_size = sizeof(uint32_t);
+static constexpr size_t previous_output_size = hash_size + sizeof(uint32_t);
+static constexpr size_t sequence_size = sizeof(uint32_t);
+static constexpr size_t value_size = sizeof(uint64_t);
+static constexpr size_t lock_time_size = sizeof(uint32_t);
+
+transaction_parser::transaction_parser()
+{
+    reset();
+}
+
+void transaction_parser::reset()
+{
+    stage_ = stage::version;
+    error_ = error::success;
+    need_ = version_size;
+    field_ = 0;
+    inputs_ = 0;
+    outputs_ = 0;
+    buffer_.clear();
+    result_.reset();
+    hash_ = null_hash;
+}
+
+bool transaction_parser::is_variable(stage value)
+{
+    return value == stage::input_count || value == stage::input_script_size ||
+        value == stage::output_count || value == stage::output_script_size;
+}
+
+void transaction_parser::expect(stage next, size_t bytes)
+{
+    stage_ = next;
+    field_ = buffer_.size();
+    need_ = is_variable(next) ? 1 : bytes;
+}
+
+size_t transaction_parser::write(data_slice data)
+{
+    auto it = data.begin();
+
+    while (it != data.end() && stage_ != stage::complete &&
+        stage_ != stage::failed)
+    {
+        const auto available = static_cast<size_t>(data.end() - it);
+        const auto count = std::min(need_, available);
+        buffer_.insert(buffer_.end(), it, it + count);
+        it += count;
+        need_ -= count;
+
+        if (buffer_.size() > max_block_size)
+            fail(error::size_limits);
+        else if (need_ == 0)
+            advance();
+    }
+
+    return static_cast<size_t>(it - data.begin());
+}
+
+// A variable length integer completes in one or two reads of the field.
+bool transaction_parser::read_variable(uint64_t& value)
+{
+    const auto prefix = buffer_[field_];
+    const auto width = prefix < 0xfd ? 0 : (prefix == 0xfd ? 2 :
+        (prefix == 0xfe ? 4 : 8));
+
+    if (buffer_.size() - field_ < 1u + width)
+    {
+        need_ = width;
+        return false;
+    }
+
+    value = width == 0 ? prefix : 0;
+
+    for (auto byte = width; byte > 0; --byte)
+        value = (value << 8) | buffer_[field_ + byte];
+
+    return true;
+}
+
+bool transaction_parser::advance()
+{
+    uint64_t value = 0;
+
+    if (is_variable(stage_) && !read_variable(value))
+        return true;
+
+    return advance(value);
+}
+
+bool transaction_parser::advance(uint64_t value)
+{
+    switch (stage_)
+    {
+        case stage::version:
+            expect(stage::input_count, 0);
+            return true;
+
+        case stage::input_count:
+            if (value > max_block_size / min_input_size)
+                return fail(error::size_limits);
+
+            inputs_ = value;
+            expect(inputs_ == 0 ? stage::output_count :
+                stage::previous_output, previous_output_size);
+            return true;
+
+        case stage::previous_output:
+            expect(stage::input_script_size, 0);
+            return true;
+
+        case stage::input_script_size:
+            if (value > max_block_size)
+                return fail(error::size_limits);
+
+            expect(stage::input_script, static_cast<size_t>(value));
+            return need_ != 0 || advance(0);
+
+        case stage::input_script:
+            expect(stage::sequence, sequence_size);
+            return true;
+
+        case stage::sequence:
+            expect(--inputs_ == 0 ? stage::output_count :
+                stage::previous_output, previous_output_size);
+            return true;
+
+        case stage::output_count:
+            if (value > max_block_size / min_output_size)
+                return fail(error::size_limits);
+
+            outputs_ = value;
+            expect(outputs_ == 0 ? stage::lock_time : stage::value,
+                outputs_ == 0 ? lock_time_size : value_size);
+            return true;
+
+        case stage::value:
+            expect(stage::output_script_size, 0);
+            return true;
+
+        case stage::output_script_size:
+            if (value > max_block_size)
+                return fail(error::size_limits);
+
+            expect(stage::output_script, static_cast<size_t>(value));
+            return need_ != 0 || advance(0);
+
+        case stage::output_script:
+            if (--outputs_ == 0)
+                expect(stage::lock_time, lock_time_size);
+            else
+                expect(stage::value, value_size);
+
+            return true;
+
+        case stage::lock_time:
+            return finish();
+
+        default:
+            return false;
+    }
+}
+
+bool transaction_parser::finish()
+{
+    // The buffer is hashed once and the hash is cached by the instance if
+    // the buffer is canonical. Otherwise (non-minimal counts) the buffer hash
+    // is not the txid, so the canonical hash is computed by the instance.
+    const auto instance = std::make_shared<transaction>();
+
+    if (!instance->from_data(buffer_, bitcoin_hash(buffer_)))
+        return fail(error::bad_stream);
+
+    hash_ = instance->hash();
+    result_ = instance;
+    stage_ = stage::complete;
+    return true;
+}
+
+bool transaction_parser::fail(const code& ec)
+{
+    stage_ = stage::failed;
+    error_ = ec;
+    return false;
+}
+
+bool transaction_parser::complete() const
+{
+    return stage_ == stage::complete;
+}
+
+code transaction_parser::error() const
+{
+    return error_;
+}
+
+transaction::const_ptr transaction_parser::result() const
+{
+    return result_;
+}
+
+const hash_digest& transaction_parser::hash() const
+{
+    return hash_;
+}
+
+size_t transaction_parser::size() const
+{
+    return buffer_.size();
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,353 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/transaction_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+typedef std::unordered_set<hash_digest> hash_set;
+
+// As in the satoshi client.
+const size_t transaction_pool::max_package_count = 25;
+
+static uint64_t fee_rate(uint64_t fee, uint64_t size)
+{
+    return size == 0 ? 0 : fee * 1000u / size;
+}
+
+uint64_t transaction_pool::package::rate() const
+{
+    return fee_rate(fee, size);
+}
+
+uint64_t transaction_pool::entry::rate() const
+{
+    return fee_rate(fee, size);
+}
+
+transaction_pool::transaction_pool(uint64_t byte_budget)
+  : byte_budget_(byte_budget),
+    bytes_(0)
+{
+}
+
+// A package that pays well for a poor parent is not penalized for it.
+transaction_pool::rate_key transaction_pool::ancestor_key(
+    const hash_digest& hash, const entry& entry)
+{
+    return std::make_pair(std::min(entry.rate(), entry.ancestors.rate()),
+        hash);
+}
+
+// A parent that pays well is not evicted for its poor descendants alone.
+transaction_pool::rate_key transaction_pool::descendant_key(
+    const hash_digest& hash, const entry& entry)
+{
+    return std::make_pair(std::max(entry.rate(), entry.descendants.rate()),
+        hash);
+}
+
+hash_list transaction_pool::ancestors(const entry& entry) const
+{
+    hash_list out;
+    hash_set visited;
+    auto pending = entry.parents;
+
+    while (!pending.empty())
+    {
+        const auto hash = pending.back();
+        pending.pop_back();
+
+        if (!visited.insert(hash).second)
+            continue;
+
+        out.push_back(hash);
+        const auto& parents = entries_.find(hash)->second.parents;
+        pending.insert(pending.end(), parents.begin(), parents.end());
+    }
+
+    return out;
+}
+
+hash_list transaction_pool::descendants(const entry& entry) const
+{
+    hash_list out;
+    hash_set visited;
+    auto pending = entry.children;
+
+    while (!pending.empty())
+    {
+        const auto hash = pending.back();
+        pending.pop_back();
+
+        if (!visited.insert(hash).second)
+            continue;
+
+        out.push_back(hash);
+        const auto& children = entries_.find(hash)->second.children;
+        pending.insert(pending.end(), children.begin(), children.end());
+    }
+
+    return out;
+}
+
+code transaction_pool::store(transaction::const_ptr tx, uint64_t fee)
+{
+    const auto hash = tx->hash();
+
+    if (exists(hash))
+        return error::duplicate;
+
+    if (tx->is_coinbase())
+        return error::coinbase_transaction;
+
+    for (const auto& input: tx->inputs)
+        if (spends_.find(input.previous_output) != spends_.end())
+            return error::double_spend;
+
+    const auto size = tx->serialized_size();
+    const auto sigops = tx->signature_operations();
+    entry item{ tx, fee, size, sigops, { fee, size, 1 }, { fee, size, 1 }, {},
+        {} };
+
+    for (const auto& input: tx->inputs)
+    {
+        const auto& parent = input.previous_output.hash;
+        auto& parents = item.parents;
+
+        if (exists(parent) &&
+            std::find(parents.begin(), parents.end(), parent) == parents.end())
+            parents.push_back(parent);
+    }
+
+    const auto lineage = ancestors(item);
+
+    if (lineage.size() >= max_package_count)
+        return error::size_limits;
+
+    for (const auto& ancestor: lineage)
+    {
+        const auto& existing = entries_.find(ancestor)->second;
+
+        if (existing.descendants.count >= max_package_count)
+            return error::size_limits;
+
+        item.ancestors.fee += existing.fee;
+        item.ancestors.size += existing.size;
+        ++item.ancestors.count;
+    }
+
+    for (const auto& ancestor: lineage)
+    {
+        auto& existing = entries_.find(ancestor)->second;
+        descendant_scores_.erase(descendant_key(ancestor, existing));
+        existing.descendants.fee += fee;
+        existing.descendants.size += size;
+        ++existing.descendants.count;
+        descendant_scores_.insert(descendant_key(ancestor, existing));
+    }
+
+    for (const auto& parent: item.parents)
+        entries_.find(parent)->second.children.push_back(hash);
+
+    for (const auto& input: tx->inputs)
+        spends_.emplace(input.previous_output, hash);
+
+    fee_rates_.emplace(item.rate(), hash);
+    ancestor_scores_.insert(ancestor_key(hash, item));
+    descendant_scores_.insert(descendant_key(hash, item));
+    entries_.emplace(hash, std::move(item));
+    bytes_ += size;
+
+    // Each eviction removes a package, so this terminates.
+    while (bytes_ > byte_budget_)
+        remove_package(hash_digest(descendant_scores_.begin()->second));
+
+    return exists(hash) ? error::success : error::pool_filled;
+}
+
+void transaction_pool::remove_entry(const hash_digest& hash)
+{
+    const auto it = entries_.find(hash);
+
+    if (it == entries_.end())
+        return;
+
+    const auto& item = it->second;
+
+    for (const auto& ancestor: ancestors(item))
+    {
+        auto& existing = entries_.find(ancestor)->second;
+        descendant_scores_.erase(descendant_key(ancestor, existing));
+        existing.descendants.fee -= item.fee;
+        existing.descendants.size -= item.size;
+        --existing.descendants.count;
+        descendant_scores_.insert(descendant_key(ancestor, existing));
+    }
+
+    for (const auto& descendant: descendants(item))
+    {
+        auto& existing = entries_.find(descendant)->second;
+        ancestor_scores_.erase(ancestor_key(descendant, existing));
+        existing.ancestors.fee -= item.fee;
+        existing.ancestors.size -= item.size;
+        --existing.ancestors.count;
+        ancestor_scores_.insert(ancestor_key(descendant, existing));
+    }
+
+    const auto unlink = [&hash](hash_list& hashes)
+    {
+        hashes.erase(std::remove(hashes.begin(), hashes.end(), hash),
+            hashes.end());
+    };
+
+    for (const auto& parent: item.parents)
+        unlink(entries_.find(parent)->second.children);
+
+    for (const auto& child: item.children)
+        unlink(entries_.find(child)->second.parents);
+
+    for (const auto& input: item.transaction->inputs)
+    {
+        const auto spend = spends_.find(input.previous_output);
+
+        if (spend != spends_.end() && spend->second == hash)
+            spends_.erase(spend);
+    }
+
+    fee_rates_.erase(std::make_pair(item.rate(), hash));
+    ancestor_scores_.erase(ancestor_key(hash, item));
+    descendant_scores_.erase(descendant_key(hash, item));
+    bytes_ -= item.size;
+    entries_.erase(it);
+}
+
+void transaction_pool::remove_package(const hash_digest& hash)
+{
+    const auto it = entries_.find(hash);
+
+    if (it == entries_.end())
+        return;
+
+    // Remove the deepest descendants first, so fewer packages are updated.
+    auto package = descendants(it->second);
+    std::reverse(package.begin(), package.end());
+    package.push_back(hash);
+
+    for (const auto& member: package)
+        remove_entry(member);
+}
+
+void transaction_pool::remove(const block& block)
+{
+    for (const auto& tx: block.transactions)
+    {
+        if (tx->is_coinbase())
+            continue;
+
+        remove_entry(tx->hash());
+
+        for (const auto& input: tx->inputs)
+        {
+            const auto spend = spends_.find(input.previous_output);
+
+            if (spend != spends_.end())
+                remove_package(hash_digest(spend->second));
+        }
+    }
+}
+
+bool transaction_pool::remove(const hash_digest& hash)
+{
+    if (!exists(hash))
+        return false;
+
+    remove_package(hash);
+    return true;
+}
+
+const transaction_pool::entry* transaction_pool::find(
+    const hash_digest& hash) const
+{
+    const auto it = entries_.find(hash);
+    return it == entries_.end() ? nullptr : &it->second;
+}
+
+bool transaction_pool::exists(const hash_digest& hash) const
+{
+    return entries_.find(hash) != entries_.end();
+}
+
+bool transaction_pool::spender(hash_digest& out,
+    const output_point& outpoint) const
+{
+    const auto it = spends_.find(outpoint);
+
+    if (it == spends_.end())
+        return false;
+
+    out = it->second;
+    return true;
+}
+
+hash_list transaction_pool::filter(uint64_t minimum_fee) const
+{
+    hash_list out;
+
+    for (auto it = fee_rates_.rbegin(); it != fee_rates_.rend(); ++it)
+    {
+        if (it->first < minimum_fee)
+            break;
+
+        out.push_back(it->second);
+    }
+
+    return out;
+}
+
+const transaction_pool::rate_index& transaction_pool::ancestor_scores() const
+{
+    return ancestor_scores_;
+}
+
+size_t transaction_pool::size() const
+{
+    return entries_.size();
+}
+
+uint64_t transaction_pool::bytes() const
+{
+    return bytes_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
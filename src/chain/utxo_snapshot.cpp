@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/utxo_snapshot.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <bitcoin/bitcoin/chain/script/script.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
+#include <bitcoin/bitcoin/utility/variable_uint_size.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+const uint32_t snapshot_header::current_version = 1;
+const size_t snapshot_header::satoshi_fixed_size = 4 + 4 + hash_size +
+    hash_size + 8;
+const size_t snapshot_writer::default_chunk_records = 4096;
+const size_t snapshot_reader::max_chunk_records = 65536;
+
+// utxo_record
+// ----------------------------------------------------------------------------
+
+bool utxo_record::from_data(reader& source)
+{
+    if (!point.from_data(source))
+        return false;
+
+    const auto code = source.read_variable_uint_little_endian();
+    output.value = source.read_variable_uint_little_endian();
+
+    if (!source || (code >> 1) > max_uint32)
+        return false;
+
+    height = static_cast<uint32_t>(code >> 1);
+    coinbase = (code & 1) != 0;
+    return output.script.from_data(source, true,
+        script::parse_mode::raw_data_fallback);
+}
+
+data_chunk utxo_record::to_data() const
+{
+    return write_chunk(serialized_size(), [&](data_writer& sink)
+    {
+        to_data(sink);
+    });
+}
+
+void utxo_record::to_data(writer& sink) const
+{
+    point.to_data(sink);
+    sink.write_variable_uint_little_endian(
+        (static_cast<uint64_t>(height) << 1) | (coinbase ? 1 : 0));
+    sink.write_variable_uint_little_endian(output.value);
+    output.script.to_data(sink, true);
+}
+
+uint64_t utxo_record::serialized_size() const
+{
+    const auto code = (static_cast<uint64_t>(height) << 1) | 1;
+    return point.serialized_size() + variable_uint_size(code) +
+        variable_uint_size(output.value) + output.script.serialized_size(true);
+}
+
+bool utxo_record::precedes(const utxo_record& other) const
+{
+    return point.hash < other.point.hash ||
+        (point.hash == other.point.hash && point.index < other.point.index);
+}
+
+// snapshot_header
+// ----------------------------------------------------------------------------
+
+bool snapshot_header::from_data(reader& source)
+{
+    version = source.read_4_bytes_little_endian();
+    height = source.read_4_bytes_little_endian();
+    block_hash = source.read_hash();
+    commitment = source.read_hash();
+    count = source.read_8_bytes_little_endian();
+    return static_cast<bool>(source);
+}
+
+void snapshot_header::to_data(writer& sink) const
+{
+    sink.write_4_bytes_little_endian(version);
+    sink.write_4_bytes_little_endian(height);
+    sink.write_hash(block_hash);
+    sink.write_hash(commitment);
+    sink.write_8_bytes_little_endian(count);
+}
+
+// snapshot_writer
+// ----------------------------------------------------------------------------
+
+snapshot_writer::snapshot_writer(std::ostream& stream,
+    const snapshot_header& header, size_t chunk_records)
+  : sink_(stream),
+    header_(header),
+    chunk_records_(range_constrain(chunk_records, size_t(1),
+        snapshot_reader::max_chunk_records)),
+    pending_(0),
+    written_(0),
+    failed_(false)
+{
+    header_.to_data(sink_);
+    failed_ = !sink_;
+}
+
+bool snapshot_writer::write(const utxo_record& record)
+{
+    if (failed_ || (written_ > 0 && !last_.precedes(record)))
+        return false;
+
+    const auto data = record.to_data();
+    commitment_.insert(data);
+    extend_data(chunk_, data);
+    last_.point = record.point;
+    ++written_;
+
+    if (++pending_ == chunk_records_)
+        return flush();
+
+    return true;
+}
+
+bool snapshot_writer::flush()
+{
+    if (pending_ > 0)
+    {
+        sink_.write_variable_uint_little_endian(pending_);
+        sink_.write_data(chunk_);
+        chunk_.clear();
+        pending_ = 0;
+    }
+
+    failed_ = failed_ || !sink_;
+    return !failed_;
+}
+
+bool snapshot_writer::finish()
+{
+    return flush() && written_ == header_.count &&
+        commitment_.digest() == header_.commitment;
+}
+
+// snapshot_reader
+// ----------------------------------------------------------------------------
+
+snapshot_reader::snapshot_reader(std::istream& stream)
+  : source_(stream),
+    remaining_(0),
+    started_(false),
+    failed_(false),
+    complete_(false)
+{
+}
+
+bool snapshot_reader::fail()
+{
+    failed_ = true;
+    return false;
+}
+
+bool snapshot_reader::start()
+{
+    if (started_)
+        return !failed_;
+
+    started_ = true;
+
+    if (!header_.from_data(source_) ||
+        header_.version != snapshot_header::current_version)
+        return fail();
+
+    remaining_ = header_.count;
+    complete_ = remaining_ == 0 &&
+        commitment_.digest() == header_.commitment;
+    return true;
+}
+
+const snapshot_header& snapshot_reader::header() const
+{
+    return header_;
+}
+
+bool snapshot_reader::read(utxo_record::list& records)
+{
+    records.clear();
+
+    if (!started_ || failed_ || remaining_ == 0)
+        return false;
+
+    const auto count = source_.read_variable_uint_little_endian();
+
+    if (!source_ || count == 0 || count > remaining_ ||
+        count > max_chunk_records)
+        return fail();
+
+    records.resize(static_cast<size_t>(count));
+
+    for (auto& record: records)
+    {
+        if (!record.from_data(source_))
+            return fail();
+
+        // Strict ordering also precludes duplicate points.
+        if (remaining_ != header_.count && !last_.precedes(record))
+            return fail();
+
+        commitment_.insert(record.to_data());
+        last_.point = record.point;
+        --remaining_;
+    }
+
+    if (remaining_ == 0)
+    {
+        complete_ = commitment_.digest() == header_.commitment;
+
+        if (!complete_)
+            return fail();
+    }
+
+    return true;
+}
+
+bool snapshot_reader::complete() const
+{
+    return complete_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
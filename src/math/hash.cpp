@@ -25,6 +25,7 @@
 #include <errno.h>
 #include <new>
 #include <stdexcept>
+#include <bitcoin/bitcoin/utility/endian.hpp>
 #include "../math/external/crypto_scrypt.h"
 #include "../math/external/hmac_sha256.h"
 #include "../math/external/hmac_sha512.h"
@@ -109,6 +110,122 @@ hash_digest bitcoin_hash(data_slice data)
     return sha256_hash(sha256_hash(data));
 }
 
+static uint64_t rotate_left(uint64_t value, size_t bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3)
+{
+    v0 += v1;
+    v1 = rotate_left(v1, 13);
+    v1 ^= v0;
+    v0 = rotate_left(v0, 32);
+    v2 += v3;
+    v3 = rotate_left(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotate_left(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotate_left(v1, 17);
+    v1 ^= v2;
+    v2 = rotate_left(v2, 32);
+}
+
+uint64_t siphash(const half_hash& key, data_slice data)
+{
+    const auto k0 = from_little_endian_unsafe<uint64_t>(key.begin());
+    const auto k1 = from_little_endian_unsafe<uint64_t>(key.begin() + 8);
+
+    auto v0 = 0x736f6d6570736575 ^ k0;
+    auto v1 = 0x646f72616e646f6d ^ k1;
+    auto v2 = 0x6c7967656e657261 ^ k0;
+    auto v3 = 0x7465646279746573 ^ k1;
+
+    const auto size = data.size();
+    const auto tail = size % sizeof(uint64_t);
+    auto it = data.begin();
+
+    for (const auto end = it + (size - tail); it != end;
+        it += sizeof(uint64_t))
+    {
+        const auto word = from_little_endian_unsafe<uint64_t>(it);
+        v3 ^= word;
+        sip_round(v0, v1, v2, v3);
+        sip_round(v0, v1, v2, v3);
+        v0 ^= word;
+    }
+
+    // The final word holds the tail bytes and the low byte of the size.
+    auto word = static_cast<uint64_t>(size) << 56;
+
+    for (size_t byte = 0; byte < tail; ++byte)
+        word |= static_cast<uint64_t>(it[byte]) << (8 * byte);
+
+    v3 ^= word;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    v0 ^= word;
+
+    v2 ^= 0xff;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+static uint32_t rotate_left(uint32_t value, size_t bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+uint32_t murmur3(data_slice data, uint32_t seed)
+{
+    static constexpr uint32_t c1 = 0xcc9e2d51;
+    static constexpr uint32_t c2 = 0x1b873593;
+
+    const auto size = data.size();
+    const auto tail = size % sizeof(uint32_t);
+    auto it = data.begin();
+    auto hash = seed;
+
+    for (const auto end = it + (size - tail); it != end;
+        it += sizeof(uint32_t))
+    {
+        auto word = from_little_endian_unsafe<uint32_t>(it);
+        word *= c1;
+        word = rotate_left(word, 15);
+        word *= c2;
+        hash ^= word;
+        hash = rotate_left(hash, 13);
+        hash = hash * 5 + 0xe6546b64;
+    }
+
+    uint32_t word = 0;
+
+    for (size_t byte = tail; byte > 0; --byte)
+        word ^= static_cast<uint32_t>(it[byte - 1]) << (8 * (byte - 1));
+
+    if (tail != 0)
+    {
+        word *= c1;
+        word = rotate_left(word, 15);
+        word *= c2;
+        hash ^= word;
+    }
+
+    // Finalization mix.
+    hash ^= static_cast<uint32_t>(size);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
 short_hash bitcoin_short_hash(data_slice data)
 {
     return ripemd160_hash(sha256_hash(data));
@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/multiset_hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+// The modulus is 2^3072 - prime_offset, so 2^3072 = prime_offset (mod p).
+static constexpr uint32_t prime_offset = 1103717;
+static constexpr size_t limbs = 3072 / 32;
+static constexpr size_t number_size = limbs * sizeof(uint32_t);
+typedef std::array<uint32_t, limbs> number;
+
+static const number one = []()
+{
+    number value;
+    value.fill(0);
+    value[0] = 1;
+    return value;
+}();
+
+static bool is_zero(const number& value)
+{
+    return std::all_of(value.begin(), value.end(),
+        [](uint32_t limb) { return limb == 0; });
+}
+
+// True if the value is within [2^3072 - prime_offset, 2^3072).
+static bool overflows(const number& value)
+{
+    for (size_t index = limbs - 1; index > 0; --index)
+        if (value[index] != max_uint32)
+            return false;
+
+    return value[0] > max_uint32 - prime_offset;
+}
+
+// Reduce a value below 2^3072 into [0, p), adding 2^3072 - p and carrying out.
+static void normalize(number& value)
+{
+    if (!overflows(value))
+        return;
+
+    uint64_t carry = prime_offset;
+
+    for (auto& limb: value)
+    {
+        carry += limb;
+        limb = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+}
+
+static number multiply(const number& left, const number& right)
+{
+    std::array<uint32_t, 2 * limbs> product;
+    product.fill(0);
+
+    for (size_t row = 0; row < limbs; ++row)
+    {
+        uint64_t carry = 0;
+
+        for (size_t column = 0; column < limbs; ++column)
+        {
+            carry += product[row + column] +
+                static_cast<uint64_t>(left[row]) * right[column];
+            product[row + column] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+
+        product[row + limbs] = static_cast<uint32_t>(carry);
+    }
+
+    // Fold the high half onto the low half, multiplied by 2^3072 (mod p).
+    number result;
+    uint64_t carry = 0;
+
+    for (size_t index = 0; index < limbs; ++index)
+    {
+        carry += product[index] +
+            static_cast<uint64_t>(product[index + limbs]) * prime_offset;
+        result[index] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+
+    // The carry is small, but folding it may overflow 2^3072 once more.
+    while (carry != 0)
+    {
+        carry *= prime_offset;
+
+        for (auto& limb: result)
+        {
+            carry += limb;
+            limb = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+
+    normalize(result);
+    return result;
+}
+
+// Fermat inversion, raising the value to p - 2 (all ones but the low limb).
+static number invert(const number& value)
+{
+    auto result = one;
+
+    for (size_t index = limbs; index-- > 0;)
+    {
+        const auto exponent = index == 0 ? max_uint32 - prime_offset - 1 :
+            max_uint32;
+
+        for (size_t bit = 32; bit-- > 0;)
+        {
+            result = multiply(result, result);
+
+            if (((exponent >> bit) & 1) != 0)
+                result = multiply(result, value);
+        }
+    }
+
+    return result;
+}
+
+static number to_number(const uint8_t* data)
+{
+    number result;
+
+    for (size_t index = 0; index < limbs; ++index)
+        result[index] = from_little_endian_unsafe<uint32_t>(
+            data + index * sizeof(uint32_t));
+
+    return result;
+}
+
+static void from_number(uint8_t* data, const number& value)
+{
+    for (size_t index = 0; index < limbs; ++index)
+    {
+        const auto bytes = to_little_endian(value[index]);
+        std::copy(bytes.begin(), bytes.end(), data + index * sizeof(uint32_t));
+    }
+}
+
+// Map an element into the group, where zero (negligible) is taken as one.
+// The sha256 of the element is expanded to the size of the group by sha512
+// of it and the index of each 64 byte part.
+static number to_element(data_slice element)
+{
+    const auto hash = sha256_hash(element);
+    std::array<uint8_t, number_size> expanded;
+
+    for (size_t part = 0; part < number_size / long_hash_size; ++part)
+    {
+        const auto bytes = sha512_hash(build_chunk(
+        {
+            hash, to_chunk(static_cast<uint8_t>(part))
+        }));
+
+        std::copy(bytes.begin(), bytes.end(),
+            expanded.begin() + part * long_hash_size);
+    }
+
+    auto result = to_number(expanded.data());
+    normalize(result);
+    return is_zero(result) ? one : result;
+}
+
+multiset_hash::multiset_hash()
+  : numerator_(one), denominator_(one)
+{
+}
+
+void multiset_hash::insert(data_slice element)
+{
+    numerator_ = multiply(numerator_, to_element(element));
+}
+
+void multiset_hash::remove(data_slice element)
+{
+    denominator_ = multiply(denominator_, to_element(element));
+}
+
+multiset_hash& multiset_hash::operator+=(const multiset_hash& other)
+{
+    numerator_ = multiply(numerator_, other.numerator_);
+    denominator_ = multiply(denominator_, other.denominator_);
+    return *this;
+}
+
+multiset_hash& multiset_hash::operator-=(const multiset_hash& other)
+{
+    numerator_ = multiply(numerator_, other.denominator_);
+    denominator_ = multiply(denominator_, other.numerator_);
+    return *this;
+}
+
+bool multiset_hash::operator==(const multiset_hash& other) const
+{
+    return multiply(numerator_, other.denominator_) ==
+        multiply(other.numerator_, denominator_);
+}
+
+bool multiset_hash::operator!=(const multiset_hash& other) const
+{
+    return !(*this == other);
+}
+
+hash_digest multiset_hash::digest() const
+{
+    std::array<uint8_t, number_size> value;
+    from_number(value.data(), multiply(numerator_, invert(denominator_)));
+    return sha256_hash(value);
+}
+
+data_chunk multiset_hash::to_data() const
+{
+    data_chunk data(2 * number_size);
+    from_number(data.data(), numerator_);
+    from_number(data.data() + number_size, denominator_);
+    return data;
+}
+
+bool multiset_hash::from_data(const data_chunk& data)
+{
+    if (data.size() != 2 * number_size)
+        return false;
+
+    const auto numerator = to_number(data.data());
+    const auto denominator = to_number(data.data() + number_size);
+
+    if (overflows(numerator) || overflows(denominator) ||
+        is_zero(numerator) || is_zero(denominator))
+        return false;
+
+    numerator_ = numerator;
+    denominator_ = denominator;
+    return true;
+}
+
+} // namespace libbitcoin
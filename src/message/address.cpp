@@ -19,10 +19,16 @@
  */
 #include <bitcoin/bitcoin/message/address.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -67,8 +73,8 @@ void address::reset()
 
 bool address::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool address::from_data(uint32_t version, std::istream& stream)
@@ -77,7 +83,8 @@ bool address::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool address::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool address::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -86,14 +93,15 @@ bool address::from_data(uint32_t version, reader& source)
 
     if (result)
     {
-        addresses.resize(count);
+        const auto available = std::min(source.remaining(),
+            heading::maximum_payload_size(version));
+        bounded_reserve(addresses, count, available,
+            network_address::satoshi_fixed_size(version, true));
 
-        for (auto& address: addresses)
+        for (uint64_t index = 0; index < count && result; ++index)
         {
-            result = address.from_data(version, source, true);
-
-            if (!result)
-                break;
+            addresses.emplace_back();
+            result = addresses.back().from_data(version, source, true);
         }
     }
 
@@ -103,14 +111,22 @@ bool address::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool address::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool address::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk address::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void address::to_data(uint32_t version, std::ostream& stream) const
@@ -119,13 +135,24 @@ void address::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void address::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void address::write(uint32_t version, Sink& sink) const
 {
     sink.write_variable_uint_little_endian(addresses.size());
     for (const network_address& net_address : addresses)
         net_address.to_data(version, sink, true);
 }
 
+void address::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void address::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t address::serialized_size(uint32_t version) const
 {
     return variable_uint_size(addresses.size()) + 
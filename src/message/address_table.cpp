@@ -0,0 +1,478 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/address_table.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/address.hpp>
+#include <bitcoin/bitcoin/message/network_address.hpp>
+#include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/random.hpp>
+#include <bitcoin/bitcoin/utility/variable_uint_size.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+// As in the satoshi client (new table).
+const size_t address_table::bucket_count = 1024;
+const size_t address_table::bucket_size = 64;
+const size_t address_table::buckets_per_group = 64;
+const uint32_t address_table::stale_seconds = 30 * 24 * 60 * 60;
+const uint32_t address_table::future_seconds = 10 * 60;
+const uint32_t address_table::penalty_seconds = 5 * 24 * 60 * 60;
+
+// Announced timestamps at or below this are implausible (as in the satoshi
+// client).
+static constexpr uint32_t min_timestamp = 100000000;
+
+// The serialization is versioned to allow the format to change.
+static constexpr uint8_t format_version = 1;
+
+// The network address serialization is the same for all versions.
+static constexpr uint32_t address_version = version::level::maximum;
+
+// A slot and an address with timestamp.
+static constexpr size_t entry_size = sizeof(uint32_t) + 30;
+
+static const ip_address ipv4_prefix
+{
+    {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00
+    }
+};
+
+// The /16 of an IPv4 address or the /32 of an IPv6 address, prefixed to
+// distinguish the two.
+static data_chunk to_group(const ip_address& ip)
+{
+    const auto ipv4 = std::equal(ip.begin(), ip.begin() + 12,
+        ipv4_prefix.begin());
+
+    if (ipv4)
+        return{ 4, ip[12], ip[13] };
+
+    return{ 6, ip[0], ip[1], ip[2], ip[3] };
+}
+
+static half_hash random_salt()
+{
+    data_chunk entropy(half_hash_size);
+    pseudo_random_fill(entropy);
+    half_hash salt;
+    std::copy(entropy.begin(), entropy.end(), salt.begin());
+    return salt;
+}
+
+address_table::address_table()
+  : address_table(random_salt())
+{
+}
+
+address_table::address_table(const half_hash& salt)
+  : salt_(salt),
+    slots_(bucket_count * bucket_size, 0),
+    random_(pseudo_random())
+{
+}
+
+address_table::endpoint address_table::to_endpoint(
+    const network_address& address)
+{
+    endpoint out;
+    std::copy(address.ip.begin(), address.ip.end(), out.begin());
+    out[16] = static_cast<uint8_t>(address.port >> 8);
+    out[17] = static_cast<uint8_t>(address.port);
+    return out;
+}
+
+// The source group selects a bucket from those it may reach, the address
+// group which one, and the endpoint a slot within it.
+uint32_t address_table::locate(const network_address& address,
+    const ip_address& source) const
+{
+    const auto source_group = to_group(source);
+    const auto choice = siphash(salt_, build_chunk(
+    {
+        to_group(address.ip), source_group
+    })) % buckets_per_group;
+
+    const auto bucket = siphash(salt_, build_chunk(
+    {
+        source_group, to_chunk(to_little_endian(choice))
+    })) % bucket_count;
+
+    const auto position = siphash(salt_, build_chunk(
+    {
+        to_chunk(to_little_endian(bucket)), to_endpoint(address)
+    })) % bucket_size;
+
+    return static_cast<uint32_t>(bucket * bucket_size + position);
+}
+
+// An announced timestamp that is implausibly old or leads now is replaced
+// by one that is somewhat old, as in the satoshi client.
+static uint32_t to_timestamp(uint32_t timestamp, uint32_t now)
+{
+    const auto future = uint64_t(now) + address_table::future_seconds;
+
+    if (timestamp > min_timestamp && timestamp <= future)
+        return timestamp;
+
+    return now > address_table::penalty_seconds ?
+        now - address_table::penalty_seconds : 0;
+}
+
+// Must be called from within the critical section.
+bool address_table::do_store(const network_address& address,
+    const ip_address& source, uint32_t now)
+{
+    const auto timestamp = to_timestamp(address.timestamp, now);
+    const auto it = index_.find(to_endpoint(address));
+
+    if (it != index_.end())
+    {
+        auto& existing = entries_[it->second].address;
+        existing.timestamp = std::max(existing.timestamp, timestamp);
+        existing.services |= address.services;
+        return false;
+    }
+
+    const auto slot = locate(address, source);
+    const auto occupant = slots_[slot];
+
+    // The occupant is displaced only once it is stale now, so that claimed
+    // timestamps cannot displace fresh addresses.
+    if (occupant != 0)
+    {
+        const auto& existing = entries_[occupant - 1].address;
+        const uint64_t expiry = uint64_t(existing.timestamp) + stale_seconds;
+
+        if (now <= expiry)
+            return false;
+
+        erase(occupant - 1);
+    }
+
+    entries_.push_back({ address, slot });
+    entries_.back().address.timestamp = timestamp;
+    const auto index = static_cast<uint32_t>(entries_.size() - 1);
+    slots_[slot] = index + 1;
+    index_.emplace(to_endpoint(address), index);
+    return true;
+}
+
+// Must be called from within the critical section.
+// The last entry is moved into the erased position, keeping entries dense.
+void address_table::erase(size_t index)
+{
+    BITCOIN_ASSERT(index < entries_.size());
+    const auto& removed = entries_[index];
+    slots_[removed.slot] = 0;
+    index_.erase(to_endpoint(removed.address));
+
+    if (index != entries_.size() - 1)
+    {
+        entries_[index] = entries_.back();
+        const auto& moved = entries_[index];
+        slots_[moved.slot] = static_cast<uint32_t>(index + 1);
+        index_[to_endpoint(moved.address)] = static_cast<uint32_t>(index);
+    }
+
+    entries_.pop_back();
+}
+
+bool address_table::store(const network_address& address,
+    const ip_address& source, uint32_t now)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    const auto added = do_store(address, source, now);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return added;
+}
+
+size_t address_table::store(const address& message,
+    const ip_address& source, uint32_t now)
+{
+    size_t added = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    for (const auto& address: message.addresses)
+        if (do_store(address, source, now))
+            ++added;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return added;
+}
+
+bool address_table::remove(const network_address& address)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = index_.find(to_endpoint(address));
+    const auto found = it != index_.end();
+
+    if (found)
+        erase(it->second);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return found;
+}
+
+bool address_table::exists(const network_address& address) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto found = index_.find(to_endpoint(address)) != index_.end();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return found;
+}
+
+bool address_table::sample(network_address& out) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (entries_.empty())
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return false;
+    }
+
+    std::uniform_int_distribution<size_t> distribution(0,
+        entries_.size() - 1);
+    out = entries_[distribution(random_)].address;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return true;
+}
+
+size_t address_table::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto size = entries_.size();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return size;
+}
+
+size_t address_table::capacity() const
+{
+    return bucket_count * bucket_size;
+}
+
+// Must be called from within the critical section.
+void address_table::do_clear()
+{
+    entries_.clear();
+    index_.clear();
+    std::fill(slots_.begin(), slots_.end(), 0);
+}
+
+void address_table::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    do_clear();
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool address_table::from_data(const data_chunk& data)
+{
+    data_reader source(data);
+    return from_data(source);
+}
+
+bool address_table::from_data(std::istream& stream)
+{
+    istream_reader source(stream);
+    return from_data(source);
+}
+
+template <typename Source>
+bool address_table::read(Source& source)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    do_clear();
+    half_hash salt;
+    auto result = source.read_byte() == format_version;
+    source.read_data(salt.data(), salt.size());
+    const auto count = source.read_variable_uint_little_endian();
+    result = result && static_cast<bool>(source) && count <= capacity();
+
+    if (result)
+    {
+        bounded_reserve(entries_, count, source.remaining(), entry_size);
+
+        for (uint64_t index = 0; index < count && result; ++index)
+        {
+            entry item;
+            item.slot = source.read_4_bytes_little_endian();
+            result = item.address.from_data(address_version, source, true) &&
+                item.slot < slots_.size() && slots_[item.slot] == 0 &&
+                index_.emplace(to_endpoint(item.address), index).second;
+
+            if (result)
+            {
+                entries_.push_back(item);
+                slots_[item.slot] = static_cast<uint32_t>(index + 1);
+            }
+        }
+    }
+
+    if (result)
+        salt_ = salt;
+    else
+        do_clear();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return result;
+}
+
+bool address_table::from_data(reader& source)
+{
+    return read(source);
+}
+
+bool address_table::from_data(data_reader& source)
+{
+    return read(source);
+}
+
+// Must be called from within the critical section.
+template <typename Sink>
+void address_table::do_to_data(Sink& sink) const
+{
+    sink.write_byte(format_version);
+    sink.write_data(salt_.data(), salt_.size());
+    sink.write_variable_uint_little_endian(entries_.size());
+
+    for (const auto& item: entries_)
+    {
+        sink.write_4_bytes_little_endian(item.slot);
+        item.address.to_data(address_version, sink, true);
+    }
+}
+
+data_chunk address_table::to_data() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+
+    auto data = write_chunk(do_serialized_size(), [&](data_writer& sink)
+    {
+        do_to_data(sink);
+    });
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return data;
+}
+
+void address_table::to_data(std::ostream& stream) const
+{
+    ostream_writer sink(stream);
+    to_data(sink);
+}
+
+void address_table::to_data(writer& sink) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    do_to_data(sink);
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void address_table::to_data(data_writer& sink) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    do_to_data(sink);
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t address_table::serialized_size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto size = do_serialized_size();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return size;
+}
+
+// Must be called from within the critical section.
+uint64_t address_table::do_serialized_size() const
+{
+    return 1 + half_hash_size + variable_uint_size(entries_.size()) +
+        entries_.size() * entry_size;
+}
+
+} // namspace message
+} // namspace libbitcoin
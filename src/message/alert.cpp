@@ -24,6 +24,8 @@
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -70,8 +72,8 @@ void alert::reset()
 
 bool alert::from_data(uint32_t version, const data_chunk& data)
 {
-    boost::iostreams::stream<byte_source<data_chunk>> istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool alert::from_data(uint32_t version, std::istream& stream)
@@ -80,7 +82,8 @@ bool alert::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool alert::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool alert::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -116,14 +119,22 @@ bool alert::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool alert::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool alert::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk alert::to_data(uint32_t version) const
 {
-    data_chunk data;
-    boost::iostreams::stream<byte_sink<data_chunk>> ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void alert::to_data(uint32_t version, std::ostream& stream) const
@@ -132,7 +143,8 @@ void alert::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void alert::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void alert::write(uint32_t version, Sink& sink) const
 {
     sink.write_variable_uint_little_endian(payload.size());
     sink.write_data(payload);
@@ -140,6 +152,16 @@ void alert::to_data(uint32_t version, writer& sink) const
     sink.write_data(signature);
 }
 
+void alert::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void alert::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t alert::serialized_size(uint32_t version) const
 {
     return variable_uint_size(payload.size()) + payload.size() +
@@ -19,9 +19,15 @@
  */
 #include <bitcoin/bitcoin/message/alert_payload.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -106,8 +112,8 @@ void alert_payload::reset()
 
 bool alert_payload::from_data(uint32_t version, const data_chunk& data)
 {
-    boost::iostreams::stream<byte_source<data_chunk>> istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool alert_payload::from_data(uint32_t version, std::istream& stream)
@@ -116,7 +122,8 @@ bool alert_payload::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool alert_payload::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool alert_payload::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -126,7 +133,9 @@ bool alert_payload::from_data(uint32_t version, reader& source)
     id = source.read_4_bytes_little_endian();
     cancel = source.read_4_bytes_little_endian();
     const auto cancel_size = source.read_variable_uint_little_endian();
-    set_cancel.reserve(cancel_size);
+    const auto available = std::min(source.remaining(),
+        heading::maximum_payload_size(version));
+    bounded_reserve(set_cancel, cancel_size, available, sizeof(uint32_t));
 
     for (uint64_t i = 0; i < cancel_size && source; i++)
         set_cancel.push_back(source.read_4_bytes_little_endian());
@@ -134,7 +143,7 @@ bool alert_payload::from_data(uint32_t version, reader& source)
     min_version = source.read_4_bytes_little_endian();
     max_version = source.read_4_bytes_little_endian();
     const auto sub_version_size = source.read_variable_uint_little_endian();
-    set_sub_version.reserve(sub_version_size);
+    bounded_reserve(set_sub_version, sub_version_size, available, 1);
 
     for (uint64_t i = 0; i < sub_version_size && source; i++)
         set_sub_version.push_back(source.read_string());
@@ -150,14 +159,22 @@ bool alert_payload::from_data(uint32_t version, reader& source)
     return source;
 }
 
+bool alert_payload::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool alert_payload::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk alert_payload::to_data(uint32_t version) const
 {
-    data_chunk data;
-    boost::iostreams::stream<byte_sink<data_chunk>> ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void alert_payload::to_data(uint32_t version, std::ostream& stream) const
@@ -166,7 +183,8 @@ void alert_payload::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void alert_payload::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void alert_payload::write(uint32_t version, Sink& sink) const
 {
     sink.write_4_bytes_little_endian(this->version);
     sink.write_8_bytes_little_endian(relay_until);
@@ -191,6 +209,16 @@ void alert_payload::to_data(uint32_t version, writer& sink) const
     sink.write_string(reserved);
 }
 
+void alert_payload::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void alert_payload::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t alert_payload::serialized_size(uint32_t version) const
 {
     uint64_t size = 40 + variable_uint_size(comment.size()) + comment.size() +
@@ -76,7 +76,7 @@ block_message::block_message(const block_message& other)
 }
 
 block_message::block_message(const chain::header& header,
-    const chain::transaction::list& transactions)
+    const chain::transaction::const_ptr_list& transactions)
   : block(header, transactions), originator_(0)
 {
 }
@@ -88,22 +88,21 @@ block_message::block_message(block&& other)
 
 block_message::block_message(block_message&& other)
   : block_message(std::forward<chain::header>(other.header),
-        std::forward<chain::transaction::list>(other.transactions))
+        std::forward<chain::transaction::const_ptr_list>(other.transactions))
 {
 }
 
 block_message::block_message(chain::header&& header,
-    chain::transaction::list&& transactions)
+    chain::transaction::const_ptr_list&& transactions)
   : block(std::forward<chain::header>(header),
-        std::forward<chain::transaction::list>(transactions)),
+        std::forward<chain::transaction::const_ptr_list>(transactions)),
     originator_(0)
 {
 }
 
 block_message& block_message::operator=(block_message&& other)
 {
-    header = std::move(other.header);
-    transactions = std::move(other.transactions);
+    block::operator=(std::move(other));
     originator_ = other.originator_;
     return *this;
 }
@@ -129,6 +128,13 @@ bool block_message::from_data(uint32_t version, reader& source,
     return block::from_data(source, with_transaction_count);
 }
 
+bool block_message::from_data(uint32_t version, data_reader& source,
+    bool with_transaction_count)
+{
+    originator_ = version;
+    return block::from_data(source, with_transaction_count);
+}
+
 data_chunk block_message::to_data(uint32_t version,
     bool with_transaction_count) const
 {
@@ -147,12 +153,24 @@ void block_message::to_data(uint32_t version, writer& sink,
     block::to_data(sink, with_transaction_count);
 }
 
+void block_message::to_data(uint32_t version, data_writer& sink,
+    bool with_transaction_count) const
+{
+    block::to_data(sink, with_transaction_count);
+}
+
 uint64_t block_message::serialized_size(uint32_t version,
     bool with_transaction_count) const
 {
     return block::serialized_size(with_transaction_count);
 }
 
+void block_message::clear()
+{
+    block::clear();
+    originator_ = 0;
+}
+
 uint64_t block_message::originator() const
 {
     return originator_;
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/block_reconstructor.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/message/compact_block.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+using namespace bc::chain;
+
+block_reconstructor::block_reconstructor()
+  : missing_(0)
+{
+}
+
+code block_reconstructor::load(const compact_block& block)
+{
+    header_ = block.header;
+    key_ = compact_block::short_id_key(block.header, block.nonce);
+    missing_ = block.short_ids.size();
+    index_.clear();
+
+    const auto count = block.short_ids.size() + block.transactions.size();
+    slots_.assign(count, nullptr);
+    ambiguous_.assign(count, false);
+
+    // Prefilled indexes are differentially encoded.
+    size_t next = 0;
+
+    for (const auto& prefilled: block.transactions)
+    {
+        if (prefilled.index >= count - next || !prefilled.transaction)
+            return fail(error::bad_stream);
+
+        const auto slot = next + static_cast<size_t>(prefilled.index);
+        slots_[slot] = prefilled.transaction;
+
+        next = slot + 1;
+    }
+
+    // Short ids take the remaining slots in order.
+    auto id = block.short_ids.begin();
+    index_.reserve(block.short_ids.size());
+
+    for (size_t slot = 0; slot < count; ++slot)
+    {
+        if (slots_[slot])
+            continue;
+
+        BITCOIN_ASSERT(id != block.short_ids.end());
+        const auto value = compact_block::from_short_id(*id++);
+
+        if (!index_.emplace(value, slot).second)
+            return fail(error::duplicate);
+    }
+
+    return error::success;
+}
+
+// Clear the partial load, so that nothing can be filled or reconstructed.
+code block_reconstructor::fail(const code& ec)
+{
+    slots_.clear();
+    ambiguous_.clear();
+    index_.clear();
+    missing_ = 0;
+    return ec;
+}
+
+bool block_reconstructor::fill(transaction::const_ptr tx)
+{
+    const auto value = compact_block::short_id_value(key_, tx->hash());
+    const auto it = index_.find(value);
+    return it != index_.end() && place(it->second, tx);
+}
+
+size_t block_reconstructor::fill(const transaction::const_ptr_list& pool)
+{
+    size_t placed = 0;
+
+    for (const auto& tx: pool)
+        if (fill(tx))
+            ++placed;
+
+    return placed;
+}
+
+bool block_reconstructor::place(size_t slot, transaction::const_ptr tx)
+{
+    if (ambiguous_[slot])
+        return false;
+
+    auto& placed = slots_[slot];
+
+    if (!placed)
+    {
+        placed = tx;
+        --missing_;
+        return true;
+    }
+
+    if (placed->hash() == tx->hash())
+        return false;
+
+    // Two candidates share the short id, so neither can be trusted.
+    placed.reset();
+    ambiguous_[slot] = true;
+    ++missing_;
+    return false;
+}
+
+code block_reconstructor::fill(const block_transactions& response)
+{
+    if (response.block_hash != header_.hash() ||
+        response.transactions.size() != missing_)
+        return error::bad_stream;
+
+    auto tx = response.transactions.begin();
+
+    for (auto& slot: slots_)
+        if (!slot)
+            slot = *tx++;
+
+    missing_ = 0;
+    return error::success;
+}
+
+bool block_reconstructor::complete() const
+{
+    return !slots_.empty() && missing_ == 0;
+}
+
+size_t block_reconstructor::missing() const
+{
+    return missing_;
+}
+
+get_block_transactions block_reconstructor::request() const
+{
+    get_block_transactions request;
+    request.block_hash = header_.hash();
+    request.indexes.reserve(missing_);
+
+    // Indexes are differentially encoded.
+    size_t next = 0;
+
+    for (size_t slot = 0; slot < slots_.size(); ++slot)
+    {
+        if (slots_[slot])
+            continue;
+
+        request.indexes.push_back(slot - next);
+        next = slot + 1;
+    }
+
+    return request;
+}
+
+code block_reconstructor::reconstruct(block& out) const
+{
+    if (!complete())
+        return error::not_found;
+
+    if (block::generate_merkle_root(slots_) != header_.merkle)
+        return error::merkle_mismatch;
+
+    out.header = header_;
+    out.header.transaction_count = slots_.size();
+    out.transactions = slots_;
+    out.invalidate_cache();
+    return error::success;
+}
+
+} // namspace message
+} // namspace libbitcoin
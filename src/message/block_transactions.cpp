@@ -19,10 +19,18 @@
  */
 #include <bitcoin/bitcoin/message/block_transactions.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -72,8 +80,8 @@ void block_transactions::reset()
 bool block_transactions::from_data(uint32_t version,
     const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool block_transactions::from_data(uint32_t version,
@@ -83,7 +91,8 @@ bool block_transactions::from_data(uint32_t version,
     return from_data(version, source);
 }
 
-bool block_transactions::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool block_transactions::read(uint32_t version, Source& source)
 {
     reset();
     auto result = !(version < block_transactions::version_minimum);
@@ -94,14 +103,16 @@ bool block_transactions::from_data(uint32_t version, reader& source)
 
     if (result)
     {
-        transactions.resize(count);
+        const auto available = std::min(source.remaining(),
+            heading::maximum_payload_size(version));
+        bounded_reserve(transactions, count, available,
+            min_transaction_size);
 
-        for (auto& transaction: transactions)
+        for (uint64_t index = 0; index < count && result; ++index)
         {
-            result = transaction.from_data(source);
-
-            if (!result)
-                break;
+            const auto tx = std::make_shared<chain::transaction>();
+            result = tx->from_data(source);
+            transactions.push_back(tx);
         }
     }
 
@@ -111,14 +122,22 @@ bool block_transactions::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool block_transactions::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool block_transactions::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk block_transactions::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void block_transactions::to_data(uint32_t version,
@@ -128,13 +147,24 @@ void block_transactions::to_data(uint32_t version,
     to_data(version, sink);
 }
 
-void block_transactions::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void block_transactions::write(uint32_t version, Sink& sink) const
 {
     sink.write_hash(block_hash);
     sink.write_variable_uint_little_endian(transactions.size());
 
     for (const auto& element: transactions)
-        element.to_data(sink);
+        element->to_data(sink);
+}
+
+void block_transactions::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void block_transactions::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
 }
 
 uint64_t block_transactions::serialized_size(uint32_t version) const
@@ -142,7 +172,7 @@ uint64_t block_transactions::serialized_size(uint32_t version) const
     uint64_t size = hash_size + variable_uint_size(transactions.size());
 
     for (const auto& element: transactions)
-        size += element.serialized_size();
+        size += element->serialized_size();
 
     return size;
 }
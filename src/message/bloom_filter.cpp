@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/bloom_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/script/operation.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+using namespace bc::chain;
+
+const size_t bloom_filter::max_filter_size = 36000;
+const size_t bloom_filter::max_element_size = 520;
+const uint32_t bloom_filter::max_hash_functions = 50;
+
+// The multiplier of the hash function number in the murmur3 seed.
+static constexpr uint32_t seed_multiplier = 0xfba4c795;
+
+bloom_filter::bloom_filter()
+  : hash_functions_(0), tweak_(0), flags_(update::none), loaded_(false),
+    full_(false), empty_(true)
+{
+}
+
+code bloom_filter::load(const filter_load& message)
+{
+    if (message.filter.size() > max_filter_size ||
+        message.hash_functions > max_hash_functions)
+        return error::size_limits;
+
+    data_ = message.filter;
+    hash_functions_ = message.hash_functions;
+    tweak_ = message.tweak;
+    flags_ = message.flags;
+    loaded_ = true;
+    refresh();
+    return error::success;
+}
+
+code bloom_filter::add(const filter_add& message)
+{
+    if (message.data.size() > max_element_size)
+        return error::size_limits;
+
+    if (!loaded_)
+        return error::not_found;
+
+    insert(message.data);
+    return error::success;
+}
+
+void bloom_filter::clear()
+{
+    data_.clear();
+    hash_functions_ = 0;
+    tweak_ = 0;
+    flags_ = update::none;
+    loaded_ = false;
+    refresh();
+}
+
+// Full and empty filters are matched without hashing.
+void bloom_filter::refresh()
+{
+    const auto is_full = [](uint8_t byte) { return byte == 0xff; };
+    const auto is_empty = [](uint8_t byte) { return byte == 0x00; };
+    full_ = std::all_of(data_.begin(), data_.end(), is_full);
+    empty_ = std::all_of(data_.begin(), data_.end(), is_empty);
+}
+
+bool bloom_filter::is_loaded() const
+{
+    return loaded_;
+}
+
+const data_chunk& bloom_filter::data() const
+{
+    return data_;
+}
+
+uint32_t bloom_filter::bit(uint32_t function, data_slice element) const
+{
+    const auto seed = function * seed_multiplier + tweak_;
+    const auto bits = static_cast<uint32_t>(data_.size() * 8);
+    return murmur3(element, seed) % bits;
+}
+
+void bloom_filter::insert(data_slice element)
+{
+    if (full_ || data_.empty())
+        return;
+
+    for (uint32_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto index = bit(function, element);
+        data_[index >> 3] |= (1 << (index & 7));
+    }
+
+    empty_ = false;
+}
+
+bool bloom_filter::contains(data_slice element) const
+{
+    if (full_)
+        return true;
+
+    if (empty_)
+        return false;
+
+    for (uint32_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto index = bit(function, element);
+
+        if ((data_[index >> 3] & (1 << (index & 7))) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+bloom_filter::outpoint bloom_filter::to_outpoint(const hash_digest& hash,
+    uint32_t index)
+{
+    outpoint point;
+    const auto position = std::copy(hash.begin(), hash.end(), point.begin());
+    const auto bytes = to_little_endian(index);
+    std::copy(bytes.begin(), bytes.end(), position);
+    return point;
+}
+
+bool bloom_filter::contains_push(const script& script) const
+{
+    const auto contained = [this](const operation& op)
+    {
+        return !op.data.empty() && contains(op.data);
+    };
+
+    return std::any_of(script.operations.begin(), script.operations.end(),
+        contained);
+}
+
+bool bloom_filter::is_update(const script& script) const
+{
+    switch (flags_ & 0x03)
+    {
+        case update::all:
+            return true;
+        case update::pay_public_key_only:
+            return operation::is_pay_public_key_pattern(script.operations) ||
+                operation::is_pay_multisig_pattern(script.operations);
+        default:
+            return false;
+    }
+}
+
+bool bloom_filter::match(const transaction& tx)
+{
+    if (!loaded_ || full_)
+        return true;
+
+    if (empty_)
+        return false;
+
+    const auto hash = tx.hash();
+    auto matched = contains(hash);
+
+    // Each output is tested, as every matched output may be inserted.
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        const auto& script = tx.outputs[index].script;
+
+        if (!contains_push(script))
+            continue;
+
+        matched = true;
+
+        if (is_update(script))
+            insert(to_outpoint(hash, index));
+    }
+
+    if (matched)
+        return true;
+
+    for (const auto& input: tx.inputs)
+    {
+        const auto& prevout = input.previous_output;
+
+        if (contains(to_outpoint(prevout.hash, prevout.index)) ||
+            contains_push(input.script))
+            return true;
+    }
+
+    return false;
+}
+
+// Builds the partial merkle tree of bip37 over the stored tree levels.
+merkle_block bloom_filter::match(const block& block,
+    transaction::indexes& matched)
+{
+    const auto count = block.transactions.size();
+    std::vector<bool> matches(count);
+    matched.clear();
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        matches[index] = match(*block.transactions[index]);
+
+        if (matches[index])
+            matched.push_back(index);
+    }
+
+    merkle_block result;
+    result.header = block.header;
+    result.header.transaction_count = count;
+
+    if (count == 0)
+        return result;
+
+    // Store each level of the merkle tree, with the leaves at level zero.
+    std::vector<hash_list> levels(1);
+    levels.front().reserve(count);
+
+    for (const auto& tx: block.transactions)
+        levels.front().push_back(tx->hash());
+
+    while (levels.back().size() > 1)
+    {
+        const auto& below = levels.back();
+        hash_list level;
+        level.reserve((below.size() + 1) / 2);
+
+        for (size_t index = 0; index < below.size(); index += 2)
+        {
+            const auto& left = below[index];
+            const auto& right = index + 1 < below.size() ? below[index + 1] :
+                left;
+
+            byte_array<2 * hash_size> pair;
+            std::copy(left.begin(), left.end(), pair.begin());
+            std::copy(right.begin(), right.end(), pair.begin() + hash_size);
+            level.push_back(bitcoin_hash(pair));
+        }
+
+        levels.push_back(std::move(level));
+    }
+
+    // A node is a parent of a match if any leaf beneath it matches.
+    std::vector<std::vector<bool>> parents(levels.size());
+    parents.front() = matches;
+
+    for (size_t height = 1; height < levels.size(); ++height)
+    {
+        const auto& below = parents[height - 1];
+        auto& level = parents[height];
+        level.resize(levels[height].size());
+
+        for (size_t index = 0; index < below.size(); ++index)
+            if (below[index])
+                level[index / 2] = true;
+    }
+
+    // Depth first traversal from the root, emitting flag bits and hashes.
+    std::vector<bool> bits;
+    std::vector<std::pair<size_t, size_t>> stack{ { levels.size() - 1, 0 } };
+
+    while (!stack.empty())
+    {
+        const auto node = stack.back();
+        stack.pop_back();
+
+        const auto height = node.first;
+        const auto position = node.second;
+        const auto parent = parents[height][position];
+        bits.push_back(parent);
+
+        if (height == 0 || !parent)
+        {
+            result.hashes.push_back(levels[height][position]);
+            continue;
+        }
+
+        // Push the right child first, so the left is traversed first.
+        const auto left = 2 * position;
+
+        if (left + 1 < levels[height - 1].size())
+            stack.push_back({ height - 1, left + 1 });
+
+        stack.push_back({ height - 1, left });
+    }
+
+    result.flags.resize((bits.size() + 7) / 8, 0x00);
+
+    for (size_t index = 0; index < bits.size(); ++index)
+        if (bits[index])
+            result.flags[index / 8] |= (1 << (index % 8));
+
+    return result;
+}
+
+} // namspace message
+} // namspace libbitcoin
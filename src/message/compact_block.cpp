@@ -19,11 +19,23 @@
  */
 #include <bitcoin/bitcoin/message/compact_block.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <initializer_list>
+#include <tuple>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -58,6 +70,68 @@ compact_block compact_block::factory_from_data(uint32_t version,
     return instance;
 }
 
+compact_block compact_block::factory_from_block(const chain::block& block,
+    uint64_t nonce)
+{
+    compact_block instance;
+    instance.header = block.header;
+    instance.nonce = nonce;
+
+    if (block.transactions.empty())
+        return instance;
+
+    // The coinbase cannot be in a pool, so it is always prefilled.
+    instance.transactions.push_back({ 0, block.transactions.front() });
+
+    const auto key = short_id_key(block.header, nonce);
+    instance.short_ids.reserve(block.transactions.size() - 1);
+
+    for (auto tx = block.transactions.begin() + 1;
+        tx != block.transactions.end(); ++tx)
+        instance.short_ids.push_back(
+            to_short_id(short_id_value(key, (*tx)->hash())));
+
+    return instance;
+}
+
+half_hash compact_block::short_id_key(const chain::header& header,
+    uint64_t nonce)
+{
+    auto data = header.to_data(false);
+    extend_data(data, to_little_endian(nonce));
+    const auto hash = sha256_hash(data);
+
+    half_hash key;
+    std::copy(hash.begin(), hash.begin() + key.size(), key.begin());
+    return key;
+}
+
+uint64_t compact_block::short_id_value(const half_hash& key,
+    const hash_digest& hash)
+{
+    static constexpr uint64_t mask = (uint64_t(1) << (8 * mini_hash_size)) - 1;
+    return siphash(key, hash) & mask;
+}
+
+compact_block::short_id compact_block::to_short_id(uint64_t value)
+{
+    const auto bytes = to_little_endian(value);
+
+    short_id id;
+    std::copy(bytes.begin(), bytes.begin() + id.size(), id.begin());
+    return id;
+}
+
+uint64_t compact_block::from_short_id(const short_id& id)
+{
+    uint64_t value = 0;
+
+    for (size_t byte = 0; byte < id.size(); ++byte)
+        value |= static_cast<uint64_t>(id[byte]) << (8 * byte);
+
+    return value;
+}
+
 bool compact_block::is_valid() const
 {
     return header.is_valid() && !short_ids.empty() && !transactions.empty();
@@ -75,8 +149,8 @@ void compact_block::reset()
 
 bool compact_block::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool compact_block::from_data(uint32_t version, std::istream& stream)
@@ -85,7 +159,8 @@ bool compact_block::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool compact_block::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool compact_block::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -95,8 +170,12 @@ bool compact_block::from_data(uint32_t version, reader& source)
     const auto short_ids_count = source.read_variable_uint_little_endian();
     result &= static_cast<bool>(source);
 
+    const auto available = std::min(source.remaining(),
+        heading::maximum_payload_size(version));
+
     if (result)
-        short_ids.reserve(short_ids_count);
+        bounded_reserve(short_ids, short_ids_count, available,
+            std::tuple_size<mini_hash>::value);
 
     for (uint64_t i = 0; (i < short_ids_count) && result; ++i)
     {
@@ -109,14 +188,14 @@ bool compact_block::from_data(uint32_t version, reader& source)
 
     if (result)
     {
-        transactions.resize(transaction_count);
+        // A prefilled transaction is a differential index and transaction.
+        bounded_reserve(transactions, transaction_count, available,
+            1 + min_transaction_size);
 
-        for (auto& transaction: transactions)
+        for (uint64_t index = 0; index < transaction_count && result; ++index)
         {
-            result = transaction.from_data(version, source);
-
-            if (!result)
-                break;
+            transactions.emplace_back();
+            result = transactions.back().from_data(version, source);
         }
     }
 
@@ -126,14 +205,22 @@ bool compact_block::from_data(uint32_t version, reader& source)
     return result && !insufficient_version;
 }
 
+bool compact_block::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool compact_block::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk compact_block::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void compact_block::to_data(uint32_t version, std::ostream& stream) const
@@ -142,7 +229,8 @@ void compact_block::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void compact_block::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void compact_block::write(uint32_t version, Sink& sink) const
 {
     header.to_data(sink, false);
     sink.write_8_bytes_little_endian(nonce);
@@ -155,6 +243,16 @@ void compact_block::to_data(uint32_t version, writer& sink) const
         element.to_data(version, sink);
 }
 
+void compact_block::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void compact_block::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t compact_block::serialized_size(uint32_t version) const
 {
     uint64_t size = chain::header::satoshi_fixed_size_without_transaction_count() +
@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -71,8 +73,8 @@ fee_filter::fee_filter(uint64_t minimum)
 
 bool fee_filter::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool fee_filter::from_data(uint32_t version, std::istream& stream)
@@ -81,7 +83,8 @@ bool fee_filter::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool fee_filter::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool fee_filter::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -95,14 +98,22 @@ bool fee_filter::from_data(uint32_t version, reader& source)
     return valid_;
 }
 
+bool fee_filter::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool fee_filter::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk fee_filter::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void fee_filter::to_data(uint32_t version, std::ostream& stream) const
@@ -111,11 +122,22 @@ void fee_filter::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void fee_filter::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void fee_filter::write(uint32_t version, Sink& sink) const
 {
     sink.write_8_bytes_little_endian(minimum_fee);
 }
 
+void fee_filter::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void fee_filter::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 bool fee_filter::is_valid() const
 {
     return valid_;
@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -74,8 +76,8 @@ void filter_clear::reset()
 
 bool filter_clear::from_data(uint32_t version, const data_chunk& data)
 {
-    boost::iostreams::stream<byte_source<data_chunk>> istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool filter_clear::from_data(uint32_t version, std::istream& stream)
@@ -84,21 +86,30 @@ bool filter_clear::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool filter_clear::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool filter_clear::read(uint32_t version, Source& source)
 {
     reset();
     insufficient_version_ = (version < filter_clear::version_minimum);
     return !insufficient_version_;
 }
 
+bool filter_clear::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool filter_clear::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk filter_clear::to_data(uint32_t version) const
 {
-    data_chunk data;
-    boost::iostreams::stream<byte_sink<data_chunk>> ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void filter_clear::to_data(uint32_t version, std::ostream& stream) const
@@ -107,7 +118,8 @@ void filter_clear::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void filter_clear::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void filter_clear::write(uint32_t version, Sink& sink) const
 {
 }
 
@@ -116,6 +128,16 @@ uint64_t filter_clear::serialized_size(uint32_t version) const
     return filter_clear::satoshi_fixed_size(version);
 }
 
+void filter_clear::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void filter_clear::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t filter_clear::satoshi_fixed_size(uint32_t version)
 {
     return 0;
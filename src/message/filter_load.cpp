@@ -24,6 +24,8 @@
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -77,8 +79,8 @@ void filter_load::reset()
 
 bool filter_load::from_data(uint32_t version, const data_chunk& data)
 {
-    boost::iostreams::stream<byte_source<data_chunk>> istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool filter_load::from_data(uint32_t version, std::istream& stream)
@@ -87,7 +89,8 @@ bool filter_load::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool filter_load::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool filter_load::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -112,14 +115,22 @@ bool filter_load::from_data(uint32_t version, reader& source)
     return result && !insufficent_version;
 }
 
+bool filter_load::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool filter_load::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk filter_load::to_data(uint32_t version) const
 {
-    data_chunk data;
-    boost::iostreams::stream<byte_sink<data_chunk>> ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void filter_load::to_data(uint32_t version, std::ostream& stream) const
@@ -128,7 +139,8 @@ void filter_load::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void filter_load::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void filter_load::write(uint32_t version, Sink& sink) const
 {
     sink.write_variable_uint_little_endian(filter.size());
     sink.write_data(filter);
@@ -137,6 +149,16 @@ void filter_load::to_data(uint32_t version, writer& sink) const
     sink.write_byte(flags);
 }
 
+void filter_load::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void filter_load::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t filter_load::serialized_size(uint32_t version) const
 {
     return 1 + 4 + 4 + variable_uint_size(filter.size()) + filter.size();
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/frame.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
+#include <bitcoin/bitcoin/message/registry.hpp>
+#include <bitcoin/bitcoin/message/transaction_message.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+// A command is printable ascii, zero padded to the command size.
+static bool is_valid_command(const byte_array<command_size>& command)
+{
+    const auto end = std::find(command.begin(), command.end(), 0x00);
+
+    const auto printable = [](uint8_t character)
+    {
+        return character >= 0x20 && character <= 0x7e;
+    };
+
+    const auto padding = [](uint8_t character)
+    {
+        return character == 0x00;
+    };
+
+    return end != command.begin() &&
+        std::all_of(command.begin(), end, printable) &&
+        std::all_of(end, command.end(), padding);
+}
+
+frame::frame(uint32_t magic)
+  : magic_(magic)
+{
+    reset();
+}
+
+void frame::reset()
+{
+    type_ = message_type::unknown;
+    heading_ = false;
+    complete_ = false;
+    command_.fill(0x00);
+    payload_size_ = 0;
+    checksum_ = 0;
+    payload_ = nullptr;
+    payload_hash_ = null_hash;
+}
+
+code frame::decode(uint32_t version, data_slice buffer)
+{
+    code ec(error::success);
+
+    if (!heading_ && !decode_heading(version, buffer, ec))
+        return ec;
+
+    if (complete_ || buffer.size() < size())
+        return error::success;
+
+    const auto payload = buffer.begin() + heading::serialized_size();
+    const auto end = payload + payload_size_;
+    payload_hash_ = bitcoin_hash(data_slice(payload, end));
+
+    if (from_little_endian_unsafe<uint32_t>(payload_hash_.begin()) !=
+        checksum_)
+    {
+        reset();
+        return error::bad_stream;
+    }
+
+    payload_ = payload;
+    complete_ = true;
+    return error::success;
+}
+
+// Returns false if the heading is incomplete or invalid (with ec set).
+bool frame::decode_heading(uint32_t version, data_slice buffer, code& ec)
+{
+    if (buffer.size() < heading::serialized_size())
+        return false;
+
+    data_reader source(buffer);
+    const auto magic = source.read_4_bytes_little_endian();
+    source.read_data(command_.data(), command_.size());
+    payload_size_ = source.read_4_bytes_little_endian();
+    checksum_ = source.read_4_bytes_little_endian();
+    BITCOIN_ASSERT(source);
+
+    if (magic != magic_ || !is_valid_command(command_))
+    {
+        reset();
+        ec = error::bad_stream;
+        return false;
+    }
+
+    type_ = registry::type(command_);
+
+    if (payload_size_ > registry::maximum_payload_size(type_, version))
+    {
+        reset();
+        ec = error::size_limits;
+        return false;
+    }
+
+    heading_ = true;
+    return true;
+}
+
+// Compares the zero padded command bytes without constructing a string.
+bool frame::is_command(const std::string& command) const
+{
+    const auto size = command.size();
+
+    return size <= command_size &&
+        std::memcmp(command_.data(), command.data(), size) == 0 &&
+        (size == command_size || command_[size] == 0x00);
+}
+
+bool frame::complete() const
+{
+    return complete_;
+}
+
+size_t frame::size() const
+{
+    return heading::serialized_size() + payload_size_;
+}
+
+message_type frame::type() const
+{
+    return type_;
+}
+
+std::string frame::command() const
+{
+    const auto end = std::find(command_.begin(), command_.end(), 0x00);
+    return std::string(command_.begin(), end);
+}
+
+data_slice frame::payload() const
+{
+    return complete_ ? data_slice(payload_, payload_ + payload_size_) :
+        data_slice(payload_, payload_);
+}
+
+const hash_digest& frame::payload_hash() const
+{
+    return payload_hash_;
+}
+
+bool frame::parse(uint32_t version, transaction_message& instance) const
+{
+    if (!complete_ || type_ != message_type::transaction_message)
+        return false;
+
+    return instance.from_data(version, payload(), payload_hash_);
+}
+
+} // namspace message
+} // namspace libbitcoin
@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -68,8 +70,8 @@ void get_address::reset()
 
 bool get_address::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool get_address::from_data(uint32_t version, std::istream& stream)
@@ -78,20 +80,29 @@ bool get_address::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool get_address::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool get_address::read(uint32_t version, Source& source)
 {
     reset();
     return source;
 }
 
+bool get_address::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool get_address::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk get_address::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void get_address::to_data(uint32_t version, std::ostream& stream) const
@@ -100,7 +111,8 @@ void get_address::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void get_address::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void get_address::write(uint32_t version, Sink& sink) const
 {
 }
 
@@ -109,6 +121,16 @@ uint64_t get_address::serialized_size(uint32_t version) const
     return get_address::satoshi_fixed_size(version);
 }
 
+void get_address::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void get_address::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t get_address::satoshi_fixed_size(uint32_t version)
 {
     return 0;
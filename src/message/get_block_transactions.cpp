@@ -19,11 +19,17 @@
  */
 #include <bitcoin/bitcoin/message/get_block_transactions.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <initializer_list>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -73,8 +79,8 @@ void get_block_transactions::reset()
 bool get_block_transactions::from_data(uint32_t version,
     const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool get_block_transactions::from_data(uint32_t version,
@@ -84,8 +90,8 @@ bool get_block_transactions::from_data(uint32_t version,
     return from_data(version, source);
 }
 
-bool get_block_transactions::from_data(uint32_t version,
-    reader& source)
+template <typename Source>
+bool get_block_transactions::read(uint32_t version, Source& source)
 {
     reset();
     block_hash = source.read_hash();
@@ -95,7 +101,8 @@ bool get_block_transactions::from_data(uint32_t version,
     result &= static_cast<bool>(source);
 
     if (result)
-        indexes.reserve(count);
+        bounded_reserve(indexes, count, std::min(source.remaining(),
+            heading::maximum_payload_size(version)), 1);
 
     for (uint64_t i = 0; (i < count) && result; ++i)
     {
@@ -109,14 +116,22 @@ bool get_block_transactions::from_data(uint32_t version,
     return result;
 }
 
+bool get_block_transactions::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool get_block_transactions::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk get_block_transactions::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void get_block_transactions::to_data(uint32_t version,
@@ -126,8 +141,8 @@ void get_block_transactions::to_data(uint32_t version,
     to_data(version, sink);
 }
 
-void get_block_transactions::to_data(uint32_t version,
-    writer& sink) const
+template <typename Sink>
+void get_block_transactions::write(uint32_t version, Sink& sink) const
 {
     sink.write_hash(block_hash);
     sink.write_variable_uint_little_endian(indexes.size());
@@ -135,6 +150,16 @@ void get_block_transactions::to_data(uint32_t version,
         sink.write_variable_uint_little_endian(element);
 }
 
+void get_block_transactions::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void get_block_transactions::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t get_block_transactions::serialized_size(uint32_t version) const
 {
     uint64_t size = hash_size + variable_uint_size(indexes.size());
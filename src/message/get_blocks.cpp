@@ -19,10 +19,16 @@
  */
 #include <bitcoin/bitcoin/message/get_blocks.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -87,8 +93,8 @@ void get_blocks::reset()
 
 bool get_blocks::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool get_blocks::from_data(uint32_t version, std::istream& stream)
@@ -97,7 +103,8 @@ bool get_blocks::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool get_blocks::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool get_blocks::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -105,7 +112,8 @@ bool get_blocks::from_data(uint32_t version, reader& source)
     source.read_4_bytes_little_endian();
 
     const auto count = source.read_variable_uint_little_endian();
-    start_hashes.reserve(count);
+    bounded_reserve(start_hashes, count, std::min(source.remaining(),
+        heading::maximum_payload_size(version)), hash_size);
 
     for (uint64_t i = 0; i < count && source; ++i)
         start_hashes.push_back(source.read_hash());
@@ -118,14 +126,22 @@ bool get_blocks::from_data(uint32_t version, reader& source)
     return source;
 }
 
+bool get_blocks::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool get_blocks::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk get_blocks::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void get_blocks::to_data(uint32_t version, std::ostream& stream) const
@@ -134,7 +150,8 @@ void get_blocks::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void get_blocks::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void get_blocks::write(uint32_t version, Sink& sink) const
 {
     sink.write_4_bytes_little_endian(version);
     sink.write_variable_uint_little_endian(start_hashes.size());
@@ -145,6 +162,16 @@ void get_blocks::to_data(uint32_t version, writer& sink) const
     sink.write_hash(stop_hash);
 }
 
+void get_blocks::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void get_blocks::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t get_blocks::serialized_size(uint32_t version) const
 {
     return 36 + variable_uint_size(start_hashes.size()) +
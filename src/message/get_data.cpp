@@ -85,7 +85,8 @@ bool get_data::from_data(uint32_t version, std::istream& stream)
     return inventory::from_data(version, stream);
 }
 
-bool get_data::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool get_data::read(uint32_t version, Source& source)
 {
     bool result = !(version < get_data::version_minimum);
 
@@ -98,5 +99,15 @@ bool get_data::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool get_data::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool get_data::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 } // namspace message
 } // namspace libbitcoin
@@ -78,7 +78,8 @@ bool get_headers::from_data(uint32_t version, std::istream& stream)
     return get_blocks::from_data(version, stream);
 }
 
-bool get_headers::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool get_headers::read(uint32_t version, Source& source)
 {
     bool result = !(version < version_minimum);
 
@@ -90,5 +91,15 @@ bool get_headers::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool get_headers::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool get_headers::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 } // end message
 } // end libbitcoin
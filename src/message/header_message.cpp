@@ -142,6 +142,13 @@ bool header_message::from_data(const uint32_t version, reader& source,
     return header::from_data(source, with_transaction_count);
 }
 
+bool header_message::from_data(const uint32_t version, data_reader& source,
+    bool with_transaction_count)
+{
+    originator_ = version;
+    return header::from_data(source, with_transaction_count);
+}
+
 data_chunk header_message::to_data(const uint32_t version,
     bool with_transaction_count) const
 {
@@ -160,6 +167,12 @@ void header_message::to_data(const uint32_t version, writer& sink,
     header::to_data(sink, with_transaction_count);
 }
 
+void header_message::to_data(const uint32_t version, data_writer& sink,
+    bool with_transaction_count) const
+{
+    header::to_data(sink, with_transaction_count);
+}
+
 uint64_t header_message::serialized_size(const uint32_t version,
     bool with_transaction_count) const
 {
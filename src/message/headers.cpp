@@ -23,11 +23,15 @@
 #include <cstdint>
 #include <utility>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/inventory.hpp>
 #include <bitcoin/bitcoin/message/inventory_vector.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -87,10 +91,15 @@ void headers::reset()
     elements.shrink_to_fit();
 }
 
+void headers::clear()
+{
+    elements.clear();
+}
+
 bool headers::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool headers::from_data(uint32_t version, std::istream& stream)
@@ -99,9 +108,10 @@ bool headers::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool headers::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool headers::read(uint32_t version, Source& source)
 {
-    reset();
+    clear();
 
     auto result = !(version < version_minimum);
     const auto count = source.read_variable_uint_little_endian();
@@ -109,14 +119,16 @@ bool headers::from_data(uint32_t version, reader& source)
 
     if (result)
     {
-        elements.resize(count);
+        // Each header is followed by a (zero) transaction count.
+        const auto available = std::min(source.remaining(),
+            heading::maximum_payload_size(version));
+        bounded_reserve(elements, count, available,
+            chain::header::satoshi_fixed_size_without_transaction_count() + 1);
 
-        for (auto& element: elements)
+        for (uint64_t index = 0; index < count && result; ++index)
         {
-            result = element.from_data(source, true);
-
-            if (!result)
-                break;
+            elements.emplace_back();
+            result = elements.back().from_data(source, true);
         }
     }
 
@@ -126,14 +138,22 @@ bool headers::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool headers::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool headers::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk headers::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void headers::to_data(uint32_t version, std::ostream& stream) const
@@ -142,7 +162,8 @@ void headers::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void headers::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void headers::write(uint32_t version, Sink& sink) const
 {
     sink.write_variable_uint_little_endian(elements.size());
 
@@ -150,6 +171,16 @@ void headers::to_data(uint32_t version, writer& sink) const
         element.to_data(sink, true);
 }
 
+void headers::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void headers::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 void headers::to_hashes(hash_list& out) const
 {
     const auto map = [](const chain::header& header)
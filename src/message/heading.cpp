@@ -21,9 +21,12 @@
 
 #include <boost/iostreams/stream.hpp>
 #include <bitcoin/bitcoin/messages.hpp>
+#include <bitcoin/bitcoin/message/registry.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -96,8 +99,8 @@ void heading::reset()
 
 bool heading::from_data(const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(istream);
+    data_reader source(data);
+    return from_data(source);
 }
 
 bool heading::from_data(std::istream& stream)
@@ -106,7 +109,8 @@ bool heading::from_data(std::istream& stream)
     return from_data(source);
 }
 
-bool heading::from_data(reader& source)
+template <typename Source>
+bool heading::read(Source& source)
 {
     reset();
     magic = source.read_4_bytes_little_endian();
@@ -120,14 +124,22 @@ bool heading::from_data(reader& source)
     return source;
 }
 
+bool heading::from_data(reader& source)
+{
+    return read(source);
+}
+
+bool heading::from_data(data_reader& source)
+{
+    return read(source);
+}
+
 data_chunk heading::to_data() const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == heading::serialized_size());
-    return data;
+    return write_chunk(heading::serialized_size(), [&](data_writer& sink)
+    {
+        to_data(sink);
+    });
 }
 
 void heading::to_data(std::ostream& stream) const
@@ -136,7 +148,8 @@ void heading::to_data(std::ostream& stream) const
     to_data(sink);
 }
 
-void heading::to_data(writer& sink) const
+template <typename Sink>
+void heading::write(Sink& sink) const
 {
     sink.write_4_bytes_little_endian(magic);
     sink.write_fixed_string(command, command_size);
@@ -144,63 +157,19 @@ void heading::to_data(writer& sink) const
     sink.write_4_bytes_little_endian(checksum);
 }
 
+void heading::to_data(writer& sink) const
+{
+    write(sink);
+}
+
+void heading::to_data(data_writer& sink) const
+{
+    write(sink);
+}
+
 message_type heading::type() const
 {
-    // TODO: convert to static map.
-    if (command == address::command)
-        return message_type::address;
-    if (command == alert::command)
-        return message_type::alert;
-    if (command == block_transactions::command)
-        return message_type::block_transactions;
-    if (command == block_message::command)
-        return message_type::block_message;
-    if (command == compact_block::command)
-        return message_type::compact_block;
-    if (command == filter_add::command)
-        return message_type::filter_add;
-    if (command == filter_clear::command)
-        return message_type::filter_clear;
-    if (command == filter_load::command)
-        return message_type::filter_load;
-    if (command == get_address::command)
-        return message_type::get_address;
-    if (command == get_block_transactions::command)
-        return message_type::get_block_transactions;
-    if (command == get_blocks::command)
-        return message_type::get_blocks;
-    if (command == get_data::command)
-        return message_type::get_data;
-    if (command == get_headers::command)
-        return message_type::get_headers;
-    if (command == headers::command)
-        return message_type::headers;
-    if (command == inventory::command)
-        return message_type::inventory;
-    if (command == memory_pool::command)
-        return message_type::memory_pool;
-    if (command == merkle_block::command)
-        return message_type::merkle_block;
-    if (command == not_found::command)
-        return message_type::not_found;
-    if (command == ping::command)
-        return message_type::ping;
-    if (command == pong::command)
-        return message_type::pong;
-    if (command == reject::command)
-        return message_type::reject;
-    if (command == send_compact_blocks::command)
-        return message_type::send_compact_blocks;
-    if (command == send_headers::command)
-        return message_type::send_headers;
-    if (command == transaction_message::command)
-        return message_type::transaction_message;
-    if (command == verack::command)
-        return message_type::verack;
-    if (command == version::command)
-        return message_type::version;
-
-    return message_type::unknown;
+    return registry::type(command);
 }
 
 bool operator==(const heading& left, const heading& right)
@@ -20,14 +20,19 @@
 #include <bitcoin/bitcoin/message/inventory.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <initializer_list>
 #include <boost/iostreams/stream.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/inventory.hpp>
 #include <bitcoin/bitcoin/message/inventory_vector.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -98,10 +103,15 @@ void inventory::reset()
     inventories.shrink_to_fit();
 }
 
+void inventory::clear()
+{
+    inventories.clear();
+}
+
 bool inventory::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool inventory::from_data(uint32_t version, std::istream& stream)
@@ -110,22 +120,24 @@ bool inventory::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool inventory::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool inventory::read(uint32_t version, Source& source)
 {
-    reset();
+    clear();
     const auto count = source.read_variable_uint_little_endian();
     auto result = static_cast<bool>(source);
 
     if (result)
     {
-        inventories.resize(count);
+        const auto available = std::min(source.remaining(),
+            heading::maximum_payload_size(version));
+        bounded_reserve(inventories, count, available,
+            inventory_vector::satoshi_fixed_size(version));
 
-        for (auto& inventory: inventories)
+        for (uint64_t index = 0; index < count && result; ++index)
         {
-            result = inventory.from_data(version, source);
-
-            if (!result)
-                break;
+            inventories.emplace_back();
+            result = inventories.back().from_data(version, source);
         }
     }
 
@@ -135,14 +147,22 @@ bool inventory::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool inventory::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool inventory::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk inventory::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void inventory::to_data(uint32_t version, std::ostream& stream) const
@@ -151,7 +171,8 @@ void inventory::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void inventory::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void inventory::write(uint32_t version, Sink& sink) const
 {
     sink.write_variable_uint_little_endian(inventories.size());
 
@@ -159,6 +180,16 @@ void inventory::to_data(uint32_t version, writer& sink) const
         inventory.to_data(version, sink);
 }
 
+void inventory::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void inventory::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 void inventory::to_hashes(hash_list& out, type_id type) const
 {
     out.reserve(inventories.size());
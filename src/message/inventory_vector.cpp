@@ -24,6 +24,8 @@
 #include <bitcoin/bitcoin/message/inventory.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -102,8 +104,8 @@ void inventory_vector::reset()
 bool inventory_vector::from_data(uint32_t version,
     const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool inventory_vector::from_data(uint32_t version,
@@ -113,8 +115,8 @@ bool inventory_vector::from_data(uint32_t version,
     return from_data(version, source);
 }
 
-bool inventory_vector::from_data(uint32_t version,
-    reader& source)
+template <typename Source>
+bool inventory_vector::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -129,14 +131,22 @@ bool inventory_vector::from_data(uint32_t version,
     return result;
 }
 
+bool inventory_vector::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool inventory_vector::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk inventory_vector::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void inventory_vector::to_data(uint32_t version,
@@ -146,14 +156,24 @@ void inventory_vector::to_data(uint32_t version,
     to_data(version, sink);
 }
 
-void inventory_vector::to_data(uint32_t version,
-    writer& sink) const
+template <typename Sink>
+void inventory_vector::write(uint32_t version, Sink& sink) const
 {
     const auto raw_type = inventory_vector::to_number(type);
     sink.write_4_bytes_little_endian(raw_type);
     sink.write_hash(hash);
 }
 
+void inventory_vector::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void inventory_vector::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t inventory_vector::serialized_size(uint32_t version) const
 {
     return inventory_vector::satoshi_fixed_size(version);
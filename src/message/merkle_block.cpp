@@ -19,11 +19,17 @@
  */
 #include <bitcoin/bitcoin/message/merkle_block.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <boost/iostreams/stream.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -74,8 +80,8 @@ void merkle_block::reset()
 
 bool merkle_block::from_data(uint32_t version, const data_chunk& data)
 {
-    boost::iostreams::stream<byte_source<data_chunk>> istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool merkle_block::from_data(uint32_t version, std::istream& stream)
@@ -84,15 +90,21 @@ bool merkle_block::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool merkle_block::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool merkle_block::read(uint32_t version, Source& source)
 {
     reset();
 
     bool result = !(version < merkle_block::version_minimum);
     uint64_t hash_count = 0;
 
+    // The transaction count is a fixed four bytes, unlike in headers.
     if (result)
-        result = header.from_data(source, true);
+    {
+        result = header.from_data(source, false);
+        header.transaction_count = source.read_4_bytes_little_endian();
+        result = result && source;
+    }
 
     if (result)
     {
@@ -101,7 +113,8 @@ bool merkle_block::from_data(uint32_t version, reader& source)
     }
 
     if (result)
-        hashes.reserve(hash_count);
+        bounded_reserve(hashes, hash_count, std::min(source.remaining(),
+            heading::maximum_payload_size(version)), hash_size);
 
     for (uint64_t i = 0; (i < hash_count) && result; ++i)
     {
@@ -124,14 +137,22 @@ bool merkle_block::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool merkle_block::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool merkle_block::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk merkle_block::to_data(uint32_t version) const
 {
-    data_chunk data;
-    boost::iostreams::stream<byte_sink<data_chunk>> ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void merkle_block::to_data(uint32_t version, std::ostream& stream) const
@@ -140,9 +161,12 @@ void merkle_block::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void merkle_block::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void merkle_block::write(uint32_t version, Sink& sink) const
 {
-    header.to_data(sink, true);
+    header.to_data(sink, false);
+    sink.write_4_bytes_little_endian(
+        static_cast<uint32_t>(header.transaction_count));
 
     sink.write_variable_uint_little_endian(hashes.size());
 
@@ -153,9 +177,19 @@ void merkle_block::to_data(uint32_t version, writer& sink) const
     sink.write_data(flags);
 }
 
+void merkle_block::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void merkle_block::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t merkle_block::serialized_size(uint32_t version) const
 {
-    return header.serialized_size(true) +
+    return header.serialized_size(false) + sizeof(uint32_t) +
         variable_uint_size(hashes.size()) + (hash_size * hashes.size()) +
         variable_uint_size(flags.size()) + flags.size();
 }
@@ -22,6 +22,8 @@
 #include <boost/iostreams/stream.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -76,8 +78,8 @@ void network_address::reset()
 bool network_address::from_data(uint32_t version,
     const data_chunk& data, bool with_timestamp)
 {
-    data_source istream(data);
-    return from_data(version, istream, with_timestamp);
+    data_reader source(data);
+    return from_data(version, source, with_timestamp);
 }
 
 bool network_address::from_data(uint32_t version,
@@ -87,8 +89,9 @@ bool network_address::from_data(uint32_t version,
     return from_data(version, source, with_timestamp);
 }
 
-bool network_address::from_data(uint32_t version,
-    reader& source, bool with_timestamp)
+template <typename Source>
+bool network_address::read(uint32_t version, Source& source,
+    bool with_timestamp)
 {
     auto result = false;
 
@@ -108,15 +111,26 @@ bool network_address::from_data(uint32_t version,
     return result;
 }
 
+bool network_address::from_data(uint32_t version,
+    reader& source, bool with_timestamp)
+{
+    return read(version, source, with_timestamp);
+}
+
+bool network_address::from_data(uint32_t version,
+    data_reader& source, bool with_timestamp)
+{
+    return read(version, source, with_timestamp);
+}
+
 data_chunk network_address::to_data(uint32_t version,
     bool with_timestamp) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream, with_timestamp);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version, with_timestamp));
-    return data;
+    const auto size = serialized_size(version, with_timestamp);
+    return write_chunk(size, [&](data_writer& sink)
+    {
+        to_data(version, sink, with_timestamp);
+    });
 }
 
 void network_address::to_data(uint32_t version,
@@ -126,8 +140,9 @@ void network_address::to_data(uint32_t version,
     to_data(version, sink, with_timestamp);
 }
 
-void network_address::to_data(uint32_t version,
-    writer& sink, bool with_timestamp) const
+template <typename Sink>
+void network_address::write(uint32_t version, Sink& sink,
+    bool with_timestamp) const
 {
     if (with_timestamp)
         sink.write_4_bytes_little_endian(timestamp);
@@ -137,6 +152,18 @@ void network_address::to_data(uint32_t version,
     sink.write_2_bytes_big_endian(port);
 }
 
+void network_address::to_data(uint32_t version,
+    writer& sink, bool with_timestamp) const
+{
+    write(version, sink, with_timestamp);
+}
+
+void network_address::to_data(uint32_t version,
+    data_writer& sink, bool with_timestamp) const
+{
+    write(version, sink, with_timestamp);
+}
+
 uint64_t network_address::serialized_size(uint32_t version,
     bool with_timestamp) const
 {
@@ -85,7 +85,8 @@ bool not_found::from_data(uint32_t version, std::istream& stream)
     return inventory::from_data(version, stream);
 }
 
-bool not_found::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool not_found::read(uint32_t version, Source& source)
 {
     bool result = !(version < not_found::version_minimum);
 
@@ -98,5 +99,15 @@ bool not_found::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool not_found::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool not_found::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 } // namspace message
 } // namspace libbitcoin
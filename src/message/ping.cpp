@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -71,8 +73,8 @@ ping::ping(uint64_t nonce)
 
 bool ping::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool ping::from_data(uint32_t version, std::istream& stream)
@@ -81,7 +83,8 @@ bool ping::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool ping::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool ping::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -98,14 +101,22 @@ bool ping::from_data(uint32_t version, reader& source)
     return valid_;
 }
 
+bool ping::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool ping::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk ping::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void ping::to_data(uint32_t version, std::ostream& stream) const
@@ -114,12 +125,23 @@ void ping::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void ping::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void ping::write(uint32_t version, Sink& sink) const
 {
     if (version >= version::level::bip31)
         sink.write_8_bytes_little_endian(nonce);
 }
 
+void ping::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void ping::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 bool ping::is_valid() const
 {
     return valid_;
@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -61,8 +63,8 @@ uint64_t pong::satoshi_fixed_size(uint32_t version)
 
 bool pong::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool pong::from_data(uint32_t version, std::istream& stream)
@@ -71,7 +73,8 @@ bool pong::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool pong::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool pong::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -83,14 +86,22 @@ bool pong::from_data(uint32_t version, reader& source)
     return source;
 }
 
+bool pong::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool pong::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk pong::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void pong::to_data(uint32_t version, std::ostream& stream) const
@@ -99,11 +110,22 @@ void pong::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void pong::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void pong::write(uint32_t version, Sink& sink) const
 {
     sink.write_8_bytes_little_endian(nonce);
 }
 
+void pong::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void pong::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 bool pong::is_valid() const
 {
     return (nonce != 0);
@@ -19,10 +19,14 @@
  */
 #include <bitcoin/bitcoin/message/prefilled_transaction.hpp>
 
+#include <memory>
 #include <boost/iostreams/stream.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -55,20 +59,20 @@ prefilled_transaction prefilled_transaction::factory_from_data(
 
 bool prefilled_transaction::is_valid() const
 {
-    return (index < max_uint16) && transaction.is_valid();
+    return (index < max_uint16) && transaction && transaction->is_valid();
 }
 
 void prefilled_transaction::reset()
 {
     index = 0;
-    transaction.reset();
+    transaction = nullptr;
 }
 
 bool prefilled_transaction::from_data(uint32_t version,
     const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool prefilled_transaction::from_data(uint32_t version,
@@ -78,8 +82,8 @@ bool prefilled_transaction::from_data(uint32_t version,
     return from_data(version, source);
 }
 
-bool prefilled_transaction::from_data(uint32_t version,
-    reader& source)
+template <typename Source>
+bool prefilled_transaction::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -87,7 +91,11 @@ bool prefilled_transaction::from_data(uint32_t version,
     auto result = static_cast<bool>(source);
 
     if (result)
-        result = transaction.from_data(source);
+    {
+        const auto tx = std::make_shared<chain::transaction>();
+        result = tx->from_data(source);
+        transaction = tx;
+    }
 
     if (!result)
         reset();
@@ -95,14 +103,22 @@ bool prefilled_transaction::from_data(uint32_t version,
     return result;
 }
 
+bool prefilled_transaction::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool prefilled_transaction::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk prefilled_transaction::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void prefilled_transaction::to_data(uint32_t version,
@@ -112,16 +128,28 @@ void prefilled_transaction::to_data(uint32_t version,
     to_data(version, sink);
 }
 
-void prefilled_transaction::to_data(uint32_t version,
-    writer& sink) const
+template <typename Sink>
+void prefilled_transaction::write(uint32_t version, Sink& sink) const
 {
+    BITCOIN_ASSERT(transaction);
     sink.write_variable_uint_little_endian(index);
-    transaction.to_data(sink);
+    transaction->to_data(sink);
+}
+
+void prefilled_transaction::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void prefilled_transaction::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
 }
 
 uint64_t prefilled_transaction::serialized_size(uint32_t version) const
 {
-    return variable_uint_size(index) + transaction.serialized_size();
+    BITCOIN_ASSERT(transaction);
+    return variable_uint_size(index) + transaction->serialized_size();
 }
 
 } // namspace message
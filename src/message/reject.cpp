@@ -25,6 +25,8 @@
 #include <bitcoin/bitcoin/message/transaction_message.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -79,8 +81,8 @@ void reject::reset()
 
 bool reject::from_data(uint32_t version, const data_chunk& data)
 {
-    boost::iostreams::stream<byte_source<data_chunk>> istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool reject::from_data(uint32_t version, std::istream& stream)
@@ -89,7 +91,8 @@ bool reject::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool reject::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool reject::read(uint32_t version, Source& source)
 {
     const auto insufficient_version = (version < reject::version_minimum);
 
@@ -114,14 +117,22 @@ bool reject::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool reject::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool reject::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk reject::to_data(uint32_t version) const
 {
-    data_chunk data;
-    boost::iostreams::stream<byte_sink<data_chunk>> ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void reject::to_data(uint32_t version, std::ostream& stream) const
@@ -130,7 +141,8 @@ void reject::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void reject::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void reject::write(uint32_t version, Sink& sink) const
 {
     sink.write_string(message);
     sink.write_byte(error_code_to_byte(code));
@@ -143,6 +155,16 @@ void reject::to_data(uint32_t version, writer& sink) const
     }
 }
 
+void reject::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void reject::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t reject::serialized_size(uint32_t version) const
 {
     uint64_t size = 1 + variable_uint_size(message.size()) + message.size() +
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/relay_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/messages.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+bool relay_cache::key::operator==(const key& other) const
+{
+    return type == other.type && version == other.version &&
+        hash == other.hash;
+}
+
+// The key hash is uniformly distributed, so a word of it suffices.
+size_t relay_cache::key_hash::operator()(const key& value) const
+{
+    const auto word = from_little_endian_unsafe<size_t>(value.hash.begin());
+    return word ^ static_cast<size_t>(value.type) ^
+        (static_cast<size_t>(value.version) << 8);
+}
+
+relay_cache::relay_cache(uint32_t magic, size_t budget)
+  : magic_(magic), budget_(budget), size_(0)
+{
+}
+
+relay_cache::message_ptr relay_cache::get(uint32_t version,
+    const block_message& block)
+{
+    return get(block, { message_type::block_message, version,
+        block.header.hash() });
+}
+
+relay_cache::message_ptr relay_cache::get(uint32_t version,
+    const compact_block& block)
+{
+    return get(block, { message_type::compact_block, version,
+        compact_block_key(block) });
+}
+
+relay_cache::message_ptr relay_cache::get(uint32_t version,
+    const transaction_message& tx)
+{
+    return get(tx, { message_type::transaction_message, version,
+        tx.transaction()->hash() });
+}
+
+relay_cache::message_ptr relay_cache::get(uint32_t version,
+    const headers& headers)
+{
+    return get(headers, { message_type::headers, version,
+        headers_key(headers) });
+}
+
+hash_digest relay_cache::headers_key(const headers& headers)
+{
+    const auto& elements = headers.elements;
+
+    if (elements.empty())
+        return null_hash;
+
+    return bitcoin_hash(build_chunk(
+    {
+        elements.front().hash(), elements.back().hash()
+    }));
+}
+
+hash_digest relay_cache::compact_block_key(const compact_block& block)
+{
+    return bitcoin_hash(build_chunk(
+    {
+        block.header.hash(), to_little_endian(block.nonce)
+    }));
+}
+
+template <typename Message>
+relay_cache::message_ptr relay_cache::get(const Message& packet,
+    const key& id)
+{
+    auto message = find(id.type, id.version, id.hash);
+
+    if (message)
+        return message;
+
+    // Serialize outside of the critical section, a race only costs a copy.
+    message = std::make_shared<const data_chunk>(
+        serialize(id.version, packet, magic_));
+
+    return store(id, message);
+}
+
+relay_cache::message_ptr relay_cache::find(message_type type,
+    uint32_t version, const hash_digest& hash)
+{
+    message_ptr message;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = index_.find({ type, version, hash });
+
+    if (it != index_.end())
+    {
+        // Move the entry to the front, as most recently used.
+        entries_.splice(entries_.begin(), entries_, it->second);
+        message = it->second->second;
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return message;
+}
+
+relay_cache::message_ptr relay_cache::store(const key& id,
+    message_ptr message)
+{
+    // A message larger than the budget is returned but not cached.
+    if (message->size() > budget_)
+        return message;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = index_.find(id);
+
+    if (it != index_.end())
+    {
+        // Another thread cached the message first.
+        message = it->second->second;
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return message;
+    }
+
+    entries_.emplace_front(id, message);
+    index_.emplace(id, entries_.begin());
+    size_ += message->size();
+
+    // Evict least recently used messages until within the budget.
+    while (size_ > budget_)
+        erase(index_.find(entries_.back().first));
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return message;
+}
+
+// Must be called from within the critical section.
+void relay_cache::erase(map::iterator it)
+{
+    BITCOIN_ASSERT(it != index_.end());
+    size_ -= it->second->second->size();
+    entries_.erase(it->second);
+    index_.erase(it);
+}
+
+void relay_cache::remove(message_type type, const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // The versions cached are not indexed, so the entries are scanned.
+    for (auto entry = entries_.begin(); entry != entries_.end();)
+    {
+        const auto& id = (entry++)->first;
+
+        if (id.type == type && id.hash == hash)
+            erase(index_.find(id));
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void relay_cache::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    index_.clear();
+    entries_.clear();
+    size_ = 0;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t relay_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto size = size_;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return size;
+}
+
+size_t relay_cache::count() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto count = index_.size();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return count;
+}
+
+} // namspace message
+} // namspace libbitcoin
@@ -0,0 +1,326 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/rolling_bloom_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/inventory.hpp>
+#include <bitcoin/bitcoin/message/inventory_vector.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/random.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+// A block is one cache line of four pairs of words, each pair holding the
+// low and high generation bits of 64 cells.
+static constexpr size_t block_size = 64;
+static constexpr size_t block_words = block_size / sizeof(uint64_t);
+static constexpr size_t block_cells = block_words / 2 * 64;
+static constexpr size_t max_hash_functions = 50;
+
+static size_t to_hash_functions(double rate)
+{
+    const auto count = std::round(std::log(rate) / std::log(0.5));
+    const auto bounded = std::min(count, double(max_hash_functions));
+    return static_cast<size_t>(std::max(bounded, 1.0));
+}
+
+// Advance the distribution of the set cells of a block by one entry. Each
+// hash function sets a cell, which was already set in proportion to the set
+// cells, so the distribution is updated in place from the fullest block.
+static void add_entry(std::vector<double>& occupancy, size_t hash_functions)
+{
+    const auto cells = static_cast<double>(block_cells);
+
+    for (size_t function = 0; function < hash_functions; ++function)
+    {
+        for (auto set = block_cells; set > 0; --set)
+            occupancy[set] = occupancy[set] * set / cells +
+                occupancy[set - 1] * (block_cells - set + 1) / cells;
+
+        occupancy[0] = 0.0;
+    }
+}
+
+// The false positive rate of a block is the mean over its distribution of
+// set cells. This is computed exactly, as the usual approximation of a mean
+// fill (raised to the hash functions) understates the rate of a block of only
+// 256 cells (Bose et al, "On the false-positive rate of Bloom filters", 2008).
+static double block_rate(const std::vector<double>& occupancy,
+    size_t hash_functions)
+{
+    const auto functions = static_cast<double>(hash_functions);
+    auto rate = 0.0;
+
+    for (size_t set = 1; set <= block_cells; ++set)
+        rate += occupancy[set] * std::pow(double(set) / block_cells,
+            functions);
+
+    return rate;
+}
+
+// The false positive rate of a blocked filter, with the entries distributed
+// over the blocks at random. The entries of the queried block are Poisson
+// distributed, so the rate is the mean of the block rate over that
+// distribution (Putze, Sanders and Singler, "Cache-, Hash- and
+// Space-Efficient Bloom Filters", 2007). Terms beyond twelve deviations of
+// the mean are negligible. Block rates by entries are computed as needed.
+static double blocked_rate(double entries, size_t blocks,
+    size_t hash_functions, std::vector<double>& occupancy,
+    std::vector<double>& rates)
+{
+    const auto load = entries / blocks;
+    const auto last = static_cast<size_t>(load + 12.0 * std::sqrt(load) + 12);
+
+    while (rates.size() <= last)
+    {
+        rates.push_back(block_rate(occupancy, hash_functions));
+        add_entry(occupancy, hash_functions);
+    }
+
+    auto probability = std::exp(-load);
+    auto rate = 0.0;
+
+    for (size_t count = 0; count <= last; ++count)
+    {
+        rate += probability * rates[count];
+        probability *= load / (count + 1);
+    }
+
+    return rate;
+}
+
+// The fewest blocks for which the blocked filter meets the rate with three
+// full generations, found by search from the size of a standard filter.
+// Entries per block vary, so a blocked filter needs more cells than a
+// standard filter, increasingly with the number of hash functions.
+static size_t to_blocks(size_t generation_size, size_t hash_functions,
+    double rate)
+{
+    const auto entries = 3.0 * generation_size;
+    const auto functions = static_cast<double>(hash_functions);
+    const auto fill = std::exp(std::log(rate) / functions);
+    const auto cells = std::ceil(-functions * entries / std::log(1.0 - fill));
+    const auto standard = static_cast<size_t>(std::ceil(cells / block_cells));
+
+    // The distribution of set cells of a block of no entries.
+    std::vector<double> occupancy(block_cells + 1, 0.0);
+    occupancy[0] = 1.0;
+    std::vector<double> rates;
+
+    const auto meets = [&](size_t blocks)
+    {
+        return blocked_rate(entries, blocks, hash_functions, occupancy,
+            rates) <= rate;
+    };
+
+    // Double the upper bound until it meets the rate, then bisect.
+    auto lower = std::max(standard, size_t(1));
+    auto upper = lower;
+
+    while (!meets(upper))
+    {
+        lower = upper + 1;
+        upper *= 2;
+    }
+
+    while (lower < upper)
+    {
+        const auto middle = lower + (upper - lower) / 2;
+
+        if (meets(middle))
+            upper = middle;
+        else
+            lower = middle + 1;
+    }
+
+    return upper;
+}
+
+static double to_rate(double rate)
+{
+    BITCOIN_ASSERT(rate > 0.0 && rate < 1.0);
+    return std::min(std::max(rate, 1e-15), 0.5);
+}
+
+// The splitmix64 finalizer, so each round of positions is independent.
+static uint64_t mix(uint64_t seed, size_t round)
+{
+    auto value = seed + (round + 1) * 0x9e3779b97f4a7c15;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+    return value ^ (value >> 31);
+}
+
+// Each round of mixing yields the cell positions of eight hash functions.
+static uint8_t to_position(uint64_t& bits, uint64_t seed, size_t function)
+{
+    const auto byte = function % sizeof(uint64_t);
+
+    if (byte == 0)
+        bits = mix(seed, function / sizeof(uint64_t));
+
+    return static_cast<uint8_t>(bits >> (byte * byte_bits));
+}
+
+static half_hash random_key()
+{
+    data_chunk entropy(half_hash_size);
+    pseudo_random_fill(entropy);
+    half_hash key;
+    std::copy(entropy.begin(), entropy.end(), key.begin());
+    return key;
+}
+
+rolling_bloom_filter::rolling_bloom_filter(size_t capacity,
+    double false_positive_rate)
+  : rolling_bloom_filter(capacity, false_positive_rate, random_key())
+{
+}
+
+rolling_bloom_filter::rolling_bloom_filter(size_t capacity,
+    double false_positive_rate, const half_hash& key)
+  : generation_size_(std::max((capacity + 1) / 2, size_t(1))),
+    hash_functions_(to_hash_functions(to_rate(false_positive_rate))),
+    blocks_(to_blocks(generation_size_, hash_functions_,
+        to_rate(false_positive_rate))),
+    key_(key),
+    data_(blocks_ * block_words + block_words - 1, 0),
+    entries_(0),
+    generation_(1)
+{
+    // Offset the cells to the first cache line boundary of the storage.
+    const auto address = reinterpret_cast<uintptr_t>(data_.data());
+    const auto misalignment = address % block_size;
+    offset_ = misalignment == 0 ? 0 :
+        (block_size - misalignment) / sizeof(uint64_t);
+}
+
+rolling_bloom_filter::cell rolling_bloom_filter::locate(
+    const hash_digest& hash) const
+{
+    const auto value = siphash(key_, hash);
+
+    // The high word maps to a block, and seeds the cells within it.
+    // Positions are not derived by double hashing, as the few distinct
+    // sequences of a 256 cell block would raise the false positive rate.
+    const auto block = ((value >> 32) * blocks_) >> 32;
+    return{ offset_ + block * block_words, value };
+}
+
+// Start the next generation, clearing the cells of the oldest (its number).
+void rolling_bloom_filter::age()
+{
+    entries_ = 0;
+    generation_ = generation_ == 3 ? 1 : generation_ + 1;
+    const auto low = uint64_t(0) - (generation_ & 1);
+    const auto high = uint64_t(0) - (generation_ >> 1);
+    const auto end = offset_ + blocks_ * block_words;
+
+    for (auto word = offset_; word < end; word += 2)
+    {
+        const auto mask = (data_[word] ^ low) | (data_[word + 1] ^ high);
+        data_[word] &= mask;
+        data_[word + 1] &= mask;
+    }
+}
+
+void rolling_bloom_filter::insert(const hash_digest& hash)
+{
+    if (entries_ == generation_size_)
+        age();
+
+    ++entries_;
+    const auto cell = locate(hash);
+    const auto block = &data_[cell.block];
+    const uint64_t low = generation_ & 1;
+    const uint64_t high = generation_ >> 1;
+    uint64_t bits = 0;
+
+    for (size_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto position = to_position(bits, cell.seed, function);
+        const auto pair = (position >> 6) * 2;
+        const auto bit = position & 63;
+        const auto clear = ~(uint64_t(1) << bit);
+        block[pair] = (block[pair] & clear) | (low << bit);
+        block[pair + 1] = (block[pair + 1] & clear) | (high << bit);
+    }
+}
+
+void rolling_bloom_filter::insert(const inventory& inventory)
+{
+    for (const auto& vector: inventory.inventories)
+        insert(vector.hash);
+}
+
+bool rolling_bloom_filter::contains(const hash_digest& hash) const
+{
+    const auto cell = locate(hash);
+    const auto block = &data_[cell.block];
+    uint64_t bits = 0;
+
+    for (size_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto position = to_position(bits, cell.seed, function);
+        const auto pair = (position >> 6) * 2;
+        const auto bit = position & 63;
+
+        if (((block[pair] | block[pair + 1]) >> bit & 1) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+void rolling_bloom_filter::filter(inventory_vector::list& out,
+    const inventory& inventory) const
+{
+    for (const auto& vector: inventory.inventories)
+        if (!contains(vector.hash))
+            out.push_back(vector);
+}
+
+void rolling_bloom_filter::clear()
+{
+    std::fill(data_.begin(), data_.end(), 0);
+    entries_ = 0;
+    generation_ = 1;
+}
+
+size_t rolling_bloom_filter::hash_functions() const
+{
+    return hash_functions_;
+}
+
+size_t rolling_bloom_filter::size() const
+{
+    return blocks_ * block_size;
+}
+
+} // namspace message
+} // namspace libbitcoin
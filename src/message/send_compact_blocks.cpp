@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -71,8 +73,8 @@ void send_compact_blocks::reset()
 bool send_compact_blocks::from_data(uint32_t version,
     const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool send_compact_blocks::from_data(uint32_t version,
@@ -82,8 +84,8 @@ bool send_compact_blocks::from_data(uint32_t version,
     return from_data(version, source);
 }
 
-bool send_compact_blocks::from_data(uint32_t version,
-    reader& source)
+template <typename Source>
+bool send_compact_blocks::read(uint32_t version, Source& source)
 {
     reset();
     const auto insufficient_version = (version < send_compact_blocks::version_minimum);
@@ -105,14 +107,22 @@ bool send_compact_blocks::from_data(uint32_t version,
     return result && !insufficient_version;
 }
 
+bool send_compact_blocks::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool send_compact_blocks::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk send_compact_blocks::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void send_compact_blocks::to_data(uint32_t version,
@@ -122,13 +132,23 @@ void send_compact_blocks::to_data(uint32_t version,
     to_data(version, sink);
 }
 
-void send_compact_blocks::to_data(uint32_t version,
-    writer& sink) const
+template <typename Sink>
+void send_compact_blocks::write(uint32_t version, Sink& sink) const
 {
     sink.write_byte(high_bandwidth_mode ? 1 : 0);
     sink.write_8_bytes_little_endian(this->version);
 }
 
+void send_compact_blocks::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void send_compact_blocks::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t send_compact_blocks::serialized_size(uint32_t version) const
 {
     return send_compact_blocks::satoshi_fixed_size(version);
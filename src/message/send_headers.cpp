@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -79,8 +81,8 @@ void send_headers::reset()
 
 bool send_headers::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool send_headers::from_data(uint32_t version, std::istream& stream)
@@ -89,7 +91,8 @@ bool send_headers::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool send_headers::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool send_headers::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -99,24 +102,47 @@ bool send_headers::from_data(uint32_t version, reader& source)
     return !version_unsupported_;
 }
 
+bool send_headers::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool send_headers::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk send_headers::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void send_headers::to_data(uint32_t version, std::ostream& stream) const
 {
 }
 
+template <typename Sink>
+void send_headers::write(uint32_t version, Sink& sink) const
+{
+}
+
 uint64_t send_headers::serialized_size(uint32_t version) const
 {
     return send_headers::satoshi_fixed_size(version);
 }
 
+void send_headers::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void send_headers::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 } // namspace message
 } // namspace libbitcoin
@@ -19,11 +19,14 @@
  */
 #include <bitcoin/bitcoin/message/transaction_message.hpp>
 
+#include <atomic>
 #include <istream>
+#include <memory>
 #include <utility>
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 
@@ -59,46 +62,63 @@ transaction_message transaction_message::factory_from_data(
 }
 
 transaction_message::transaction_message()
-  : transaction(), originator_(0)
+  : transaction_(std::make_shared<chain::transaction>()), owned_(true),
+    originator_(0)
 {
 }
 
-transaction_message::transaction_message(const transaction& other)
-  : transaction_message(other.version, other.locktime, other.inputs,
-        other.outputs)
+transaction_message::transaction_message(
+    chain::transaction::const_ptr transaction)
+  : transaction_(transaction), owned_(false), originator_(0)
+{
+    BITCOIN_ASSERT(transaction_);
+}
+
+transaction_message::transaction_message(const chain::transaction& other)
+  : transaction_(std::make_shared<chain::transaction>(other)), owned_(true),
+    originator_(0)
 {
 }
 
+// The copy shares the transaction.
 transaction_message::transaction_message(const transaction_message& other)
-  : transaction_message(other.version, other.locktime, other.inputs,
-    other.outputs)
+  : transaction_(other.transaction_), owned_(other.owned_),
+    originator_(other.originator_)
 {
 }
 
 transaction_message::transaction_message(uint32_t version, uint32_t locktime,
     const chain::input::list& inputs, const chain::output::list& outputs)
-  : transaction(version, locktime, inputs, outputs), originator_(0)
+  : transaction_(std::make_shared<chain::transaction>(version, locktime,
+        inputs, outputs)),
+    owned_(true),
+    originator_(0)
 {
 }
 
-transaction_message::transaction_message(transaction&& other)
-  : transaction_message(other.version, other.locktime,
-        std::forward<chain::input::list>(inputs),
-        std::forward<chain::output::list>(outputs))
+transaction_message::transaction_message(chain::transaction&& other)
+  : transaction_(std::make_shared<chain::transaction>(
+        std::forward<chain::transaction>(other))),
+    owned_(true),
+    originator_(0)
 {
 }
 
+// The source is left with an empty transaction of its own.
 transaction_message::transaction_message(transaction_message&& other)
-  : transaction_message(other.version, other.locktime,
-        std::forward<chain::input::list>(inputs),
-        std::forward<chain::output::list>(outputs))
+  : transaction_(std::move(other.transaction_)), owned_(other.owned_),
+    originator_(other.originator_)
 {
+    other.transaction_ = std::make_shared<chain::transaction>();
+    other.owned_ = true;
 }
 
 transaction_message::transaction_message(uint32_t version, uint32_t locktime,
     chain::input::list&& inputs, chain::output::list&& outputs)
-  : transaction(version, locktime, std::forward<chain::input::list>(inputs),
-        std::forward<chain::output::list>(outputs)),
+  : transaction_(std::make_shared<chain::transaction>(version, locktime,
+        std::forward<chain::input::list>(inputs),
+        std::forward<chain::output::list>(outputs))),
+    owned_(true),
     originator_(0)
 {
 }
@@ -106,53 +126,113 @@ transaction_message::transaction_message(uint32_t version, uint32_t locktime,
 transaction_message& transaction_message::operator=(
     transaction_message&& other)
 {
-    version = other.version;
-    locktime = other.locktime;
-    inputs = std::move(other.inputs);
-    outputs = std::move(other.outputs);
+    transaction_.swap(other.transaction_);
+    std::swap(owned_, other.owned_);
     originator_ = other.originator_;
     return *this;
 }
 
+chain::transaction::const_ptr transaction_message::transaction() const
+{
+    return transaction_;
+}
+
+// The transaction to be written, which is the current transaction if this
+// message allocated it and holds the only reference, otherwise a new one.
+chain::transaction::ptr transaction_message::writable()
+{
+    if (owned_ && transaction_.use_count() == 1)
+    {
+        // Order the release of the last other reference before reuse.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return std::const_pointer_cast<chain::transaction>(transaction_);
+    }
+
+    const auto transaction = std::make_shared<chain::transaction>();
+    transaction_ = transaction;
+    owned_ = true;
+    return transaction;
+}
+
 bool transaction_message::from_data(uint32_t version,
     const data_chunk& data)
 {
     originator_ = version;
-    return transaction::from_data(data);
+    return writable()->from_data(data);
 }
 
 bool transaction_message::from_data(uint32_t version,
     std::istream& stream)
 {
     originator_ = version;
-    return transaction::from_data(stream);
+    return writable()->from_data(stream);
+}
+
+template <typename Source>
+bool transaction_message::read(uint32_t version, Source& source)
+{
+    originator_ = version;
+    return writable()->from_data(source);
 }
 
 bool transaction_message::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool transaction_message::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
+bool transaction_message::from_data(uint32_t version, data_slice payload,
+    const hash_digest& hash)
 {
     originator_ = version;
-    return transaction::from_data(source);
+    return writable()->from_data(payload, hash);
 }
 
 data_chunk transaction_message::to_data(uint32_t version) const
 {
-    return transaction::to_data();
+    return transaction_->to_data();
 }
 
 void transaction_message::to_data(uint32_t version,
     std::ostream& stream) const
 {
-    transaction::to_data(stream);
+    transaction_->to_data(stream);
+}
+
+template <typename Sink>
+void transaction_message::write(uint32_t version, Sink& sink) const
+{
+    transaction_->to_data(sink);
 }
 
 void transaction_message::to_data(uint32_t version, writer& sink) const
 {
-    transaction::to_data(sink);
+    write(version, sink);
+}
+
+void transaction_message::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
 }
 
 uint64_t transaction_message::serialized_size(uint32_t version) const
 {
-    return transaction::serialized_size();
+    return transaction_->serialized_size();
+}
+
+bool transaction_message::is_valid() const
+{
+    return transaction_->is_valid();
+}
+
+void transaction_message::clear()
+{
+    writable()->clear();
+    originator_ = 0;
 }
 
 uint64_t transaction_message::originator() const
@@ -23,6 +23,8 @@
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -68,8 +70,8 @@ void verack::reset()
 
 bool verack::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool verack::from_data(uint32_t version, std::istream& stream)
@@ -78,31 +80,55 @@ bool verack::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool verack::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool verack::read(uint32_t version, Source& source)
 {
     reset();
     return source;
 }
 
+bool verack::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool verack::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk verack::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void verack::to_data(uint32_t version, std::ostream& stream) const
 {
 }
 
+template <typename Sink>
+void verack::write(uint32_t version, Sink& sink) const
+{
+}
+
 uint64_t verack::serialized_size(uint32_t version) const
 {
     return verack::satoshi_fixed_size(version);
 }
 
+void verack::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void verack::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 
 uint64_t verack::satoshi_fixed_size(uint32_t version)
 {
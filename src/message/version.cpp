@@ -23,6 +23,8 @@
 #include <boost/iostreams/stream.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/data_reader.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
@@ -86,8 +88,8 @@ void version::reset()
 
 bool version::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool version::from_data(uint32_t version, std::istream& stream)
@@ -96,7 +98,8 @@ bool version::from_data(uint32_t version, std::istream& stream)
     return from_data(version, source);
 }
 
-bool version::from_data(uint32_t version, reader& source)
+template <typename Source>
+bool version::read(uint32_t version, Source& source)
 {
     reset();
 
@@ -125,14 +128,22 @@ bool version::from_data(uint32_t version, reader& source)
     return result;
 }
 
+bool version::from_data(uint32_t version, reader& source)
+{
+    return read(version, source);
+}
+
+bool version::from_data(uint32_t version, data_reader& source)
+{
+    return read(version, source);
+}
+
 data_chunk version::to_data(uint32_t version) const
 {
-    data_chunk data;
-    data_sink ostream(data);
-    to_data(version, ostream);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == serialized_size(version));
-    return data;
+    return write_chunk(serialized_size(version), [&](data_writer& sink)
+    {
+        to_data(version, sink);
+    });
 }
 
 void version::to_data(uint32_t version, std::ostream& stream) const
@@ -141,7 +152,8 @@ void version::to_data(uint32_t version, std::ostream& stream) const
     to_data(version, sink);
 }
 
-void version::to_data(uint32_t version, writer& sink) const
+template <typename Sink>
+void version::write(uint32_t version, Sink& sink) const
 {
     sink.write_4_bytes_little_endian(value);
     const uint32_t effective_version = std::min(version, value);
@@ -157,6 +169,16 @@ void version::to_data(uint32_t version, writer& sink) const
         sink.write_byte(relay ? 1 : 0);
 }
 
+void version::to_data(uint32_t version, writer& sink) const
+{
+    write(version, sink);
+}
+
+void version::to_data(uint32_t version, data_writer& sink) const
+{
+    write(version, sink);
+}
+
 uint64_t version::serialized_size(uint32_t version) const
 {
     auto size = 
@@ -169,7 +191,8 @@ uint64_t version::serialized_size(uint32_t version) const
         variable_uint_size(user_agent.size()) + user_agent.size() +
         sizeof(start_height);
 
-    if (value >= level::bip37)
+    // The relay byte is written based on the effective version, as above.
+    if (std::min(version, value) >= level::bip37)
         size += sizeof(uint8_t);
 
     return size;
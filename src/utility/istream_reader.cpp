@@ -19,6 +19,7 @@
  */
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 
+#include <algorithm>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/endian.hpp>
@@ -45,6 +46,12 @@ bool istream_reader::is_exhausted() const
     return stream_ && (stream_.peek() == std::istream::traits_type::eof());
 }
 
+// The size of a stream is not generally known without consuming it.
+size_t istream_reader::remaining() const
+{
+    return static_cast<size_t>(max_size_t);
+}
+
 uint8_t istream_reader::read_byte()
 {
     uint8_t result;
@@ -111,23 +118,31 @@ uint64_t istream_reader::read_variable_uint_big_endian()
     return read_8_bytes_big_endian();
 }
 
+// The buffer grows geometrically as bytes arrive, so an untrusted size
+// cannot allocate more than twice the bytes actually present.
 data_chunk istream_reader::read_data(size_t size)
 {
-    data_chunk raw_bytes(size);
+    static constexpr size_t initial_size = 4096;
+    data_chunk raw_bytes(std::min(size, initial_size));
+    size_t read_size = 0;
 
-    if (size > 0)
+    while (read_size < size)
     {
-        stream_.read(reinterpret_cast<char*>(raw_bytes.data()), size);
-        auto size = stream_.gcount();
-        BITCOIN_ASSERT(size <= bc::max_size_t);
-        const auto read_size = static_cast<size_t>(size);
-
-        if (size != read_size)
-//          throw std::ios_base::failure(
-//              "read_data failed to read requested number of bytes");
-            raw_bytes.resize(read_size);
+        if (read_size == raw_bytes.size())
+            raw_bytes.resize(std::min(size, 2 * read_size));
+
+        const auto request = raw_bytes.size() - read_size;
+        stream_.read(reinterpret_cast<char*>(raw_bytes.data() + read_size),
+            request);
+        const auto count = stream_.gcount();
+        BITCOIN_ASSERT(count <= bc::max_size_t);
+        read_size += static_cast<size_t>(count);
+
+        if (static_cast<size_t>(count) != request)
+            break;
     }
 
+    raw_bytes.resize(read_size);
     return raw_bytes;
 }
 
@@ -22,8 +22,9 @@
 #include <boost/iostreams/stream.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
-#include <bitcoin/bitcoin/utility/container_sink.hpp>
-#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data_writer.hpp>
+#include <bitcoin/bitcoin/utility/variable_uint_size.hpp>
 #include <bitcoin/bitcoin/wallet/ec_private.hpp>
 
 namespace libbitcoin {
@@ -41,13 +42,13 @@ hash_digest hash_message(data_slice message)
     // This is a specified magic prefix.
     static const std::string prefix("Bitcoin Signed Message:\n");
 
-    data_chunk data;
-    data_sink ostream(data);
-    ostream_writer sink(ostream);
+    data_chunk data(variable_uint_size(prefix.size()) + prefix.size() +
+        variable_uint_size(message.size()) + message.size());
+    data_writer sink(data);
     sink.write_string(prefix);
     sink.write_variable_uint_little_endian(message.size());
-    sink.write_data(message);
-    ostream.flush();
+    sink.write_data(message.data(), message.size());
+    BITCOIN_ASSERT(sink && sink.size() == data.size());
     return bitcoin_hash(data);
 }
 
@@ -144,6 +144,13 @@ BOOST_AUTO_TEST_CASE(generate_merkle_root_block_with_zero_transactions_matches_n
     BOOST_REQUIRE(null_hash == chain::block::generate_merkle_root(chain::transaction::list{}));
 }
 
+static chain::transaction::const_ptr parse(const data_chunk& data)
+{
+    const auto tx = std::make_shared<chain::transaction>();
+    BOOST_REQUIRE(tx->from_data(data));
+    return tx;
+}
+
 BOOST_AUTO_TEST_CASE(generate_merkle_root_block_with_multiple_transactions_matches_historic_data)
 {
     // encodes the 100,000 block data.
@@ -155,15 +162,13 @@ BOOST_AUTO_TEST_CASE(generate_merkle_root_block_with_multiple_transactions_match
     block100k.header.bits = 456101533;
     block100k.header.nonce = 719871722;
 
-    block100k.transactions.emplace_back();
-    block100k.transactions.back().from_data(to_chunk(base16_literal(
+    block100k.transactions.push_back(parse(to_chunk(base16_literal(
         "010000000100000000000000000000000000000000000000000000000000000000000"
         "00000ffffffff07049d8e2f1b0114ffffffff0100f2052a0100000043410437b36a72"
         "21bc977dce712728a954e3b5d88643ed5aef46660ddcfeeec132724cd950c1fdd008a"
-        "d4a2dfd354d6af0ff155fc17c1ee9ef802062feb07ef1d065f0ac00000000")));
+        "d4a2dfd354d6af0ff155fc17c1ee9ef802062feb07ef1d065f0ac00000000"))));
 
-    block100k.transactions.emplace_back();
-    block100k.transactions.back().from_data(to_chunk(base16_literal(
+    block100k.transactions.push_back(parse(to_chunk(base16_literal(
         "0100000001260fd102fab456d6b169f6af4595965c03c2296ecf25bfd8790e7aa29b4"
         "04eff010000008c493046022100c56ad717e07229eb93ecef2a32a42ad041832ffe66"
         "bd2e1485dc6758073e40af022100e4ba0559a4cebbc7ccb5d14d1312634664bac46f3"
@@ -171,10 +176,9 @@ BOOST_AUTO_TEST_CASE(generate_merkle_root_block_with_multiple_transactions_match
         "41c5c907525a69a8743465f063c1d9182eea27746aeb9f1f52583040b1bc341b31ca0"
         "388139f2f323fd59f8effffffff0200ffb2081d0000001976a914fc7b44566256621a"
         "ffb1541cc9d59f08336d276b88ac80f0fa02000000001976a914617f0609c9fabb545"
-        "105f7898f36b84ec583350d88ac00000000")));
+        "105f7898f36b84ec583350d88ac00000000"))));
 
-    block100k.transactions.emplace_back();
-    block100k.transactions.back().from_data(to_chunk(base16_literal(
+    block100k.transactions.push_back(parse(to_chunk(base16_literal(
         "010000000122cd6da26eef232381b1a670aa08f4513e9f91a9fd129d912081a3dd138"
         "cb013010000008c4930460221009339c11b83f234b6c03ebbc4729c2633cbc8cbd0d1"
         "5774594bfedc45c4f99e2f022100ae0135094a7d651801539df110a028d65459d24bc"
@@ -182,21 +186,21 @@ BOOST_AUTO_TEST_CASE(generate_merkle_root_block_with_multiple_transactions_match
         "b8520b196c2f6ec3d06239861e49507f09b7568189efe8d327c3384a4e488f8c53448"
         "4835f8020b3669e5aebffffffff0200ac23fc060000001976a914b9a2c9700ff95195"
         "16b21af338d28d53ddf5349388ac00743ba40b0000001976a914eb675c349c474bec8"
-        "dea2d79d12cff6f330ab48788ac00000000")));
+        "dea2d79d12cff6f330ab48788ac00000000"))));
 
     BOOST_REQUIRE(block100k.is_valid());
 
     for (const auto& tx: block100k.transactions)
     {
-        BOOST_REQUIRE(tx.is_valid());
+        BOOST_REQUIRE(tx->is_valid());
 
-        for (const auto& input: tx.inputs)
+        for (const auto& input: tx->inputs)
         {
             BOOST_REQUIRE(input.is_valid());
             BOOST_REQUIRE(input.script.is_valid());
         }
 
-        for (const auto& output: tx.outputs)
+        for (const auto& output: tx->outputs)
         {
             BOOST_REQUIRE(output.is_valid());
             BOOST_REQUIRE(output.script.is_valid());
@@ -206,4 +210,100 @@ BOOST_AUTO_TEST_CASE(generate_merkle_root_block_with_multiple_transactions_match
     BOOST_REQUIRE(block100k.header.merkle == chain::block::generate_merkle_root(block100k.transactions));
 }
 
+static chain::transaction::const_ptr make_spend(uint8_t hash, uint32_t index,
+    uint32_t version=1)
+{
+    const auto tx = std::make_shared<chain::transaction>();
+    tx->version = version;
+    tx->inputs.emplace_back();
+    tx->inputs.back().previous_output.hash = null_hash;
+    tx->inputs.back().previous_output.hash[0] = hash;
+    tx->inputs.back().previous_output.index = index;
+    tx->inputs.back().sequence = max_input_sequence;
+    tx->outputs.emplace_back();
+    tx->outputs.back().value = 42;
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(check_genesis_returns_success)
+{
+    const auto genesis = bc::chain::block::genesis_mainnet();
+    BOOST_REQUIRE(genesis.is_valid_proof_of_work());
+    BOOST_REQUIRE_EQUAL(genesis.check(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(check_empty_returns_size_limits)
+{
+    BOOST_REQUIRE_EQUAL(chain::block().check(), error::size_limits);
+}
+
+BOOST_AUTO_TEST_CASE(check_bad_nonce_returns_proof_of_work)
+{
+    auto block = bc::chain::block::genesis_mainnet();
+    block.header.nonce += 1;
+    BOOST_REQUIRE_EQUAL(block.check(), error::proof_of_work);
+}
+
+BOOST_AUTO_TEST_CASE(check_second_coinbase_returns_extra_coinbases)
+{
+    auto block = bc::chain::block::genesis_mainnet();
+    block.transactions.push_back(block.transactions.front());
+    BOOST_REQUIRE_EQUAL(block.check(), error::extra_coinbases);
+}
+
+BOOST_AUTO_TEST_CASE(check_duplicate_transaction_returns_duplicate)
+{
+    auto block = bc::chain::block::genesis_mainnet();
+    block.transactions.push_back(make_spend(1, 0));
+    block.transactions.push_back(make_spend(1, 0));
+    BOOST_REQUIRE_EQUAL(block.check(), error::duplicate);
+}
+
+BOOST_AUTO_TEST_CASE(check_conflicting_transactions_returns_double_spend)
+{
+    auto block = bc::chain::block::genesis_mainnet();
+    block.transactions.push_back(make_spend(1, 0));
+    block.transactions.push_back(make_spend(1, 0, 2));
+    BOOST_REQUIRE_EQUAL(block.check(), error::double_spend);
+}
+
+BOOST_AUTO_TEST_CASE(check_unrelated_transaction_returns_merkle_mismatch)
+{
+    auto block = bc::chain::block::genesis_mainnet();
+    block.transactions.push_back(make_spend(1, 0));
+    BOOST_REQUIRE_EQUAL(block.check(), error::merkle_mismatch);
+}
+
+BOOST_AUTO_TEST_CASE(serialized_size_parsed_returns_consumed_size)
+{
+    const auto genesis = bc::chain::block::genesis_mainnet();
+    const auto raw = genesis.to_data();
+    BOOST_REQUIRE_EQUAL(genesis.serialized_size(), raw.size());
+    BOOST_REQUIRE_EQUAL(genesis.serialized_size(false), raw.size() - 1);
+
+    // Changing the transactions of a parsed block requires invalidation.
+    auto block = bc::chain::block::genesis_mainnet();
+    block.transactions.push_back(make_spend(1, 0));
+    block.header.transaction_count = 2;
+    block.invalidate_cache();
+    const auto expected = raw.size() + make_spend(1, 0)->serialized_size();
+    BOOST_REQUIRE_EQUAL(block.serialized_size(), expected);
+    BOOST_REQUIRE_EQUAL(block.to_data().size(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(serialized_size_non_minimal_count_returns_canonical_size)
+{
+    // Encode the transaction count (1) with a non-minimal variable integer.
+    const auto canonical = bc::chain::block::genesis_mainnet().to_data();
+    BOOST_REQUIRE_EQUAL(canonical[80], 0x01);
+    data_chunk raw(canonical.begin(), canonical.begin() + 80);
+    extend_data(raw, data_chunk{ 0xfd, 0x01, 0x00 });
+    raw.insert(raw.end(), canonical.begin() + 81, canonical.end());
+
+    bc::chain::block block;
+    BOOST_REQUIRE(block.from_data(raw));
+    BOOST_REQUIRE_EQUAL(block.serialized_size(), canonical.size());
+    BOOST_REQUIRE(block.to_data() == canonical);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
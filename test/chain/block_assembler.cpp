@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(block_assembler_tests)
+
+// The version distinguishes otherwise identical transactions.
+static transaction::ptr make_spend(uint32_t version, const point::list& points)
+{
+    const auto tx = std::make_shared<transaction>();
+    tx->version = version;
+
+    for (const auto& point: points)
+    {
+        tx->inputs.emplace_back();
+        tx->inputs.back().previous_output = point;
+    }
+
+    tx->outputs.emplace_back();
+    tx->outputs.emplace_back();
+    return tx;
+}
+
+static point external(uint32_t index)
+{
+    return point{ null_hash, index };
+}
+
+static point make_point(transaction::const_ptr tx, uint32_t index)
+{
+    return point{ tx->hash(), index };
+}
+
+static const uint64_t unlimited = max_uint64;
+
+BOOST_AUTO_TEST_CASE(block_assembler__rebuild__package_outscores_single__dependency_order)
+{
+    transaction_pool pool(unlimited);
+    const auto parent = make_spend(1, { external(0) });
+    const auto child = make_spend(2, { make_point(parent, 0) });
+    const auto other = make_spend(3, { external(1) });
+    BOOST_REQUIRE_EQUAL(pool.store(parent, 100), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(child, 10000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(other, 1000), error::success);
+
+    block_assembler assembler(pool);
+    assembler.rebuild();
+
+    const auto& selected = assembler.transactions();
+    BOOST_REQUIRE_EQUAL(selected.size(), 3u);
+    BOOST_REQUIRE(selected[0] == parent);
+    BOOST_REQUIRE(selected[1] == child);
+    BOOST_REQUIRE(selected[2] == other);
+    BOOST_REQUIRE_EQUAL(assembler.fees(), 11100u);
+    BOOST_REQUIRE_EQUAL(assembler.size(), parent->serialized_size() +
+        child->serialized_size() + other->serialized_size());
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__rebuild__modified_ancestor_selected_by_descendant__selected_once)
+{
+    // The middle and last are both modified by the selection of the first,
+    // and the middle is then selected in the package of the last.
+    transaction_pool pool(unlimited);
+    const auto first = make_spend(1, { external(0) });
+    const auto middle = make_spend(2, { make_point(first, 0) });
+    const auto last = make_spend(3, { make_point(middle, 0) });
+    BOOST_REQUIRE_EQUAL(pool.store(first, 10000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(middle, 10), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(last, 5000), error::success);
+
+    block_assembler assembler(pool);
+    assembler.rebuild();
+
+    const auto& selected = assembler.transactions();
+    BOOST_REQUIRE_EQUAL(selected.size(), 3u);
+    BOOST_REQUIRE(selected[0] == first);
+    BOOST_REQUIRE(selected[1] == middle);
+    BOOST_REQUIRE(selected[2] == last);
+    BOOST_REQUIRE_EQUAL(assembler.fees(), 15010u);
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__rebuild__size_limit__highest_scores_selected)
+{
+    transaction_pool pool(unlimited);
+    const auto low = make_spend(1, { external(0) });
+    const auto middle = make_spend(2, { external(1) });
+    const auto high = make_spend(3, { external(2) });
+    BOOST_REQUIRE_EQUAL(pool.store(low, 100), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(middle, 200), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(high, 300), error::success);
+
+    const auto size = low->serialized_size();
+    block_assembler assembler(pool,
+        block_assembler::coinbase_reserved_size + 2 * size);
+    assembler.rebuild();
+
+    const auto& selected = assembler.transactions();
+    BOOST_REQUIRE_EQUAL(selected.size(), 2u);
+    BOOST_REQUIRE(selected[0] == high);
+    BOOST_REQUIRE(selected[1] == middle);
+    BOOST_REQUIRE_EQUAL(assembler.fees(), 500u);
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__rebuild__sigop_limit__over_limit_skipped)
+{
+    transaction_pool pool(unlimited);
+    const auto heavy = make_spend(1, { external(0) });
+    heavy->outputs[0].script.operations.push_back({ opcode::checksig, {} });
+    heavy->outputs[1].script.operations.push_back({ opcode::checksig, {} });
+    const auto light = make_spend(2, { external(1) });
+    light->outputs[0].script.operations.push_back({ opcode::checksig, {} });
+    BOOST_REQUIRE_EQUAL(pool.store(heavy, 5000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(light, 1000), error::success);
+
+    block_assembler assembler(pool, max_block_size,
+        block_assembler::coinbase_reserved_sigops + 1);
+    assembler.rebuild();
+
+    BOOST_REQUIRE_EQUAL(assembler.transactions().size(), 1u);
+    BOOST_REQUIRE(assembler.transactions()[0] == light);
+    BOOST_REQUIRE_EQUAL(assembler.sigops(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__update__arrival_with_parent__appended_in_order)
+{
+    transaction_pool pool(unlimited);
+    const auto first = make_spend(1, { external(0) });
+    BOOST_REQUIRE_EQUAL(pool.store(first, 1000), error::success);
+
+    block_assembler assembler(pool);
+    assembler.rebuild();
+    BOOST_REQUIRE_EQUAL(assembler.transactions().size(), 1u);
+
+    const auto parent = make_spend(2, { external(1) });
+    const auto child = make_spend(3, { make_point(parent, 0) });
+    BOOST_REQUIRE_EQUAL(pool.store(parent, 100), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(child, 100), error::success);
+    BOOST_REQUIRE_EQUAL(assembler.update({ child->hash() }), 2u);
+    BOOST_REQUIRE_EQUAL(assembler.update({ parent->hash() }), 0u);
+
+    const auto& selected = assembler.transactions();
+    BOOST_REQUIRE_EQUAL(selected.size(), 3u);
+    BOOST_REQUIRE(selected[0] == first);
+    BOOST_REQUIRE(selected[1] == parent);
+    BOOST_REQUIRE(selected[2] == child);
+    BOOST_REQUIRE_EQUAL(assembler.fees(), 1200u);
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__assemble__selection__coinbase_and_merkle_root)
+{
+    transaction_pool pool(unlimited);
+    const auto tx = make_spend(1, { external(0) });
+    BOOST_REQUIRE_EQUAL(pool.store(tx, 2500), error::success);
+
+    block_assembler assembler(pool);
+    assembler.rebuild();
+
+    static const size_t height = 420000;
+    const header previous{ 4, null_hash, null_hash, 1231006505,
+        max_work_bits, 0 };
+    script pay_to;
+    pay_to.operations.push_back({ opcode::checksig, {} });
+    const auto result = assembler.assemble(previous, height, pay_to);
+
+    BOOST_REQUIRE_EQUAL(result.transactions.size(), 2u);
+    const auto& coinbase = *result.transactions[0];
+    BOOST_REQUIRE(coinbase.is_coinbase());
+    BOOST_REQUIRE_EQUAL(coinbase.check(), error::success);
+    BOOST_REQUIRE_EQUAL(coinbase.outputs[0].value, coin_price(25) / 2 + 2500);
+    BOOST_REQUIRE(coinbase.inputs[0].script.operations[0].data ==
+        script_number(height).data());
+    BOOST_REQUIRE(result.transactions[1] == tx);
+    BOOST_REQUIRE(result.header.merkle ==
+        block::generate_merkle_root(result.transactions));
+    BOOST_REQUIRE_EQUAL(result.header.bits, max_work_bits);
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__assemble__round_trip__transaction_count)
+{
+    transaction_pool pool(unlimited);
+    const auto first = make_spend(1, { external(0) });
+    const auto second = make_spend(2, { external(1) });
+    BOOST_REQUIRE_EQUAL(pool.store(first, 2500), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(second, 2500), error::success);
+
+    block_assembler assembler(pool);
+    assembler.rebuild();
+
+    const header previous{ 4, null_hash, null_hash, 1231006505,
+        max_work_bits, 0 };
+    const auto result = assembler.assemble(previous, 420000, script());
+    BOOST_REQUIRE_EQUAL(result.header.transaction_count, 3u);
+
+    block parsed;
+    BOOST_REQUIRE(parsed.from_data(result.to_data()));
+    BOOST_REQUIRE_EQUAL(parsed.header.transaction_count, 3u);
+    BOOST_REQUIRE_EQUAL(parsed.transactions.size(), 3u);
+    BOOST_REQUIRE(parsed.header.hash() == result.header.hash());
+    BOOST_REQUIRE(parsed.to_data() == result.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__assemble__small_heights__pushed_by_opcode)
+{
+    transaction_pool pool(unlimited);
+    block_assembler assembler(pool);
+    const header previous{ 4, null_hash, null_hash, 1231006505,
+        max_work_bits, 0 };
+    const script pay_to;
+
+    const auto first = assembler.assemble(previous, 1, pay_to);
+    const auto& first_height = first.transactions[0]->inputs[0].script;
+    BOOST_REQUIRE(first_height.operations[0].code == opcode::op_1);
+    BOOST_REQUIRE(first_height.operations[0].data.empty());
+
+    const auto sixteenth = assembler.assemble(previous, 16, pay_to);
+    const auto& sixteenth_height = sixteenth.transactions[0]->inputs[0].script;
+    BOOST_REQUIRE(sixteenth_height.operations[0].code == opcode::op_16);
+    BOOST_REQUIRE(sixteenth_height.to_data(false) == data_chunk({ 0x60,
+        0x00 }));
+
+    const auto seventeenth = assembler.assemble(previous, 17, pay_to);
+    const auto& seventeenth_height =
+        seventeenth.transactions[0]->inputs[0].script;
+    BOOST_REQUIRE(seventeenth_height.to_data(false) == data_chunk({ 0x01,
+        0x11, 0x00 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
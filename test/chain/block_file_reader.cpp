@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(block_file_reader_tests)
+
+static const uint32_t test_magic = 0xd9b4bef9;
+
+static block make_child(const block& parent, uint32_t nonce)
+{
+    auto child = parent;
+    child.header.previous_block_hash = parent.header.hash();
+    child.header.nonce = nonce;
+    return child;
+}
+
+static void append_frame(data_chunk& file, const block& instance)
+{
+    const auto payload = instance.to_data();
+    extend_data(file, to_little_endian(test_magic));
+    extend_data(file, to_little_endian(
+        static_cast<uint32_t>(payload.size())));
+    extend_data(file, payload);
+}
+
+// Removes the files on destruction.
+class temporary_files
+{
+public:
+    std::vector<fs::path> create(const std::vector<data_chunk>& contents)
+    {
+        for (const auto& content: contents)
+        {
+            paths_.push_back(fs::temp_directory_path() /
+                fs::unique_path("block_file_reader_%%%%%%%%.dat"));
+            bc::ofstream file(paths_.back().string(), std::ios::binary);
+            file.write(reinterpret_cast<const char*>(content.data()),
+                content.size());
+        }
+
+        return paths_;
+    }
+
+    ~temporary_files()
+    {
+        for (const auto& path: paths_)
+            fs::remove(path);
+    }
+
+private:
+    std::vector<fs::path> paths_;
+};
+
+BOOST_AUTO_TEST_CASE(block_file_reader__read__unordered_files__height_order)
+{
+    const auto block0 = block::genesis_mainnet();
+    const auto block1 = make_child(block0, 1);
+    const auto block2 = make_child(block1, 2);
+    const auto stale = make_child(block0, 3);
+    auto orphan = block0;
+    orphan.header.previous_block_hash = block2.header.merkle;
+
+    // Children precede parents, with padding between and after frames.
+    data_chunk first;
+    append_frame(first, block2);
+    first.resize(first.size() + 37, 0);
+    append_frame(first, orphan);
+    append_frame(first, stale);
+    first.resize(first.size() + 1024, 0);
+
+    data_chunk second;
+    append_frame(second, block1);
+    append_frame(second, block0);
+
+    temporary_files files;
+    threadpool pool(2);
+    block_file_reader reader(pool, test_magic);
+    BOOST_REQUIRE(reader.open(files.create({ first, data_chunk{}, second })));
+    BOOST_REQUIRE_EQUAL(reader.size(), 5u);
+    BOOST_REQUIRE_EQUAL(reader.link(), 3u);
+
+    const hash_list expected
+    {
+        block0.header.hash(), block1.header.hash(), block2.header.hash()
+    };
+
+    std::vector<size_t> heights;
+    const auto handler = [&](block::const_ptr instance, size_t height)
+    {
+        BOOST_REQUIRE(instance->header.hash() == expected[height]);
+        BOOST_REQUIRE_EQUAL(instance->serialized_size(),
+            block0.serialized_size());
+        heights.push_back(height);
+        return true;
+    };
+
+    BOOST_REQUIRE(reader.read(handler, 2));
+    BOOST_REQUIRE_EQUAL(heights.size(), 3u);
+    BOOST_REQUIRE_EQUAL(heights[0], 0u);
+    BOOST_REQUIRE_EQUAL(heights[1], 1u);
+    BOOST_REQUIRE_EQUAL(heights[2], 2u);
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__read__handler_false__stops)
+{
+    const auto block0 = block::genesis_mainnet();
+    const auto block1 = make_child(block0, 1);
+
+    data_chunk content;
+    append_frame(content, block0);
+    append_frame(content, block1);
+
+    temporary_files files;
+    threadpool pool(2);
+    block_file_reader reader(pool, test_magic);
+    BOOST_REQUIRE(reader.open(files.create({ content })));
+    BOOST_REQUIRE_EQUAL(reader.link(), 2u);
+
+    size_t count = 0;
+    const auto handler = [&](block::const_ptr, size_t)
+    {
+        return ++count < 1;
+    };
+
+    BOOST_REQUIRE(!reader.read(handler, 1));
+    BOOST_REQUIRE_EQUAL(count, 1u);
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__open__missing_file__false)
+{
+    threadpool pool(1);
+    block_file_reader reader(pool, test_magic);
+    const auto missing = fs::temp_directory_path() /
+        fs::unique_path("block_file_reader_%%%%%%%%.dat");
+
+    BOOST_REQUIRE(!reader.open({ missing }));
+    BOOST_REQUIRE_EQUAL(reader.size(), 0u);
+    BOOST_REQUIRE_EQUAL(reader.link(), 0u);
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
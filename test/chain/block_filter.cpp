@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(block_filter_tests)
+
+// The testnet genesis block differs from mainnet only in its header.
+static block genesis_testnet()
+{
+    const auto genesis = block::genesis_mainnet();
+    const auto& source = genesis.header;
+    const header header{ source.version, source.previous_block_hash,
+        source.merkle, 1296688602, source.bits, 414098458 };
+    return block(header, genesis.transactions);
+}
+
+static data_stack make_elements(size_t count, uint8_t tag)
+{
+    data_stack elements;
+
+    for (size_t index = 0; index < count; ++index)
+        elements.push_back({ tag, static_cast<uint8_t>(index),
+            static_cast<uint8_t>(index >> 8) });
+
+    return elements;
+}
+
+static block make_block(uint32_t nonce)
+{
+    const auto genesis = block::genesis_mainnet();
+    const auto& source = genesis.header;
+    const header header{ source.version, source.previous_block_hash,
+        source.merkle, source.timestamp, source.bits, nonce };
+    return block(header, genesis.transactions);
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__factory_from_block__testnet_genesis__bip158_vector)
+{
+    const auto genesis = genesis_testnet();
+    BOOST_REQUIRE(genesis.header.hash() == hash_literal(
+        "000000000933ea01ad0ee984209779baaec3ced90fa3f408719526f8d77f4943"));
+
+    const auto filter = block_filter::factory_from_block(genesis, {});
+    BOOST_REQUIRE_EQUAL(filter.size(), 1u);
+    BOOST_REQUIRE_EQUAL(encode_base16(filter.to_data()), "019dfca8");
+    BOOST_REQUIRE(filter.header(null_hash) == hash_literal(
+        "21584579b7eb08997773e5aeff3a7f932700042d0ed2a6129012b7d7ae81b750"));
+
+    const auto script = genesis.transactions[0]->outputs[0].script;
+    BOOST_REQUIRE(filter.match(script.to_data(false)));
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__basic_elements__excluded_and_duplicate__unique_set)
+{
+    const auto genesis = block::genesis_mainnet();
+    transaction coinbase(*genesis.transactions[0]);
+
+    operation op;
+    op.code = opcode::return_;
+    output unspendable;
+    unspendable.value = 0;
+    unspendable.script.operations.push_back(op);
+    coinbase.outputs.push_back(unspendable);
+    coinbase.outputs.push_back(genesis.transactions[0]->outputs[0]);
+
+    const block instance(genesis.header,
+        { std::make_shared<const transaction>(coinbase) });
+    const data_stack spent{ {}, { 0x51 }, { 0x51 } };
+    const auto elements = block_filter::basic_elements(instance, spent);
+
+    BOOST_REQUIRE_EQUAL(elements.size(), 2u);
+    BOOST_REQUIRE(elements[0] ==
+        genesis.transactions[0]->outputs[0].script.to_data(false));
+    BOOST_REQUIRE(elements[1] == data_chunk{ 0x51 });
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__match__members__true)
+{
+    const auto elements = make_elements(500, 0x01);
+    const block_filter filter(null_hash, elements);
+    BOOST_REQUIRE_EQUAL(filter.size(), 500u);
+
+    for (const auto& element: elements)
+        BOOST_REQUIRE(filter.match(element));
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__match_any__non_members__false)
+{
+    const block_filter filter(null_hash, make_elements(500, 0x01));
+    const auto others = make_elements(100, 0x02);
+    BOOST_REQUIRE(!filter.match_any(others));
+
+    auto queries = others;
+    queries.push_back(make_elements(300, 0x01).back());
+    BOOST_REQUIRE(filter.match_any(queries));
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__match__empty__false)
+{
+    const block_filter filter;
+    BOOST_REQUIRE_EQUAL(filter.size(), 0u);
+    BOOST_REQUIRE(filter.to_data() == data_chunk{ 0x00 });
+    BOOST_REQUIRE(!filter.match(data_chunk{ 0x51 }));
+    BOOST_REQUIRE(!filter.match_any(make_elements(10, 0x01)));
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__from_data__round_trip__same_matches)
+{
+    static const auto hash = hash_literal(
+        "000000000933ea01ad0ee984209779baaec3ced90fa3f408719526f8d77f4943");
+    const auto elements = make_elements(300, 0x01);
+    const block_filter expected(hash, elements);
+
+    block_filter filter;
+    BOOST_REQUIRE(filter.from_data(hash, expected.to_data()));
+    BOOST_REQUIRE_EQUAL(filter.size(), 300u);
+    BOOST_REQUIRE(filter.hash() == expected.hash());
+    BOOST_REQUIRE(filter.match_any(elements));
+    BOOST_REQUIRE(!filter.from_data(hash, data_chunk{}));
+}
+
+BOOST_AUTO_TEST_CASE(block_filter__factory_from_blocks__parallel__serial_headers)
+{
+    block::const_ptr_list blocks;
+    std::vector<data_stack> spent;
+
+    for (uint32_t nonce = 0; nonce < 20; ++nonce)
+    {
+        blocks.push_back(std::make_shared<const block>(make_block(nonce)));
+        spent.push_back(make_elements(nonce, 0x03));
+    }
+
+    threadpool pool(4);
+    const auto filters = block_filter::factory_from_blocks(pool, blocks,
+        spent);
+    pool.shutdown();
+    pool.join();
+
+    BOOST_REQUIRE_EQUAL(filters.size(), blocks.size());
+    const auto headers = block_filter::headers(filters, null_hash);
+    BOOST_REQUIRE_EQUAL(headers.size(), blocks.size());
+    auto previous = null_hash;
+
+    for (size_t index = 0; index < blocks.size(); ++index)
+    {
+        const auto expected = block_filter::factory_from_block(
+            *blocks[index], spent[index]);
+        BOOST_REQUIRE(filters[index].to_data() == expected.to_data());
+        BOOST_REQUIRE(filters[index].block_hash() ==
+            blocks[index]->header.hash());
+
+        previous = expected.header(previous);
+        BOOST_REQUIRE(headers[index] == previous);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(block_parser_tests)
+
+// The genesis block with additional transactions.
+static block make_block(size_t count)
+{
+    auto instance = block::genesis_mainnet();
+
+    for (size_t index = 1; index < count; ++index)
+    {
+        const auto tx = std::make_shared<transaction>(
+            *instance.transactions.front());
+        tx->locktime = static_cast<uint32_t>(index);
+        instance.transactions.push_back(tx);
+    }
+
+    instance.header.transaction_count = count;
+    instance.invalidate_cache();
+    return instance;
+}
+
+static void parse_in_chunks(size_t chunk)
+{
+    const auto expected = make_block(5);
+    const auto raw = expected.to_data();
+
+    hash_list hashes;
+    const auto handler = [&](transaction::const_ptr tx,
+        const hash_digest& hash)
+    {
+        BOOST_REQUIRE(tx->hash() == hash);
+        hashes.push_back(hash);
+    };
+
+    block_parser parser(handler);
+
+    for (size_t offset = 0; offset < raw.size(); offset += chunk)
+    {
+        const auto end = std::min(offset + chunk, raw.size());
+        BOOST_REQUIRE_EQUAL(parser.write(data_slice(raw.data() + offset,
+            raw.data() + end)), error::success);
+    }
+
+    BOOST_REQUIRE(parser.complete());
+    BOOST_REQUIRE(parser.has_header());
+    BOOST_REQUIRE(parser.block_header().hash() == expected.header.hash());
+    BOOST_REQUIRE_EQUAL(parser.transaction_count(), 5u);
+    BOOST_REQUIRE_EQUAL(parser.transactions_parsed(), 5u);
+    BOOST_REQUIRE_EQUAL(hashes.size(), 5u);
+
+    for (size_t index = 0; index < hashes.size(); ++index)
+        BOOST_REQUIRE(hashes[index] == expected.transactions[index]->hash());
+}
+
+BOOST_AUTO_TEST_CASE(block_parser__write__byte_at_a_time__expected)
+{
+    parse_in_chunks(1);
+}
+
+BOOST_AUTO_TEST_CASE(block_parser__write__odd_chunks__expected)
+{
+    parse_in_chunks(37);
+}
+
+BOOST_AUTO_TEST_CASE(block_parser__write__transactions_emitted_before_end)
+{
+    const auto expected = make_block(3);
+    const auto raw = expected.to_data();
+    size_t emitted = 0;
+    block_parser parser([&](transaction::const_ptr, const hash_digest&)
+    {
+        ++emitted;
+    });
+
+    // All but the last byte completes all but the last transaction.
+    BOOST_REQUIRE_EQUAL(parser.write(data_slice(raw.data(),
+        raw.data() + raw.size() - 1)), error::success);
+    BOOST_REQUIRE_EQUAL(emitted, 2u);
+    BOOST_REQUIRE(!parser.complete());
+}
+
+BOOST_AUTO_TEST_CASE(block_parser__write__trailing_bytes__bad_stream)
+{
+    auto raw = make_block(1).to_data();
+    raw.push_back(0x00);
+    block_parser parser([](transaction::const_ptr, const hash_digest&) {});
+    BOOST_REQUIRE_EQUAL(parser.write(raw), error::bad_stream);
+    BOOST_REQUIRE_EQUAL(parser.write(raw), error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(block_parser__write__oversized_count__size_limits)
+{
+    // The count is rejected before any transaction bytes arrive.
+    auto raw = make_block(1).to_data(false);
+    raw.resize(80);
+    extend_data(raw, data_chunk{ 0xfe, 0x00, 0x00, 0x10, 0x00 });
+    block_parser parser([](transaction::const_ptr, const hash_digest&) {});
+    BOOST_REQUIRE_EQUAL(parser.write(raw), error::size_limits);
+    BOOST_REQUIRE(parser.has_header());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(block_pipeline_tests)
+
+// Collects completions and signals once the expected count is reached.
+class collector
+{
+public:
+    collector(size_t expected)
+      : expected_(expected)
+    {
+    }
+
+    void complete(const code& ec, block::const_ptr block)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(ec);
+        blocks_.push_back(block);
+
+        if (results_.size() == expected_)
+            done_.set_value();
+    }
+
+    std::vector<code> wait()
+    {
+        done_.get_future().wait();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return results_;
+    }
+
+    std::vector<block::const_ptr> blocks()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return blocks_;
+    }
+
+private:
+    const size_t expected_;
+    std::promise<void> done_;
+    std::mutex mutex_;
+    std::vector<code> results_;
+    std::vector<block::const_ptr> blocks_;
+};
+
+static block_pipeline::ptr make_pipeline(threadpool& pool,
+    collector& results, block_pipeline::connect_handler connect,
+    size_t decode=4, size_t connect_capacity=4)
+{
+    const auto complete = [&results](const code& ec, block::const_ptr block)
+    {
+        results.complete(ec, block);
+    };
+
+    return std::make_shared<block_pipeline>(pool, connect, complete, decode,
+        connect_capacity);
+}
+
+static data_chunk genesis(bool testnet)
+{
+    return testnet ? block::genesis_testnet().to_data() :
+        block::genesis_mainnet().to_data();
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__push__many__connected_in_order)
+{
+    static const size_t count = 64;
+    threadpool pool(4);
+    collector results(count);
+    std::vector<uint32_t> connected;
+
+    // The connect stage is not concurrent, so no lock is required.
+    const auto connect = [&connected](const block& block)
+    {
+        connected.push_back(block.header.timestamp);
+        return code(error::success);
+    };
+
+    const auto pipeline = make_pipeline(pool, results, connect);
+    const auto mainnet = block::genesis_mainnet().header.timestamp;
+    const auto testnet = block::genesis_testnet().header.timestamp;
+
+    for (size_t index = 0; index < count;)
+        if (pipeline->push(genesis(index % 3 == 0)))
+            ++index;
+        else
+            std::this_thread::yield();
+
+    for (const auto ec: results.wait())
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+
+    BOOST_REQUIRE_EQUAL(connected.size(), count);
+
+    for (size_t index = 0; index < count; ++index)
+        BOOST_REQUIRE_EQUAL(connected[index], index % 3 == 0 ? testnet :
+            mainnet);
+
+    BOOST_REQUIRE_EQUAL(pipeline->pending(), 0u);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__push__invalid__fails_descendants)
+{
+    threadpool pool(2);
+    collector results(4);
+    size_t connections = 0;
+
+    const auto connect = [&connections](const block&)
+    {
+        ++connections;
+        return code(error::success);
+    };
+
+    const auto pipeline = make_pipeline(pool, results, connect);
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(pipeline->push(data_chunk{ 0x42 }));
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+
+    const auto codes = results.wait();
+    BOOST_REQUIRE_EQUAL(codes[0], error::success);
+    BOOST_REQUIRE_EQUAL(codes[1], error::bad_stream);
+    BOOST_REQUIRE_EQUAL(codes[2], error::previous_block_invalid);
+    BOOST_REQUIRE_EQUAL(codes[3], error::previous_block_invalid);
+    BOOST_REQUIRE_EQUAL(connections, 1u);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__push__connect_failure__fails_descendants)
+{
+    threadpool pool(2);
+    collector results(3);
+
+    const auto connect = [](const block&)
+    {
+        return code(error::validate_inputs_failed);
+    };
+
+    const auto pipeline = make_pipeline(pool, results, connect);
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+
+    const auto codes = results.wait();
+    BOOST_REQUIRE_EQUAL(codes[0], error::validate_inputs_failed);
+    BOOST_REQUIRE_EQUAL(codes[1], error::previous_block_invalid);
+    BOOST_REQUIRE_EQUAL(codes[2], error::previous_block_invalid);
+    BOOST_REQUIRE(results.blocks()[0]->header.merkle ==
+        block::genesis_mainnet().header.merkle);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__push__decode_full__false)
+{
+    // No threads, so nothing is decoded.
+    threadpool pool;
+    collector results(0);
+
+    const auto connect = [](const block&)
+    {
+        return code(error::success);
+    };
+
+    const auto pipeline = make_pipeline(pool, results, connect, 2, 2);
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(!pipeline->push(genesis(false)));
+    BOOST_REQUIRE_EQUAL(pipeline->pending(), 2u);
+
+    // Stopped pipelines reject pushes.
+    pipeline->stop();
+    BOOST_REQUIRE(!pipeline->push(genesis(false)));
+    pool.abort();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__stop__pending__service_stopped)
+{
+    threadpool pool;
+    collector results(2);
+
+    const auto connect = [](const block&)
+    {
+        return code(error::success);
+    };
+
+    const auto pipeline = make_pipeline(pool, results, connect);
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    BOOST_REQUIRE(pipeline->push(genesis(false)));
+    pipeline->stop();
+
+    // Start processing only after the stop.
+    pool.spawn(2);
+    const auto codes = results.wait();
+    BOOST_REQUIRE_EQUAL(codes[0], error::service_stopped);
+    BOOST_REQUIRE_EQUAL(codes[1], error::service_stopped);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(chain_state_tests)
+
+static chain::header make_header(uint32_t timestamp, uint32_t bits)
+{
+    return chain::header{ 1, null_hash, null_hash, timestamp, bits, 0 };
+}
+
+static const uint32_t genesis_time = 1231006505;
+
+// Returns the timestamp of the top header.
+static uint32_t push_spaced(chain::chain_state& state, size_t count,
+    uint32_t spacing, uint32_t bits)
+{
+    auto timestamp = genesis_time;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        state.push(make_header(timestamp, bits));
+        timestamp += spacing;
+    }
+
+    return timestamp - spacing;
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__median_time_past__unordered__expected)
+{
+    chain::chain_state state;
+    const uint32_t times[] = { 10, 30, 20, 50, 40 };
+
+    for (const auto time: times)
+        state.push(make_header(time, max_work_bits));
+
+    BOOST_REQUIRE_EQUAL(state.height(), 4u);
+    BOOST_REQUIRE_EQUAL(state.median_time_past(), 30u);
+    BOOST_REQUIRE_EQUAL(state.median_time_past(0), 10u);
+    BOOST_REQUIRE_EQUAL(state.median_time_past(2), 20u);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__median_time_past__rolling__matches_random_access)
+{
+    chain::chain_state state;
+    uint32_t time = 1000;
+
+    for (size_t height = 0; height < 100; ++height)
+    {
+        // Jitter the timestamps so the window is never sorted.
+        time += (height % 3 == 0) ? 900 : 300;
+        state.push(make_header(time - (height % 5) * 100, max_work_bits));
+        const auto streaming = state.median_time_past();
+        BOOST_REQUIRE_EQUAL(streaming, state.median_time_past(height));
+    }
+
+    const auto at_fifty = state.median_time_past(50);
+    state.pop_to(50);
+    BOOST_REQUIRE_EQUAL(state.height(), 50u);
+    BOOST_REQUIRE_EQUAL(state.median_time_past(), at_fifty);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__work_required__on_schedule__scaled_by_timespan)
+{
+    static const uint32_t bits = 0x1c0ffff0;
+    chain::chain_state state;
+    push_spaced(state, retargeting_interval, target_spacing_seconds, bits);
+
+    // Timespan excludes one interval, as in the satoshi client.
+    hash_number expected;
+    expected.set_compact(bits);
+    expected *= (retargeting_interval - 1) * target_spacing_seconds;
+    expected /= target_timespan_seconds;
+    BOOST_REQUIRE_EQUAL(state.work_required(max_uint32), expected.compact());
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__work_required__within_interval__previous_bits)
+{
+    static const uint32_t bits = 0x1c0ffff0;
+    chain::chain_state state;
+    push_spaced(state, 100, target_spacing_seconds * 10, bits);
+
+    BOOST_REQUIRE_EQUAL(state.work_required(max_uint32), bits);
+    BOOST_REQUIRE_EQUAL(state.work_required(50, max_uint32), bits);
+    BOOST_REQUIRE_EQUAL(state.work_required(0, max_uint32), max_work_bits);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__work_required__fast_blocks__target_reduced)
+{
+    static const uint32_t bits = 0x1c0ffff0;
+    chain::chain_state state;
+    push_spaced(state, retargeting_interval, target_spacing_seconds / 2, bits);
+
+    hash_number expected;
+    expected.set_compact(bits);
+    expected /= 2;
+
+    // Timespan excludes one interval, so the target is just below half.
+    hash_number actual;
+    actual.set_compact(state.work_required(max_uint32));
+    BOOST_REQUIRE(actual <= expected);
+    BOOST_REQUIRE(!(actual <= (expected / 2)));
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__work_required__slow_blocks__capped_at_max_target)
+{
+    chain::chain_state state;
+    push_spaced(state, retargeting_interval, target_spacing_seconds * 10,
+        max_work_bits);
+
+    BOOST_REQUIRE_EQUAL(state.work_required(max_uint32), max_work_bits);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__work_required__testnet_easy_block__minimum)
+{
+    static const uint32_t bits = 0x1c0ffff0;
+    chain::chain_state state(true);
+    const auto top = push_spaced(state, 10, target_spacing_seconds, bits);
+
+    BOOST_REQUIRE_EQUAL(state.work_required(top + easy_spacing_seconds + 1),
+        max_work_bits);
+
+    // An easy block does not become the reference for the next block.
+    state.push(make_header(top + easy_spacing_seconds + 1, max_work_bits));
+    BOOST_REQUIRE_EQUAL(state.work_required(top + easy_spacing_seconds + 2),
+        bits);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__check__early_timestamp__timestamp_too_early)
+{
+    chain::chain_state state;
+    push_spaced(state, 20, target_spacing_seconds, max_work_bits);
+
+    const auto header = make_header(state.median_time_past(), max_work_bits);
+    BOOST_REQUIRE_EQUAL(state.check(header), error::timestamp_too_early);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__check__wrong_bits__incorrect_proof_of_work)
+{
+    chain::chain_state state;
+    push_spaced(state, 20, target_spacing_seconds, max_work_bits);
+
+    const auto time = state.median_time_past() + 1;
+    BOOST_REQUIRE_EQUAL(state.check(make_header(time, 0x1c0ffff0)),
+        error::incorrect_proof_of_work);
+    BOOST_REQUIRE_EQUAL(state.check(make_header(time, max_work_bits)),
+        error::success);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::config;
+
+BOOST_AUTO_TEST_SUITE(checkpoint_policy_tests)
+
+#define CHECKPOINT_A "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f:0"
+#define CHECKPOINT_B "0000000069e244f73d78e8fd29ba2fd2ed618bd6fa2ee92559f542fdb26e7c1d:11111"
+#define CHECKPOINT_C "000000002dd5588a74784eaa7ab0507a18ad16a236e7b1ce69f00d7ddfb5d0a6:33333"
+
+// Deliberately unsorted.
+static const checkpoint::list checks
+{
+    checkpoint(CHECKPOINT_C),
+    checkpoint(CHECKPOINT_A),
+    checkpoint(CHECKPOINT_B)
+};
+
+BOOST_AUTO_TEST_CASE(checkpoint_policy__validate__matching_and_conflicting__expected)
+{
+    const chain::checkpoint_policy policy(checks);
+    const checkpoint b(CHECKPOINT_B);
+    BOOST_REQUIRE(policy.validate(b.hash(), b.height()));
+    BOOST_REQUIRE(policy.validate(null_hash, b.height() + 1));
+    BOOST_REQUIRE(!policy.validate(null_hash, b.height()));
+    BOOST_REQUIRE(policy.is_checkpoint(b.hash(), b.height()));
+    BOOST_REQUIRE(!policy.is_checkpoint(b.hash(), b.height() + 1));
+    BOOST_REQUIRE_EQUAL(policy.top_height(), 33333u);
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_policy__validate__empty__true)
+{
+    const chain::checkpoint_policy policy({});
+    BOOST_REQUIRE(policy.validate(null_hash, 42));
+    BOOST_REQUIRE_EQUAL(policy.top_height(), 0u);
+    BOOST_REQUIRE(policy.verify_scripts(0));
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_policy__verify_scripts__unlinked__true)
+{
+    const chain::checkpoint_policy policy(checks);
+    BOOST_REQUIRE(policy.verify_scripts(1));
+    BOOST_REQUIRE(policy.verify_scripts(33333));
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_policy__link__conflict__false_and_unlinked)
+{
+    chain::checkpoint_policy policy(checks);
+    BOOST_REQUIRE(!policy.link(null_hash, 11111));
+    BOOST_REQUIRE(policy.link(null_hash, 11112));
+    BOOST_REQUIRE(policy.verify_scripts(100));
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_policy__verify_scripts__linked__ancestors_skipped)
+{
+    chain::checkpoint_policy policy(checks);
+    const checkpoint c(CHECKPOINT_C);
+    const checkpoint b(CHECKPOINT_B);
+    BOOST_REQUIRE(policy.link(c.hash(), c.height()));
+
+    // Linking a lower checkpoint does not lower the linked height.
+    BOOST_REQUIRE(policy.link(b.hash(), b.height()));
+    BOOST_REQUIRE_EQUAL(policy.linked_height(), c.height());
+    BOOST_REQUIRE(!policy.verify_scripts(1));
+    BOOST_REQUIRE(!policy.verify_scripts(c.height()));
+    BOOST_REQUIRE(policy.verify_scripts(c.height() + 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
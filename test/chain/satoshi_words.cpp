@@ -32,7 +32,7 @@ BOOST_AUTO_TEST_CASE(satoshi_words_mainnet)
     BOOST_REQUIRE_EQUAL(block.transactions.size(), 1u);
 
     // Get first transaction in block (coinbase).
-    const bc::chain::transaction& coinbase_tx = block.transactions[0];
+    const bc::chain::transaction& coinbase_tx = *block.transactions[0];
 
     // Coinbase tx has a single input.
     BOOST_REQUIRE_EQUAL(coinbase_tx.inputs.size(), 1u);
@@ -347,4 +347,209 @@ BOOST_AUTO_TEST_CASE(case_2_factory_reader)
     BOOST_REQUIRE(resave == raw_tx);
 }
 
+// The transaction of the hash caching tests.
+static const auto cache_hash = hash_literal(
+    "bf7c3f5a69a78edd81f3eff7e93a37fb2d7da394d48db4d85e7e5353b9b8e270");
+static const auto cache_tx = to_chunk(base16_literal(
+    "0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc"
+    "4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294"
+    "789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e"
+    "2830b115472fb31de67d16972867f13945012103e589480b2f746381fca01a9b"
+    "12c517b7a482a203c8b2742985da0ac72cc078f2ffffffff02f0c9c467000000"
+    "001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00"
+    "0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000"
+    "00"));
+
+BOOST_AUTO_TEST_CASE(copy_assign_hashed_replaces_cached_hash)
+{
+    const auto tx = chain::transaction::factory_from_data(cache_tx);
+    BOOST_REQUIRE(tx.hash() == cache_hash);
+
+    chain::transaction other;
+    const auto empty_hash = other.hash();
+    BOOST_REQUIRE(empty_hash != cache_hash);
+
+    other = tx;
+    BOOST_REQUIRE(other.hash() == cache_hash);
+
+    other = chain::transaction();
+    BOOST_REQUIRE(other.hash() == empty_hash);
+}
+
+BOOST_AUTO_TEST_CASE(copy_hashed_then_mutated__hash__recomputed)
+{
+    const auto tx = chain::transaction::factory_from_data(cache_tx);
+    BOOST_REQUIRE(tx.hash() == cache_hash);
+
+    auto copy = tx;
+    copy.locktime = 42;
+    BOOST_REQUIRE(copy.hash() != cache_hash);
+    BOOST_REQUIRE(copy.hash() == bitcoin_hash(copy.to_data()));
+
+    chain::transaction assigned;
+    assigned = tx;
+    assigned.locktime = 42;
+    BOOST_REQUIRE(assigned.hash() == copy.hash());
+}
+
+BOOST_AUTO_TEST_CASE(const_ptr_shared_is_single_instance)
+{
+    const chain::transaction::const_ptr tx =
+        std::make_shared<const chain::transaction>(
+            chain::transaction::factory_from_data(cache_tx));
+
+    const chain::transaction::const_ptr_list pool{ tx };
+    const chain::transaction::const_ptr_list block{ tx };
+    BOOST_REQUIRE_EQUAL(pool.front().get(), block.front().get());
+    BOOST_REQUIRE_EQUAL(tx.use_count(), 3);
+    BOOST_REQUIRE(chain::block::generate_merkle_root(block) == cache_hash);
+}
+
+static chain::transaction make_spend(size_t inputs, uint64_t value)
+{
+    chain::transaction tx;
+    tx.version = 1;
+
+    for (size_t index = 0; index < inputs; ++index)
+    {
+        tx.inputs.emplace_back();
+        tx.inputs.back().previous_output.hash = null_hash;
+        tx.inputs.back().previous_output.hash[0] = 1;
+        tx.inputs.back().previous_output.index = static_cast<uint32_t>(index);
+        tx.inputs.back().sequence = max_input_sequence;
+    }
+
+    tx.outputs.emplace_back();
+    tx.outputs.back().value = value;
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(check_valid_returns_success)
+{
+    BOOST_REQUIRE_EQUAL(make_spend(3, 42).check(), error::success);
+    BOOST_REQUIRE_EQUAL(make_spend(40, 42).check(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(check_no_outputs_returns_empty_transaction)
+{
+    auto tx = make_spend(1, 42);
+    tx.outputs.clear();
+    BOOST_REQUIRE_EQUAL(tx.check(), error::empty_transaction);
+    BOOST_REQUIRE_EQUAL(chain::transaction().check(),
+        error::empty_transaction);
+}
+
+BOOST_AUTO_TEST_CASE(check_value_overflow_returns_output_value_overflow)
+{
+    auto tx = make_spend(1, max_money() + 1);
+    BOOST_REQUIRE_EQUAL(tx.check(), error::output_value_overflow);
+
+    // Individually valid outputs that overflow in total.
+    tx = make_spend(1, max_money());
+    tx.outputs.push_back(tx.outputs.back());
+    BOOST_REQUIRE_EQUAL(tx.check(), error::output_value_overflow);
+}
+
+BOOST_AUTO_TEST_CASE(check_duplicate_inputs_returns_double_spend)
+{
+    // Small input sets are compared pairwise.
+    auto small = make_spend(4, 42);
+    small.inputs[3].previous_output = small.inputs[1].previous_output;
+    BOOST_REQUIRE_EQUAL(small.check(), error::double_spend);
+
+    // Large input sets are sorted.
+    auto large = make_spend(100, 42);
+    large.inputs[99].previous_output = large.inputs[7].previous_output;
+    BOOST_REQUIRE_EQUAL(large.check(), error::double_spend);
+}
+
+BOOST_AUTO_TEST_CASE(check_null_previous_output_returns_previous_output_null)
+{
+    auto tx = make_spend(2, 42);
+    tx.inputs[1].previous_output.hash = null_hash;
+    tx.inputs[1].previous_output.index = max_uint32;
+    BOOST_REQUIRE_EQUAL(tx.check(), error::previous_output_null);
+}
+
+BOOST_AUTO_TEST_CASE(check_coinbase_script_size_returns_invalid_coinbase_script_size)
+{
+    auto tx = make_spend(1, 42);
+    tx.inputs[0].previous_output.hash = null_hash;
+    tx.inputs[0].previous_output.index = max_uint32;
+    BOOST_REQUIRE(tx.is_coinbase());
+    BOOST_REQUIRE_EQUAL(tx.check(), error::invalid_coinbase_script_size);
+
+    const data_chunk script{ 0x02, 0x01, 0x02 };
+    BOOST_REQUIRE(tx.inputs[0].script.from_data(script, false,
+        chain::script::parse_mode::raw_data_fallback));
+    BOOST_REQUIRE_EQUAL(tx.check(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(serialized_size_parsed_returns_consumed_size)
+{
+    const auto raw = make_spend(3, 42).to_data();
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(raw));
+    BOOST_REQUIRE_EQUAL(tx.serialized_size(), raw.size());
+
+    // Copies do not carry the cached size, so may be mutated freely.
+    auto copy = tx;
+    copy.inputs.pop_back();
+    BOOST_REQUIRE_EQUAL(copy.serialized_size(), raw.size() - 41);
+    copy = tx;
+    copy.outputs.clear();
+    BOOST_REQUIRE_EQUAL(copy.serialized_size(), copy.to_data().size());
+
+    // Mutation of a parsed transaction requires invalidation.
+    tx.inputs.pop_back();
+    tx.invalidate_cache();
+    BOOST_REQUIRE_EQUAL(tx.serialized_size(), raw.size() - 41);
+    BOOST_REQUIRE_EQUAL(tx.to_data().size(), raw.size() - 41);
+}
+
+BOOST_AUTO_TEST_CASE(serialized_size_non_minimal_count_returns_canonical_size)
+{
+    // Encode the input count (3) with a non-minimal variable integer.
+    const auto canonical = make_spend(3, 42).to_data();
+    BOOST_REQUIRE_EQUAL(canonical[4], 0x03);
+    data_chunk raw(canonical.begin(), canonical.begin() + 4);
+    extend_data(raw, data_chunk{ 0xfd, 0x03, 0x00 });
+    raw.insert(raw.end(), canonical.begin() + 5, canonical.end());
+
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(raw));
+    BOOST_REQUIRE_EQUAL(tx.serialized_size(), canonical.size());
+    BOOST_REQUIRE(tx.to_data() == canonical);
+}
+
+BOOST_AUTO_TEST_CASE(from_data_hostile_input_count_returns_failure)
+{
+    // A version followed by a maximal input count and nothing more.
+    const data_chunk raw
+    {
+        0x01, 0x00, 0x00, 0x00,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+    };
+
+    chain::transaction tx;
+    BOOST_REQUIRE(!tx.from_data(raw));
+    BOOST_REQUIRE(tx.inputs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(signature_operations_counts_legacy_sigops)
+{
+    chain::transaction tx;
+    tx.inputs.emplace_back();
+    tx.inputs.back().script.operations.push_back(
+        { chain::opcode::checksigverify, {} });
+    tx.outputs.emplace_back();
+    tx.outputs.back().script.operations.push_back(
+        { chain::opcode::checksig, {} });
+    tx.outputs.emplace_back();
+    tx.outputs.back().script.operations.push_back(
+        { chain::opcode::checkmultisig, {} });
+    BOOST_REQUIRE_EQUAL(tx.signature_operations(),
+        2u + multisig_default_sigops);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
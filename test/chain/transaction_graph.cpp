@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(transaction_graph_tests)
+
+static transaction::const_ptr make_coinbase()
+{
+    const auto tx = std::make_shared<transaction>();
+    tx->version = 1;
+    tx->inputs.emplace_back();
+    tx->inputs.back().previous_output.hash = null_hash;
+    tx->inputs.back().previous_output.index = max_uint32;
+    tx->outputs.emplace_back();
+    return tx;
+}
+
+// The version distinguishes otherwise identical transactions.
+static transaction::const_ptr make_spend(uint32_t version,
+    const point::list& points)
+{
+    const auto tx = std::make_shared<transaction>();
+    tx->version = version;
+
+    for (const auto& point: points)
+    {
+        tx->inputs.emplace_back();
+        tx->inputs.back().previous_output = point;
+    }
+
+    tx->outputs.emplace_back();
+    tx->outputs.emplace_back();
+    return tx;
+}
+
+static point make_point(transaction::const_ptr tx, uint32_t index)
+{
+    return point{ tx->hash(), index };
+}
+
+static const point external_point{ null_hash, 0 };
+
+BOOST_AUTO_TEST_CASE(transaction_graph__levels__independent__single_level)
+{
+    transaction::const_ptr_list txs;
+    txs.push_back(make_coinbase());
+    txs.push_back(make_spend(1, { external_point }));
+    txs.push_back(make_spend(2, { external_point }));
+
+    const transaction_graph graph(txs);
+    BOOST_REQUIRE(graph.is_valid());
+    BOOST_REQUIRE_EQUAL(graph.size(), 3u);
+    BOOST_REQUIRE_EQUAL(graph.levels().size(), 1u);
+    BOOST_REQUIRE_EQUAL(graph.levels()[0].size(), 3u);
+    BOOST_REQUIRE_EQUAL(graph.source(0, 0), transaction_graph::external);
+    BOOST_REQUIRE_EQUAL(graph.source(2, 0), transaction_graph::external);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_graph__levels__chain_and_fan_in__expected)
+{
+    transaction::const_ptr_list txs;
+    txs.push_back(make_coinbase());
+    txs.push_back(make_spend(1, { external_point }));
+    txs.push_back(make_spend(2, { make_point(txs[1], 0) }));
+    txs.push_back(make_spend(3, { make_point(txs[2], 0) }));
+    txs.push_back(make_spend(4, { make_point(txs[1], 1),
+        make_point(txs[3], 0), make_point(txs[3], 1) }));
+    txs.push_back(make_spend(5, { external_point }));
+
+    const transaction_graph graph(txs);
+    BOOST_REQUIRE(graph.is_valid());
+    BOOST_REQUIRE_EQUAL(graph.level(1), 0u);
+    BOOST_REQUIRE_EQUAL(graph.level(2), 1u);
+    BOOST_REQUIRE_EQUAL(graph.level(3), 2u);
+    BOOST_REQUIRE_EQUAL(graph.level(4), 3u);
+    BOOST_REQUIRE_EQUAL(graph.level(5), 0u);
+
+    const transaction_graph::level_list expected
+    {
+        { 0, 1, 5 }, { 2 }, { 3 }, { 4 }
+    };
+
+    BOOST_REQUIRE(graph.levels() == expected);
+
+    // Parents are distinct, sources are per input.
+    BOOST_REQUIRE(graph.parents(4) == transaction_graph::indexes({ 1, 3 }));
+    BOOST_REQUIRE_EQUAL(graph.source(4, 0), 1u);
+    BOOST_REQUIRE_EQUAL(graph.source(4, 1), 3u);
+    BOOST_REQUIRE_EQUAL(graph.source(4, 2), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_graph__parents__unordered_repeated__sorted_distinct)
+{
+    transaction::const_ptr_list txs;
+    txs.push_back(make_coinbase());
+    txs.push_back(make_spend(1, { external_point }));
+    txs.push_back(make_spend(2, { external_point }));
+    txs.push_back(make_spend(3, { make_point(txs[2], 0),
+        make_point(txs[1], 0), make_point(txs[2], 1),
+        make_point(txs[1], 1) }));
+
+    const transaction_graph graph(txs);
+    BOOST_REQUIRE(graph.is_valid());
+    BOOST_REQUIRE(graph.parents(3) == transaction_graph::indexes({ 1, 2 }));
+    BOOST_REQUIRE_EQUAL(graph.source(3, 0), 2u);
+    BOOST_REQUIRE_EQUAL(graph.source(3, 1), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_graph__is_valid__forward_spend__false)
+{
+    transaction::const_ptr_list txs;
+    txs.push_back(make_coinbase());
+    txs.push_back(make_spend(1, { external_point }));
+    txs.push_back(make_spend(2, { external_point }));
+
+    // The first spend now spends the (unchanged) second.
+    txs[1] = make_spend(1, { make_point(txs[2], 0) });
+
+    const transaction_graph graph(txs);
+    BOOST_REQUIRE(!graph.is_valid());
+    BOOST_REQUIRE_EQUAL(graph.source(1, 0), 2u);
+    BOOST_REQUIRE(graph.parents(1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_graph__levels__empty__empty)
+{
+    const transaction_graph graph(transaction::const_ptr_list{});
+    BOOST_REQUIRE(graph.is_valid());
+    BOOST_REQUIRE_EQUAL(graph.size(), 0u);
+    BOOST_REQUIRE(graph.levels().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
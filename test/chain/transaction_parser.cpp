@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(transaction_parser_tests)
+
+// Two inputs (one with a script over 252 bytes) and two outputs.
+static transaction make_transaction()
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = 42;
+    tx.inputs.resize(2);
+    tx.outputs.resize(2);
+    tx.inputs[0].previous_output.hash[0] = 1;
+    tx.inputs[1].previous_output.index = 7;
+    tx.outputs[0].value = 1000;
+    tx.outputs[1].value = 2000;
+
+    const data_chunk script(300, 0x51);
+    BOOST_REQUIRE(tx.inputs[1].script.from_data(script, false,
+        script::parse_mode::raw_data_fallback));
+    BOOST_REQUIRE(tx.outputs[1].script.from_data(data_chunk{ 0x51 }, false,
+        script::parse_mode::raw_data_fallback));
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(transaction_parser__write__byte_at_a_time__expected)
+{
+    const auto tx = make_transaction();
+    const auto raw = tx.to_data();
+    transaction_parser parser;
+
+    for (size_t index = 0; index < raw.size(); ++index)
+    {
+        BOOST_REQUIRE(!parser.complete());
+        BOOST_REQUIRE_EQUAL(parser.write(data_slice(&raw[index],
+            &raw[index] + 1)), 1u);
+    }
+
+    BOOST_REQUIRE(parser.complete());
+    BOOST_REQUIRE_EQUAL(parser.error(), error::success);
+    BOOST_REQUIRE_EQUAL(parser.size(), raw.size());
+    BOOST_REQUIRE(parser.hash() == tx.hash());
+    BOOST_REQUIRE(parser.result()->hash() == tx.hash());
+    BOOST_REQUIRE(parser.result()->to_data() == raw);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_parser__write__trailing_bytes__not_consumed)
+{
+    const auto tx = make_transaction();
+    auto raw = tx.to_data();
+    const auto size = raw.size();
+    raw.resize(size + 10, 0xff);
+
+    transaction_parser parser;
+    BOOST_REQUIRE_EQUAL(parser.write(raw), size);
+    BOOST_REQUIRE(parser.complete());
+    BOOST_REQUIRE(parser.hash() == tx.hash());
+
+    parser.reset();
+    BOOST_REQUIRE(!parser.complete());
+    BOOST_REQUIRE_EQUAL(parser.write(data_slice(raw.data(),
+        raw.data() + size)), size);
+    BOOST_REQUIRE(parser.complete());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_parser__write__non_minimal_count__canonical_hash)
+{
+    // Encode the input count (2) with a non-minimal variable integer.
+    const auto tx = make_transaction();
+    const auto canonical = tx.to_data();
+    BOOST_REQUIRE_EQUAL(canonical[4], 0x02);
+    data_chunk raw(canonical.begin(), canonical.begin() + 4);
+    extend_data(raw, data_chunk{ 0xfd, 0x02, 0x00 });
+    raw.insert(raw.end(), canonical.begin() + 5, canonical.end());
+
+    transaction_parser parser;
+    BOOST_REQUIRE_EQUAL(parser.write(raw), raw.size());
+    BOOST_REQUIRE(parser.complete());
+    BOOST_REQUIRE_EQUAL(parser.size(), raw.size());
+    BOOST_REQUIRE(parser.hash() != bitcoin_hash(raw));
+    BOOST_REQUIRE(parser.hash() == tx.hash());
+    BOOST_REQUIRE(parser.result()->hash() == tx.hash());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_parser__write__oversized_input_count__size_limits)
+{
+    // Version followed by an input count that cannot fit in a block.
+    const data_chunk raw{ 0x01, 0x00, 0x00, 0x00, 0xfe, 0x00, 0x00, 0x01,
+        0x00 };
+    transaction_parser parser;
+    BOOST_REQUIRE_EQUAL(parser.write(raw), raw.size());
+    BOOST_REQUIRE(!parser.complete());
+    BOOST_REQUIRE_EQUAL(parser.error(), error::size_limits);
+    BOOST_REQUIRE_EQUAL(parser.write(raw), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(transaction_pool_tests)
+
+// The version distinguishes otherwise identical transactions.
+static transaction::const_ptr make_spend(uint32_t version,
+    const point::list& points)
+{
+    const auto tx = std::make_shared<transaction>();
+    tx->version = version;
+
+    for (const auto& point: points)
+    {
+        tx->inputs.emplace_back();
+        tx->inputs.back().previous_output = point;
+    }
+
+    tx->outputs.emplace_back();
+    tx->outputs.emplace_back();
+    return tx;
+}
+
+static point external(uint32_t index)
+{
+    return point{ null_hash, index };
+}
+
+static point make_point(transaction::const_ptr tx, uint32_t index)
+{
+    return point{ tx->hash(), index };
+}
+
+static const uint64_t unlimited = max_uint64;
+
+BOOST_AUTO_TEST_CASE(transaction_pool__store__independent__filter_by_fee_rate)
+{
+    transaction_pool pool(unlimited);
+    const auto low = make_spend(1, { external(0) });
+    const auto high = make_spend(2, { external(1) });
+    BOOST_REQUIRE_EQUAL(pool.store(low, 1000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(high, 2000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.size(), 2u);
+    BOOST_REQUIRE_EQUAL(pool.bytes(),
+        low->serialized_size() + high->serialized_size());
+
+    const auto all = pool.filter(0);
+    BOOST_REQUIRE_EQUAL(all.size(), 2u);
+    BOOST_REQUIRE(all[0] == high->hash());
+    BOOST_REQUIRE(all[1] == low->hash());
+
+    const auto high_rate = pool.find(high->hash())->rate();
+    BOOST_REQUIRE_EQUAL(high_rate, 2000u * 1000u / high->serialized_size());
+    const auto passed = pool.filter(high_rate);
+    BOOST_REQUIRE_EQUAL(passed.size(), 1u);
+    BOOST_REQUIRE(passed[0] == high->hash());
+    BOOST_REQUIRE(pool.filter(high_rate + 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__store__rejected__expected_codes)
+{
+    transaction_pool pool(unlimited);
+    const auto tx = make_spend(1, { external(0) });
+    const auto conflict = make_spend(2, { external(0) });
+    const auto coinbase = make_spend(3, { point{ null_hash, max_uint32 } });
+    BOOST_REQUIRE_EQUAL(pool.store(tx, 1000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(tx, 1000), error::duplicate);
+    BOOST_REQUIRE_EQUAL(pool.store(conflict, 5000), error::double_spend);
+    BOOST_REQUIRE_EQUAL(pool.store(coinbase, 0),
+        error::coinbase_transaction);
+    BOOST_REQUIRE_EQUAL(pool.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__store__chain__packages_linked)
+{
+    transaction_pool pool(unlimited);
+    const auto parent = make_spend(1, { external(0) });
+    const auto child = make_spend(2, { make_point(parent, 0),
+        make_point(parent, 1) });
+    BOOST_REQUIRE_EQUAL(pool.store(parent, 100), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(child, 900), error::success);
+
+    const auto& up = *pool.find(parent->hash());
+    const auto& down = *pool.find(child->hash());
+    BOOST_REQUIRE_EQUAL(up.descendants.count, 2u);
+    BOOST_REQUIRE_EQUAL(up.descendants.fee, 1000u);
+    BOOST_REQUIRE_EQUAL(up.ancestors.count, 1u);
+    BOOST_REQUIRE_EQUAL(down.ancestors.count, 2u);
+    BOOST_REQUIRE_EQUAL(down.ancestors.size,
+        parent->serialized_size() + child->serialized_size());
+    BOOST_REQUIRE_EQUAL(down.parents.size(), 1u);
+    BOOST_REQUIRE(down.parents[0] == parent->hash());
+    BOOST_REQUIRE_EQUAL(up.children.size(), 1u);
+
+    hash_digest spender;
+    BOOST_REQUIRE(pool.spender(spender, make_point(parent, 1)));
+    BOOST_REQUIRE(spender == child->hash());
+    BOOST_REQUIRE(!pool.spender(spender, make_point(child, 0)));
+
+    // The child is scored by its package, as it must pay for its parent.
+    const auto& best = *pool.ancestor_scores().rbegin();
+    BOOST_REQUIRE(best.second == child->hash());
+    BOOST_REQUIRE_EQUAL(best.first, down.ancestors.rate());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__store__package_limit__size_limits)
+{
+    transaction_pool pool(unlimited);
+    auto tx = make_spend(0, { external(0) });
+    BOOST_REQUIRE_EQUAL(pool.store(tx, 1000), error::success);
+
+    for (uint32_t depth = 1; depth < transaction_pool::max_package_count;
+        ++depth)
+    {
+        tx = make_spend(depth, { make_point(tx, 0) });
+        BOOST_REQUIRE_EQUAL(pool.store(tx, 1000), error::success);
+    }
+
+    const auto excess = make_spend(99, { make_point(tx, 0) });
+    BOOST_REQUIRE_EQUAL(pool.store(excess, 1000), error::size_limits);
+    BOOST_REQUIRE_EQUAL(pool.size(), transaction_pool::max_package_count);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__store__over_budget__lowest_package_evicted)
+{
+    const auto parent = make_spend(1, { external(0) });
+    const auto child = make_spend(2, { make_point(parent, 0) });
+    const auto other = make_spend(3, { external(1) });
+    const auto arrival = make_spend(4, { external(2) });
+    const auto size = parent->serialized_size();
+    BOOST_REQUIRE_EQUAL(child->serialized_size(), size);
+
+    transaction_pool pool(3 * size);
+    BOOST_REQUIRE_EQUAL(pool.store(parent, 50), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(child, 60), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(other, 5000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(arrival, 5000), error::success);
+
+    // The parent is evicted with its descendants.
+    BOOST_REQUIRE_EQUAL(pool.size(), 2u);
+    BOOST_REQUIRE(!pool.exists(parent->hash()));
+    BOOST_REQUIRE(!pool.exists(child->hash()));
+    BOOST_REQUIRE_EQUAL(pool.bytes(), 2 * size);
+
+    hash_digest spender;
+    BOOST_REQUIRE(!pool.spender(spender, external(0)));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__store__lowest_when_full__pool_filled)
+{
+    const auto first = make_spend(1, { external(0) });
+    const auto cheap = make_spend(2, { external(1) });
+    transaction_pool pool(first->serialized_size());
+    BOOST_REQUIRE_EQUAL(pool.store(first, 5000), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(cheap, 10), error::pool_filled);
+    BOOST_REQUIRE_EQUAL(pool.size(), 1u);
+    BOOST_REQUIRE(pool.exists(first->hash()));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__remove__block__confirmed_and_conflicts_removed)
+{
+    transaction_pool pool(unlimited);
+    const auto parent = make_spend(1, { external(0) });
+    const auto child = make_spend(2, { make_point(parent, 0) });
+    const auto loser = make_spend(3, { external(1) });
+    const auto orphan = make_spend(4, { make_point(loser, 0) });
+    BOOST_REQUIRE_EQUAL(pool.store(parent, 100), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(child, 200), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(loser, 300), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(orphan, 400), error::success);
+
+    // The block confirms the parent and a conflict of the loser.
+    block confirmed;
+    confirmed.transactions.push_back(make_spend(0,
+        { point{ null_hash, max_uint32 } }));
+    confirmed.transactions.push_back(make_spend(1, { external(0) }));
+    confirmed.transactions.push_back(make_spend(5, { external(1) }));
+    pool.remove(confirmed);
+
+    BOOST_REQUIRE_EQUAL(pool.size(), 1u);
+    const auto& remaining = *pool.find(child->hash());
+    BOOST_REQUIRE(remaining.parents.empty());
+    BOOST_REQUIRE_EQUAL(remaining.ancestors.count, 1u);
+    BOOST_REQUIRE_EQUAL(remaining.ancestors.fee, 200u);
+    BOOST_REQUIRE_EQUAL(pool.bytes(), child->serialized_size());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__remove__hash__descendants_removed)
+{
+    transaction_pool pool(unlimited);
+    const auto parent = make_spend(1, { external(0) });
+    const auto child = make_spend(2, { make_point(parent, 0) });
+    BOOST_REQUIRE_EQUAL(pool.store(parent, 100), error::success);
+    BOOST_REQUIRE_EQUAL(pool.store(child, 200), error::success);
+    BOOST_REQUIRE(pool.remove(parent->hash()));
+    BOOST_REQUIRE(!pool.remove(parent->hash()));
+    BOOST_REQUIRE_EQUAL(pool.size(), 0u);
+    BOOST_REQUIRE_EQUAL(pool.bytes(), 0u);
+    BOOST_REQUIRE(pool.ancestor_scores().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
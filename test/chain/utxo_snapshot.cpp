@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(utxo_snapshot_tests)
+
+static chain::utxo_record make_record(uint8_t hash, uint32_t index)
+{
+    chain::utxo_record record;
+    record.point.hash = null_hash;
+    record.point.hash[0] = hash;
+    record.point.index = index;
+    record.height = 1000u + hash;
+    record.coinbase = index == 0;
+    record.output.value = 50 * 100000000ull + index;
+    return record;
+}
+
+static chain::utxo_record::list make_records(size_t count)
+{
+    chain::utxo_record::list records;
+
+    for (size_t index = 0; index < count; ++index)
+        records.push_back(make_record(static_cast<uint8_t>(index / 3),
+            static_cast<uint32_t>(index % 3)));
+
+    return records;
+}
+
+static chain::snapshot_header make_header(
+    const chain::utxo_record::list& records)
+{
+    multiset_hash commitment;
+
+    for (const auto& record: records)
+        commitment.insert(record.to_data());
+
+    chain::snapshot_header header;
+    header.version = chain::snapshot_header::current_version;
+    header.height = 42;
+    header.block_hash = null_hash;
+    header.commitment = commitment.digest();
+    header.count = records.size();
+    return header;
+}
+
+static std::string write_snapshot(const chain::utxo_record::list& records,
+    size_t chunk_records)
+{
+    std::ostringstream stream;
+    chain::snapshot_writer writer(stream, make_header(records), chunk_records);
+
+    for (const auto& record: records)
+        BOOST_REQUIRE(writer.write(record));
+
+    BOOST_REQUIRE(writer.finish());
+    return stream.str();
+}
+
+BOOST_AUTO_TEST_CASE(utxo_record__from_data__round_trip__equal)
+{
+    const auto expected = make_record(7, 3);
+    const auto data = expected.to_data();
+    BOOST_REQUIRE_EQUAL(data.size(), expected.serialized_size());
+
+    data_source stream(data);
+    istream_reader source(stream);
+    chain::utxo_record record;
+    BOOST_REQUIRE(record.from_data(source));
+    BOOST_REQUIRE(record.point == expected.point);
+    BOOST_REQUIRE_EQUAL(record.height, expected.height);
+    BOOST_REQUIRE_EQUAL(record.coinbase, expected.coinbase);
+    BOOST_REQUIRE_EQUAL(record.output.value, expected.output.value);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_reader__read__chunked__streams_all_records)
+{
+    const auto records = make_records(10);
+    std::istringstream stream(write_snapshot(records, 4));
+    chain::snapshot_reader reader(stream);
+    BOOST_REQUIRE(reader.start());
+    BOOST_REQUIRE_EQUAL(reader.header().height, 42u);
+    BOOST_REQUIRE_EQUAL(reader.header().count, 10u);
+
+    size_t chunks = 0;
+    size_t loaded = 0;
+    chain::utxo_record::list chunk;
+
+    while (reader.read(chunk))
+    {
+        BOOST_REQUIRE(chunk.size() <= 4u);
+        for (const auto& record: chunk)
+            BOOST_REQUIRE(record.point == records[loaded++].point);
+
+        ++chunks;
+    }
+
+    BOOST_REQUIRE_EQUAL(chunks, 3u);
+    BOOST_REQUIRE_EQUAL(loaded, records.size());
+    BOOST_REQUIRE(reader.complete());
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_reader__read__wrong_commitment__not_complete)
+{
+    const auto records = make_records(5);
+    auto header = make_header(records);
+    header.commitment[0] ^= 1;
+
+    std::ostringstream out;
+    chain::snapshot_writer writer(out, header);
+
+    for (const auto& record: records)
+        BOOST_REQUIRE(writer.write(record));
+
+    BOOST_REQUIRE(!writer.finish());
+
+    std::istringstream stream(out.str());
+    chain::snapshot_reader reader(stream);
+    BOOST_REQUIRE(reader.start());
+
+    chain::utxo_record::list chunk;
+    BOOST_REQUIRE(!reader.read(chunk));
+    BOOST_REQUIRE(!reader.complete());
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_reader__read__truncated__not_complete)
+{
+    const auto data = write_snapshot(make_records(10), 4);
+    std::istringstream stream(data.substr(0, data.size() - 1));
+    chain::snapshot_reader reader(stream);
+    BOOST_REQUIRE(reader.start());
+
+    chain::utxo_record::list chunk;
+    while (reader.read(chunk));
+    BOOST_REQUIRE(!reader.complete());
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_writer__write__unsorted__false)
+{
+    const auto records = make_records(2);
+    std::ostringstream stream;
+    chain::snapshot_writer writer(stream, make_header(records));
+    BOOST_REQUIRE(writer.write(records[1]));
+    BOOST_REQUIRE(!writer.write(records[0]));
+    BOOST_REQUIRE(!writer.write(records[1]));
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_reader__start__empty_set__complete)
+{
+    const auto data = write_snapshot({}, 4);
+    BOOST_REQUIRE_EQUAL(data.size(),
+        chain::snapshot_header::satoshi_fixed_size);
+
+    std::istringstream stream(data);
+    chain::snapshot_reader reader(stream);
+    BOOST_REQUIRE(reader.start());
+
+    chain::utxo_record::list chunk;
+    BOOST_REQUIRE(!reader.read(chunk));
+    BOOST_REQUIRE(reader.complete());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -98,4 +98,47 @@ BOOST_AUTO_TEST_CASE(pkcs5_pbkdf2_hmac_sha512_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(siphash_test)
+{
+    // Reference vectors: key 00..0f and message 00..(length - 1).
+    half_hash key;
+    data_chunk message(15);
+
+    for (size_t index = 0; index < key.size(); ++index)
+        key[index] = static_cast<uint8_t>(index);
+
+    for (size_t index = 0; index < message.size(); ++index)
+        message[index] = static_cast<uint8_t>(index);
+
+    const auto prefix = [&message](size_t size)
+    {
+        return data_chunk(message.begin(), message.begin() + size);
+    };
+
+    BOOST_REQUIRE_EQUAL(siphash(key, prefix(0)), 0x726fdb47dd0e0e31u);
+    BOOST_REQUIRE_EQUAL(siphash(key, prefix(8)), 0x93f5f5799a932462u);
+    BOOST_REQUIRE_EQUAL(siphash(key, prefix(15)), 0xa129ca6149be45e5u);
+}
+
+BOOST_AUTO_TEST_CASE(murmur3_test)
+{
+    BOOST_REQUIRE_EQUAL(murmur3(data_chunk{}, 0x00000000), 0x00000000u);
+    BOOST_REQUIRE_EQUAL(murmur3(data_chunk{}, 0xfba4c795), 0x6a396f08u);
+    BOOST_REQUIRE_EQUAL(murmur3(data_chunk{}, 0xffffffff), 0x81f16f39u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("00"), 0x00000000),
+        0x514e28b7u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("00"), 0xfba4c795),
+        0xea3f0b17u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("ff"), 0x00000000),
+        0xfd6cf10du);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("0011"), 0x00000000),
+        0x16c6b7abu);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("001122"), 0x00000000),
+        0x8eb51c3du);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("00112233"), 0x00000000),
+        0xb4471bf8u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("0011223344"), 0x00000000),
+        0xe2301fa8u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(multiset_hash_tests)
+
+static const data_chunk alpha{ 'a' };
+static const data_chunk beta{ 'b' };
+static const data_chunk gamma{ 'c' };
+
+BOOST_AUTO_TEST_CASE(multiset_hash__digest__empty__hash_of_one)
+{
+    // The little endian 3072 bit integer one.
+    data_chunk one(384, 0);
+    one[0] = 1;
+    BOOST_REQUIRE(multiset_hash().digest() == sha256_hash(one));
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__insert__any_order__same_digest)
+{
+    multiset_hash forward;
+    forward.insert(alpha);
+    forward.insert(beta);
+    forward.insert(gamma);
+
+    multiset_hash reverse;
+    reverse.insert(gamma);
+    reverse.insert(beta);
+    reverse.insert(alpha);
+
+    BOOST_REQUIRE(forward == reverse);
+    BOOST_REQUIRE(forward.digest() == reverse.digest());
+    BOOST_REQUIRE(forward != multiset_hash());
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__insert__duplicate__not_set_semantics)
+{
+    multiset_hash once;
+    once.insert(alpha);
+
+    multiset_hash twice;
+    twice.insert(alpha);
+    twice.insert(alpha);
+
+    BOOST_REQUIRE(once != twice);
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__remove__inserted__restores_digest)
+{
+    multiset_hash expected;
+    expected.insert(alpha);
+
+    multiset_hash instance;
+    instance.insert(beta);
+    instance.insert(alpha);
+    instance.remove(beta);
+
+    BOOST_REQUIRE(instance == expected);
+    BOOST_REQUIRE(instance.digest() == expected.digest());
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__operators__block_delta__matches_direct)
+{
+    multiset_hash set;
+    set.insert(alpha);
+    set.insert(beta);
+
+    // A block that spends beta and creates gamma.
+    multiset_hash created;
+    created.insert(gamma);
+    multiset_hash spent;
+    spent.insert(beta);
+
+    set += created;
+    set -= spent;
+
+    multiset_hash expected;
+    expected.insert(gamma);
+    expected.insert(alpha);
+    BOOST_REQUIRE(set.digest() == expected.digest());
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__from_data__round_trip__equal)
+{
+    multiset_hash instance;
+    instance.insert(alpha);
+    instance.remove(gamma);
+
+    multiset_hash copy;
+    BOOST_REQUIRE(copy.from_data(instance.to_data()));
+    BOOST_REQUIRE(copy == instance);
+    BOOST_REQUIRE(copy.digest() == instance.digest());
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__from_data__zero__false)
+{
+    const data_chunk zero(2 * 384, 0);
+    multiset_hash instance;
+    BOOST_REQUIRE(!instance.from_data(zero));
+    BOOST_REQUIRE(instance == multiset_hash());
+}
+
+BOOST_AUTO_TEST_CASE(multiset_hash__from_data__wrong_size__false)
+{
+    multiset_hash state;
+    state.insert(alpha);
+    auto data = state.to_data();
+    BOOST_REQUIRE_EQUAL(data.size(), 2u * 384u);
+
+    data.pop_back();
+    multiset_hash instance;
+    BOOST_REQUIRE(!instance.from_data(data));
+    BOOST_REQUIRE(instance == multiset_hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(address_table_tests)
+
+static const half_hash salt
+{
+    {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    }
+};
+
+static const uint32_t timestamp = 1450000000;
+
+// The time of each store, unless the test advances it.
+static const uint32_t now = timestamp;
+
+// A distinct IPv4 address for each value.
+static network_address make_address(uint32_t value,
+    uint32_t time=timestamp)
+{
+    auto ip = unspecified_ip_address;
+    ip[12] = static_cast<uint8_t>(value >> 24);
+    ip[13] = static_cast<uint8_t>(value >> 16);
+    ip[14] = static_cast<uint8_t>(value >> 8);
+    ip[15] = static_cast<uint8_t>(value);
+    return{ time, services::node_network, ip, 8333 };
+}
+
+static const ip_address source = localhost_ip_address;
+
+BOOST_AUTO_TEST_CASE(address_table__store__stored__refreshed_in_place)
+{
+    address_table table(salt);
+    BOOST_REQUIRE(table.store(make_address(42), source, now));
+    BOOST_REQUIRE(table.exists(make_address(42)));
+    BOOST_REQUIRE(!table.exists(make_address(43)));
+
+    auto newer = make_address(42, timestamp + 100);
+    newer.services = services::bloom_filters;
+    BOOST_REQUIRE(!table.store(newer, source, now));
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+
+    network_address sampled;
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.timestamp, timestamp + 100);
+    BOOST_REQUIRE_EQUAL(sampled.services,
+        services::node_network | services::bloom_filters);
+
+    // An older announcement does not roll back the timestamp.
+    BOOST_REQUIRE(!table.store(make_address(42), source, now));
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.timestamp, timestamp + 100);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__remove__stored__removed)
+{
+    address_table table(salt);
+    BOOST_REQUIRE(table.store(make_address(1), source, now));
+    BOOST_REQUIRE(table.store(make_address(2), source, now));
+    BOOST_REQUIRE(table.remove(make_address(1)));
+    BOOST_REQUIRE(!table.remove(make_address(1)));
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+    BOOST_REQUIRE(table.exists(make_address(2)));
+
+    network_address sampled;
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.ip[15], 2u);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__sample__stored__each_sampled)
+{
+    address_table table(salt);
+    network_address sampled;
+    BOOST_REQUIRE(!table.sample(sampled));
+
+    for (uint32_t value = 0; value < 4; ++value)
+        BOOST_REQUIRE(table.store(make_address(value << 24), source, now));
+
+    bool seen[4] = { false, false, false, false };
+
+    for (size_t count = 0; count < 400; ++count)
+    {
+        BOOST_REQUIRE(table.sample(sampled));
+        seen[sampled.ip[12]] = true;
+    }
+
+    BOOST_REQUIRE(seen[0] && seen[1] && seen[2] && seen[3]);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__store__address_message__one_source_limited)
+{
+    address_table table(salt);
+    address message;
+
+    for (uint32_t value = 0; value < 20000; ++value)
+        message.addresses.push_back(make_address(value * 7919));
+
+    const auto added = table.store(message, source, now);
+    BOOST_REQUIRE_EQUAL(added, table.size());
+    BOOST_REQUIRE(added > 0u);
+    BOOST_REQUIRE(added <= address_table::buckets_per_group *
+        address_table::bucket_size);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__store__occupied_slot__stale_displaced)
+{
+    address_table table(salt);
+    uint32_t value = 0;
+
+    // Find an address whose slot is occupied.
+    while (table.store(make_address(value), source, now))
+        ++value;
+
+    const auto size = table.size();
+    BOOST_REQUIRE(!table.exists(make_address(value)));
+
+    // Staleness is judged at the time of the store, not by the claimed time.
+    const auto later = now + address_table::stale_seconds;
+    BOOST_REQUIRE(!table.store(make_address(value, later + 1), source, now));
+    BOOST_REQUIRE(!table.store(make_address(value, later), source, later));
+    BOOST_REQUIRE(table.store(make_address(value, later), source, later + 1));
+    BOOST_REQUIRE(table.exists(make_address(value)));
+    BOOST_REQUIRE_EQUAL(table.size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__store__implausible_timestamps__penalized)
+{
+    address_table table(salt);
+    const auto penalized = now - address_table::penalty_seconds;
+    const auto future = now + address_table::future_seconds;
+    network_address sampled;
+
+    BOOST_REQUIRE(table.store(make_address(1, future), source, now));
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.timestamp, future);
+    BOOST_REQUIRE(table.remove(make_address(1)));
+
+    BOOST_REQUIRE(table.store(make_address(1, future + 1), source, now));
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.timestamp, penalized);
+    BOOST_REQUIRE(table.remove(make_address(1)));
+
+    BOOST_REQUIRE(table.store(make_address(1, 0), source, now));
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.timestamp, penalized);
+
+    // A refresh is clamped as well.
+    BOOST_REQUIRE(!table.store(make_address(1, max_uint32), source, now));
+    BOOST_REQUIRE(table.sample(sampled));
+    BOOST_REQUIRE_EQUAL(sampled.timestamp, penalized);
+}
+
+BOOST_AUTO_TEST_CASE(address_table__from_data__to_data__round_trip)
+{
+    address_table table;
+
+    for (uint32_t value = 0; value < 100; ++value)
+        table.store(make_address(value << 16), make_address(value).ip, now);
+
+    const auto data = table.to_data();
+    BOOST_REQUIRE_EQUAL(data.size(), table.serialized_size());
+    BOOST_REQUIRE_EQUAL(data.size(), 1u + half_hash_size +
+        variable_uint_size(table.size()) + table.size() * 34u);
+
+    address_table loaded(salt);
+    BOOST_REQUIRE(loaded.from_data(data));
+    BOOST_REQUIRE_EQUAL(loaded.size(), table.size());
+    BOOST_REQUIRE(loaded.to_data() == data);
+
+    // The salt is restored, so the buckets are the same.
+    const auto fresh = make_address(0xffffffff);
+    BOOST_REQUIRE_EQUAL(table.store(fresh, source, now),
+        loaded.store(fresh, source, now));
+    BOOST_REQUIRE(table.to_data() == loaded.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(address_table__from_data__invalid__failure_and_empty)
+{
+    address_table table(salt);
+    BOOST_REQUIRE(table.store(make_address(1), source, now));
+    auto data = table.to_data();
+
+    address_table loaded(salt);
+    BOOST_REQUIRE(loaded.store(make_address(2), source, now));
+
+    data.front() = 0x42;
+    BOOST_REQUIRE(!loaded.from_data(data));
+    BOOST_REQUIRE_EQUAL(loaded.size(), 0u);
+
+    data = table.to_data();
+    data.pop_back();
+    BOOST_REQUIRE(!loaded.from_data(data));
+    BOOST_REQUIRE_EQUAL(loaded.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(block_reconstructor_tests)
+
+static const uint64_t nonce = 42;
+
+// A block of the genesis coinbase and count distinct transactions.
+static chain::block make_block(size_t count)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    chain::transaction::const_ptr_list transactions
+    {
+        genesis.transactions.front()
+    };
+
+    for (size_t index = 0; index < count; ++index)
+        transactions.push_back(std::make_shared<const chain::transaction>(1,
+            static_cast<uint32_t>(index), chain::input::list{},
+            chain::output::list{}));
+
+    chain::header header(genesis.header);
+    header.merkle = chain::block::generate_merkle_root(transactions);
+    header.transaction_count = transactions.size();
+    return chain::block(header, transactions);
+}
+
+static chain::transaction::const_ptr_list make_pool(
+    const chain::block& block, size_t begin, size_t end)
+{
+    chain::transaction::const_ptr_list pool;
+
+    for (auto index = begin; index < end; ++index)
+        pool.push_back(block.transactions[index]);
+
+    return pool;
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__fill__full_pool__reconstructed)
+{
+    const auto block = make_block(10);
+    const auto compact = compact_block::factory_from_block(block, nonce);
+
+    block_reconstructor instance;
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::success);
+    BOOST_REQUIRE_EQUAL(instance.missing(), 10u);
+
+    // Reverse the pool and add unrelated transactions.
+    auto pool = make_pool(block, 1, 11);
+    std::reverse(pool.begin(), pool.end());
+    const auto other = make_block(20);
+    const auto unrelated = make_pool(other, 15, 21);
+    pool.insert(pool.end(), unrelated.begin(), unrelated.end());
+
+    BOOST_REQUIRE_EQUAL(instance.fill(pool), 10u);
+    BOOST_REQUIRE(instance.complete());
+
+    chain::block result;
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result), error::success);
+    BOOST_REQUIRE(result.to_data() == block.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__fill__partial_pool__requests_missing)
+{
+    const auto block = make_block(10);
+    const auto compact = compact_block::factory_from_block(block, nonce);
+
+    block_reconstructor instance;
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::success);
+
+    // Transactions 1 through 4 and 8 through 10, missing 5, 6 and 7.
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 1, 5)), 4u);
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 8, 11)), 3u);
+    BOOST_REQUIRE(!instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.missing(), 3u);
+
+    const auto request = instance.request();
+    BOOST_REQUIRE(request.block_hash == block.header.hash());
+    BOOST_REQUIRE_EQUAL(request.indexes.size(), 3u);
+    BOOST_REQUIRE_EQUAL(request.indexes[0], 5u);
+    BOOST_REQUIRE_EQUAL(request.indexes[1], 0u);
+    BOOST_REQUIRE_EQUAL(request.indexes[2], 0u);
+
+    block_transactions response;
+    response.block_hash = request.block_hash;
+    response.transactions.assign(block.transactions.begin() + 5,
+        block.transactions.begin() + 8);
+
+    BOOST_REQUIRE_EQUAL(instance.fill(response), error::success);
+    BOOST_REQUIRE(instance.complete());
+
+    chain::block result;
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result), error::success);
+    BOOST_REQUIRE(result.to_data() == block.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__fill__wrong_response_count__bad_stream)
+{
+    const auto block = make_block(3);
+    block_reconstructor instance;
+    instance.load(compact_block::factory_from_block(block, nonce));
+
+    block_transactions response;
+    response.block_hash = block.header.hash();
+    response.transactions.push_back(block.transactions[1]);
+    BOOST_REQUIRE_EQUAL(instance.fill(response), error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__fill__wrong_transaction__merkle_mismatch)
+{
+    const auto block = make_block(2);
+    block_reconstructor instance;
+    instance.load(compact_block::factory_from_block(block, nonce));
+
+    const auto other = make_block(5);
+    block_transactions response;
+    response.block_hash = block.header.hash();
+    response.transactions.assign(other.transactions.begin() + 4,
+        other.transactions.end());
+
+    BOOST_REQUIRE_EQUAL(instance.fill(response), error::success);
+
+    chain::block result;
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result),
+        error::merkle_mismatch);
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__load__duplicate_short_ids__duplicate)
+{
+    auto compact = compact_block::factory_from_block(make_block(3), nonce);
+    compact.short_ids[1] = compact.short_ids[0];
+
+    block_reconstructor instance;
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::duplicate);
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__load__prefilled_index_overflow__bad_stream)
+{
+    auto compact = compact_block::factory_from_block(make_block(3), nonce);
+    compact.transactions.front().index = 4;
+
+    block_reconstructor instance;
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__reconstruct__complete__transaction_count_serialized)
+{
+    const auto block = make_block(10);
+    block_reconstructor instance;
+    instance.load(compact_block::factory_from_block(block, nonce));
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 1, 11)), 10u);
+
+    chain::block result;
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result), error::success);
+    BOOST_REQUIRE_EQUAL(result.header.transaction_count, 11u);
+
+    const auto data = result.to_data();
+    BOOST_REQUIRE(data == block.to_data());
+
+    chain::block parsed;
+    BOOST_REQUIRE(parsed.from_data(data));
+    BOOST_REQUIRE_EQUAL(parsed.header.transaction_count,
+        result.header.transaction_count);
+    BOOST_REQUIRE(parsed.header.hash() == result.header.hash());
+    BOOST_REQUIRE(parsed.to_data() == data);
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__load__after_duplicate__reloaded)
+{
+    const auto block = make_block(3);
+    auto compact = compact_block::factory_from_block(block, nonce);
+    compact.short_ids[1] = compact.short_ids[0];
+
+    block_reconstructor instance;
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::duplicate);
+    BOOST_REQUIRE_EQUAL(instance.missing(), 0u);
+    BOOST_REQUIRE(!instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 1, 4)), 0u);
+
+    chain::block result;
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result), error::not_found);
+
+    compact = compact_block::factory_from_block(block, nonce);
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::success);
+    BOOST_REQUIRE_EQUAL(instance.missing(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 1, 4)), 3u);
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result), error::success);
+    BOOST_REQUIRE(result.to_data() == block.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(block_reconstructor__load__after_bad_stream__reloaded)
+{
+    const auto block = make_block(3);
+    auto compact = compact_block::factory_from_block(block, nonce);
+    compact.transactions.front().index = 4;
+
+    block_reconstructor instance;
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::bad_stream);
+    BOOST_REQUIRE_EQUAL(instance.missing(), 0u);
+    BOOST_REQUIRE(!instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 1, 4)), 0u);
+    BOOST_REQUIRE_EQUAL(instance.request().indexes.size(), 0u);
+
+    compact = compact_block::factory_from_block(block, nonce);
+    BOOST_REQUIRE_EQUAL(instance.load(compact), error::success);
+    BOOST_REQUIRE_EQUAL(instance.fill(make_pool(block, 1, 4)), 3u);
+
+    chain::block result;
+    BOOST_REQUIRE_EQUAL(instance.reconstruct(result), error::success);
+    BOOST_REQUIRE(result.to_data() == block.to_data());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
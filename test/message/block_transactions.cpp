@@ -31,8 +31,8 @@ bool operator==(const message::block_transactions& left,
 
     for (uint64_t i = 0; (i < left.transactions.size()) && result; ++i)
     {
-        auto left_raw = left.transactions[i].to_data();
-        auto right_raw = right.transactions[i].to_data();
+        auto left_raw = left.transactions[i]->to_data();
+        auto right_raw = right.transactions[i]->to_data();
         result = (left_raw == right_raw);
     }
 
@@ -41,6 +41,13 @@ bool operator==(const message::block_transactions& left,
 
 BOOST_AUTO_TEST_SUITE(block_transactions_tests)
 
+static chain::transaction::const_ptr parse(const data_chunk& data)
+{
+    const auto tx = std::make_shared<chain::transaction>();
+    BOOST_REQUIRE(tx->from_data(data));
+    return tx;
+}
+
 BOOST_AUTO_TEST_CASE(from_data_insufficient_bytes_failure)
 {
     const data_chunk raw{ 0xab, 0xcd };
@@ -54,8 +61,7 @@ BOOST_AUTO_TEST_CASE(from_data_insufficient_version_failure)
 {
     message::block_transactions expected;
     expected.block_hash = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc"
         "4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294"
         "789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e"
@@ -64,8 +70,7 @@ BOOST_AUTO_TEST_CASE(from_data_insufficient_version_failure)
         "001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00"
         "0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000"
         "00"))));
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "010000000364e62ad837f29617bafeae951776e7a6b3019b2da37827921548d1"
         "a5efcf9e5c010000006b48304502204df0dc9b7f61fbb2e4c8b0e09f3426d625"
         "a0191e56c48c338df3214555180eaf022100f21ac1f632201154f3c69e1eadb5"
@@ -96,8 +101,7 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_chunk)
 {
     message::block_transactions expected;
     expected.block_hash = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc"
         "4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294"
         "789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e"
@@ -106,8 +110,7 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_chunk)
         "001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00"
         "0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000"
         "00"))));
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "010000000364e62ad837f29617bafeae951776e7a6b3019b2da37827921548d1"
         "a5efcf9e5c010000006b48304502204df0dc9b7f61fbb2e4c8b0e09f3426d625"
         "a0191e56c48c338df3214555180eaf022100f21ac1f632201154f3c69e1eadb5"
@@ -145,8 +148,7 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_stream)
 {
     message::block_transactions expected;
     expected.block_hash = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc"
         "4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294"
         "789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e"
@@ -155,8 +157,7 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_stream)
         "001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00"
         "0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000"
         "00"))));
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "010000000364e62ad837f29617bafeae951776e7a6b3019b2da37827921548d1"
         "a5efcf9e5c010000006b48304502204df0dc9b7f61fbb2e4c8b0e09f3426d625"
         "a0191e56c48c338df3214555180eaf022100f21ac1f632201154f3c69e1eadb5"
@@ -195,8 +196,7 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_reader)
 {
     message::block_transactions expected;
     expected.block_hash = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc"
         "4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294"
         "789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e"
@@ -205,8 +205,7 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_reader)
         "001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00"
         "0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000"
         "00"))));
-    expected.transactions.emplace_back();
-    BOOST_REQUIRE(expected.transactions.back().from_data(to_chunk(base16_literal(
+    expected.transactions.push_back(parse(to_chunk(base16_literal(
         "010000000364e62ad837f29617bafeae951776e7a6b3019b2da37827921548d1"
         "a5efcf9e5c010000006b48304502204df0dc9b7f61fbb2e4c8b0e09f3426d625"
         "a0191e56c48c338df3214555180eaf022100f21ac1f632201154f3c69e1eadb5"
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(bloom_filter_tests)
+
+static const auto element1 = base16_literal(
+    "99108ad8ed9bb6274d3980bab5a85c048f0950c8");
+static const auto element2 = base16_literal(
+    "b5a2c786d9ef4658287ced5914b37a1b4aa32eee");
+static const auto element3 = base16_literal(
+    "b9300670b4c5366e95b2699e8b18bc75e5f729c5");
+
+static filter_load make_load(size_t size, uint32_t tweak, uint8_t flags)
+{
+    filter_load message;
+    message.filter = data_chunk(size, 0x00);
+    message.hash_functions = 5;
+    message.tweak = tweak;
+    message.flags = flags;
+    return message;
+}
+
+// A transaction with one input spending the point and one output pushing
+// the data, distinguished by the locktime.
+static chain::transaction make_transaction(const chain::output_point& point,
+    const data_chunk& push, uint32_t locktime)
+{
+    chain::operation op;
+    op.code = chain::opcode::special;
+    op.data = push;
+
+    chain::input input;
+    input.previous_output = point;
+    input.sequence = max_uint32;
+
+    chain::output output;
+    output.value = 42;
+    output.script.operations.push_back(op);
+
+    return chain::transaction(1, locktime, chain::input::list{ input },
+        chain::output::list{ output });
+}
+
+static chain::output_point make_point(uint32_t index)
+{
+    chain::output_point point;
+    point.hash = null_hash;
+    point.index = index;
+    return point;
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__insert__satoshi_vector__expected_data)
+{
+    bloom_filter filter;
+    BOOST_REQUIRE_EQUAL(filter.load(make_load(3, 0, 1)), error::success);
+    filter.insert(element1);
+    BOOST_REQUIRE(filter.contains(element1));
+    BOOST_REQUIRE(!filter.contains(base16_literal(
+        "19108ad8ed9bb6274d3980bab5a85c048f0950c8")));
+    filter.insert(element2);
+    filter.insert(element3);
+    BOOST_REQUIRE(filter.contains(element2));
+    BOOST_REQUIRE(filter.contains(element3));
+    BOOST_REQUIRE_EQUAL(encode_base16(filter.data()), "614e9b");
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__insert__satoshi_tweak_vector__expected_data)
+{
+    bloom_filter filter;
+    BOOST_REQUIRE_EQUAL(filter.load(make_load(3, 2147483649, 1)),
+        error::success);
+    filter.insert(element1);
+    filter.insert(element2);
+    filter.insert(element3);
+    BOOST_REQUIRE_EQUAL(encode_base16(filter.data()), "ce4299");
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__load__oversized__size_limits)
+{
+    bloom_filter filter;
+    const auto oversized = make_load(bloom_filter::max_filter_size + 1, 0, 0);
+    BOOST_REQUIRE_EQUAL(filter.load(oversized), error::size_limits);
+    BOOST_REQUIRE(!filter.is_loaded());
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__add__unloaded__not_found)
+{
+    bloom_filter filter;
+    filter_add message;
+    message.data = to_chunk(element1);
+    BOOST_REQUIRE_EQUAL(filter.add(message), error::not_found);
+
+    filter.load(make_load(3, 0, 0));
+    BOOST_REQUIRE_EQUAL(filter.add(message), error::success);
+    BOOST_REQUIRE(filter.contains(element1));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__unloaded__true)
+{
+    bloom_filter filter;
+    const auto tx = make_transaction(make_point(0), {}, 0);
+    BOOST_REQUIRE(filter.match(tx));
+
+    filter.load(make_load(3, 0, 0));
+    BOOST_REQUIRE(!filter.match(tx));
+
+    filter.clear();
+    BOOST_REQUIRE(!filter.is_loaded());
+    BOOST_REQUIRE(filter.match(tx));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__transaction_hash__true)
+{
+    const auto tx = make_transaction(make_point(0), {}, 1);
+    const auto other = make_transaction(make_point(0), {}, 2);
+
+    bloom_filter filter;
+    filter.load(make_load(100, 0, 0));
+    filter.insert(tx.hash());
+    BOOST_REQUIRE(filter.match(tx));
+    BOOST_REQUIRE(!filter.match(other));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__update_all__spend_matches)
+{
+    const auto funding = make_transaction(make_point(0), to_chunk(element1),
+        1);
+
+    chain::output_point spent;
+    spent.hash = funding.hash();
+    spent.index = 0;
+    const auto spend = make_transaction(spent, {}, 2);
+
+    bloom_filter filter;
+    filter.load(make_load(100, 0, bloom_filter::update::all));
+    filter.insert(element1);
+    BOOST_REQUIRE(!filter.match(spend));
+    BOOST_REQUIRE(filter.match(funding));
+    BOOST_REQUIRE(filter.match(spend));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__update_none__spend_does_not_match)
+{
+    const auto funding = make_transaction(make_point(0), to_chunk(element1),
+        1);
+
+    chain::output_point spent;
+    spent.hash = funding.hash();
+    spent.index = 0;
+    const auto spend = make_transaction(spent, {}, 2);
+
+    bloom_filter filter;
+    filter.load(make_load(100, 0, bloom_filter::update::none));
+    filter.insert(element1);
+    BOOST_REQUIRE(filter.match(funding));
+    BOOST_REQUIRE(!filter.match(spend));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match_block__middle_match__partial_tree)
+{
+    chain::transaction::const_ptr_list transactions;
+
+    for (uint32_t locktime = 0; locktime < 3; ++locktime)
+        transactions.push_back(std::make_shared<const chain::transaction>(
+            make_transaction(make_point(0), {}, locktime)));
+
+    const auto hash0 = transactions[0]->hash();
+    const auto hash1 = transactions[1]->hash();
+    const auto hash2 = transactions[2]->hash();
+
+    chain::header header;
+    header.merkle = chain::block::generate_merkle_root(transactions);
+    const chain::block block(header, transactions);
+
+    bloom_filter filter;
+    filter.load(make_load(100, 0, 0));
+    filter.insert(hash1);
+
+    chain::transaction::indexes matched;
+    const auto result = filter.match(block, matched);
+    BOOST_REQUIRE_EQUAL(matched.size(), 1u);
+    BOOST_REQUIRE_EQUAL(matched.front(), 1u);
+    BOOST_REQUIRE_EQUAL(result.header.transaction_count, 3u);
+    BOOST_REQUIRE(result.flags == data_chunk{ 0x0b });
+
+    // The leaf without a sibling is paired with itself.
+    data_chunk pair(hash2.begin(), hash2.end());
+    extend_data(pair, hash2);
+    BOOST_REQUIRE_EQUAL(result.hashes.size(), 3u);
+    BOOST_REQUIRE(result.hashes[0] == hash0);
+    BOOST_REQUIRE(result.hashes[1] == hash1);
+    BOOST_REQUIRE(result.hashes[2] == bitcoin_hash(pair));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match_block__no_match__root_only)
+{
+    chain::transaction::const_ptr_list transactions;
+
+    for (uint32_t locktime = 0; locktime < 3; ++locktime)
+        transactions.push_back(std::make_shared<const chain::transaction>(
+            make_transaction(make_point(0), {}, locktime)));
+
+    chain::header header;
+    header.merkle = chain::block::generate_merkle_root(transactions);
+    const chain::block block(header, transactions);
+
+    bloom_filter filter;
+    filter.load(make_load(100, 0, 0));
+
+    chain::transaction::indexes matched;
+    const auto result = filter.match(block, matched);
+    BOOST_REQUIRE(matched.empty());
+    BOOST_REQUIRE(result.flags == data_chunk{ 0x00 });
+    BOOST_REQUIRE_EQUAL(result.hashes.size(), 1u);
+    BOOST_REQUIRE(result.hashes.front() == header.merkle);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -217,5 +217,32 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_reader)
         result.serialized_size(message::compact_block::version_minimum));
 }
 
+BOOST_AUTO_TEST_CASE(compact_block__factory_from_block__genesis__prefilled_coinbase)
+{
+    const auto block = chain::block::genesis_mainnet();
+    const auto instance = message::compact_block::factory_from_block(block,
+        42u);
+
+    BOOST_REQUIRE(instance.header == block.header);
+    BOOST_REQUIRE_EQUAL(instance.nonce, 42u);
+    BOOST_REQUIRE_EQUAL(instance.short_ids.size(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.transactions.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.transactions.front().index, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__short_id__round_trip__low_48_bits)
+{
+    const auto key = message::compact_block::short_id_key(
+        chain::block::genesis_mainnet().header, 42u);
+    const auto value = message::compact_block::short_id_value(key,
+        null_hash);
+
+    BOOST_REQUIRE_EQUAL(value >> 48, 0u);
+    BOOST_REQUIRE_EQUAL(value, siphash(key, null_hash) & 0xffffffffffffu);
+
+    const auto id = message::compact_block::to_short_id(value);
+    BOOST_REQUIRE_EQUAL(message::compact_block::from_short_id(id), value);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
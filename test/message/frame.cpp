@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(frame_tests)
+
+static const uint32_t magic = 0xd9b4bef9;
+static const uint32_t level = version::level::maximum;
+
+static data_chunk make_ping_frame()
+{
+    return serialize(level, ping{ 42u }, magic);
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__partial_heading__incomplete)
+{
+    const auto wire = make_ping_frame();
+    const data_chunk partial(wire.begin(), wire.begin() + 10);
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, partial), error::success);
+    BOOST_REQUIRE(!instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.size(), heading::serialized_size());
+    BOOST_REQUIRE(instance.type() == message_type::unknown);
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__partial_payload__size_of_frame)
+{
+    const auto wire = make_ping_frame();
+    const data_chunk partial(wire.begin(), wire.end() - 1);
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, partial), error::success);
+    BOOST_REQUIRE(!instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.size(), wire.size());
+    BOOST_REQUIRE(instance.type() == message_type::ping);
+    BOOST_REQUIRE(instance.payload().empty());
+
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+    BOOST_REQUIRE(instance.complete());
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__ping__parses_payload)
+{
+    auto wire = make_ping_frame();
+
+    // Trailing bytes of the next frame are not consumed.
+    wire.push_back(0x42);
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+    BOOST_REQUIRE(instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.size(), wire.size() - 1);
+    BOOST_REQUIRE_EQUAL(instance.command(), ping::command);
+    BOOST_REQUIRE_EQUAL(instance.payload().size(), 8u);
+    BOOST_REQUIRE(instance.payload_hash() ==
+        bitcoin_hash(instance.payload()));
+
+    ping result;
+    BOOST_REQUIRE(instance.parse(level, result));
+    BOOST_REQUIRE_EQUAL(result.nonce, 42u);
+
+    pong other;
+    BOOST_REQUIRE(!instance.parse(level, other));
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__unknown_command__complete_unknown)
+{
+    heading head{ magic, "foo", 0u, bitcoin_checksum(data_chunk{}) };
+    const auto wire = head.to_data();
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+    BOOST_REQUIRE(instance.complete());
+    BOOST_REQUIRE(instance.type() == message_type::unknown);
+    BOOST_REQUIRE_EQUAL(instance.command(), "foo");
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__bad_magic__bad_stream)
+{
+    const auto wire = make_ping_frame();
+    frame instance(magic + 1);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::bad_stream);
+    BOOST_REQUIRE(!instance.complete());
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__bad_checksum__bad_stream)
+{
+    auto wire = make_ping_frame();
+    wire.back() ^= 0x01;
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::bad_stream);
+    BOOST_REQUIRE(!instance.complete());
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__unpadded_command__bad_stream)
+{
+    auto wire = make_ping_frame();
+
+    // A nonzero byte after the command terminator.
+    wire[sizeof(uint32_t) + command_size - 1] = 'x';
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(frame__decode__oversized_payload__size_limits)
+{
+    const auto size = heading::maximum_payload_size(level) + 1;
+    heading head{ magic, ping::command, static_cast<uint32_t>(size), 0u };
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, head.to_data()),
+        error::size_limits);
+}
+
+BOOST_AUTO_TEST_CASE(frame__parse__transaction__caches_payload_hash)
+{
+    const auto& genesis = chain::block::genesis_mainnet();
+    const transaction_message tx(genesis.transactions.front());
+    const auto wire = serialize(level, tx, magic);
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+    BOOST_REQUIRE(instance.type() == message_type::transaction_message);
+
+    transaction_message result;
+    BOOST_REQUIRE(instance.parse(level, result));
+    BOOST_REQUIRE(result.to_data(level) == tx.to_data(level));
+    BOOST_REQUIRE(result.transaction()->hash() == instance.payload_hash());
+    BOOST_REQUIRE(result.transaction()->hash() == tx.transaction()->hash());
+    BOOST_REQUIRE_EQUAL(result.serialized_size(level),
+        instance.payload().size());
+}
+
+BOOST_AUTO_TEST_CASE(frame__parse__non_minimal_transaction__hash_not_seeded)
+{
+    // Encode the input count (1) with a non-minimal variable integer.
+    const auto& genesis = chain::block::genesis_mainnet();
+    const auto canonical = genesis.transactions.front()->to_data();
+    BOOST_REQUIRE_EQUAL(canonical[4], 0x01);
+    data_chunk payload(canonical.begin(), canonical.begin() + 4);
+    extend_data(payload, data_chunk{ 0xfd, 0x01, 0x00 });
+    payload.insert(payload.end(), canonical.begin() + 5, canonical.end());
+
+    heading head;
+    head.magic = magic;
+    head.command = transaction_message::command;
+    head.payload_size = static_cast<uint32_t>(payload.size());
+    head.checksum = bitcoin_checksum(payload);
+    auto wire = head.to_data();
+    extend_data(wire, payload);
+
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    transaction_message result;
+    BOOST_REQUIRE(instance.parse(level, result));
+    BOOST_REQUIRE(result.transaction()->hash() != instance.payload_hash());
+    BOOST_REQUIRE(result.transaction()->hash() ==
+        genesis.transactions.front()->hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -109,4 +109,35 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_reader)
     BOOST_REQUIRE(expected == result);
 }
 
+BOOST_AUTO_TEST_CASE(serialize_ping__expected_heading_and_payload)
+{
+    static const uint32_t magic = 0xd9b4bef9;
+    const message::ping packet(42);
+    const auto payload = packet.to_data(message::version::level::maximum);
+    const auto wire = message::serialize(message::version::level::maximum,
+        packet, magic);
+
+    BOOST_REQUIRE_EQUAL(wire.size(), heading::serialized_size() +
+        payload.size());
+
+    const auto head = heading::factory_from_data(wire);
+    BOOST_REQUIRE_EQUAL(head.magic, magic);
+    BOOST_REQUIRE_EQUAL(head.command, message::ping::command);
+    BOOST_REQUIRE_EQUAL(head.payload_size, payload.size());
+    BOOST_REQUIRE_EQUAL(head.checksum, bitcoin_checksum(payload));
+    BOOST_REQUIRE(std::equal(payload.begin(), payload.end(),
+        wire.begin() + heading::serialized_size()));
+}
+
+BOOST_AUTO_TEST_CASE(serialize_ping__wrong_buffer_size__false)
+{
+    const message::ping packet(42);
+    const auto version = message::version::level::maximum;
+    data_chunk buffer(message::serialized_size(version, packet) + 1);
+    BOOST_REQUIRE(!message::serialize(buffer.data(), buffer.size(), version,
+        packet, 0));
+    BOOST_REQUIRE(message::serialize(buffer.data(), buffer.size() - 1,
+        version, packet, 0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
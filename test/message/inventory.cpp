@@ -121,4 +121,39 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_reader)
     BOOST_REQUIRE_EQUAL(expected.serialized_size(version), result.serialized_size(version));
 }
 
+BOOST_AUTO_TEST_CASE(inventory__from_data__hostile_count__failure)
+{
+    // A maximal count followed by a single inventory vector.
+    data_chunk data{ 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+    const inventory_vector vector{ inventory::type_id::block, null_hash };
+    extend_data(data, vector.to_data(version::level::minimum));
+
+    inventory instance;
+    BOOST_REQUIRE(!instance.from_data(version::level::minimum, data));
+
+    data_source istream(data);
+    BOOST_REQUIRE(!instance.from_data(version::level::minimum, istream));
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(inventory__from_data__reused_instance__retains_capacity)
+{
+    static const auto version = version::level::minimum;
+    const inventory_vector vector{ inventory::type_id::block, null_hash };
+    const inventory large{ inventory_vector::list(10, vector) };
+    const inventory small{ inventory_vector::list(2, vector) };
+
+    inventory instance;
+    BOOST_REQUIRE(instance.from_data(version, large.to_data(version)));
+    const auto capacity = instance.inventories.capacity();
+    BOOST_REQUIRE(capacity >= 10u);
+
+    BOOST_REQUIRE(instance.from_data(version, small.to_data(version)));
+    BOOST_REQUIRE(instance == small);
+    BOOST_REQUIRE_EQUAL(instance.inventories.capacity(), capacity);
+
+    instance.reset();
+    BOOST_REQUIRE_EQUAL(instance.inventories.capacity(), 0u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(message_pool_tests)
+
+static inventory_vector::list make_inventories(size_t count)
+{
+    inventory_vector::list out(count);
+
+    for (size_t index = 0; index < count; ++index)
+        out[index] = { inventory::type_id::transaction, null_hash };
+
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(message_pool__acquire__released__reused_cleared_with_capacity)
+{
+    const inventory* address = nullptr;
+    size_t capacity = 0;
+
+    {
+        const auto instance = message_pool<inventory>::acquire();
+        instance->inventories = make_inventories(100);
+        address = instance.get();
+        capacity = instance->inventories.capacity();
+    }
+
+    const auto instance = message_pool<inventory>::acquire();
+    BOOST_REQUIRE(instance.get() == address);
+    BOOST_REQUIRE(instance->inventories.empty());
+    BOOST_REQUIRE_EQUAL(instance->inventories.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(message_pool__acquire__held__not_reused)
+{
+    const auto first = message_pool<headers>::acquire();
+    const auto second = message_pool<headers>::acquire();
+    BOOST_REQUIRE(first != second);
+    BOOST_REQUIRE(message_pool<headers>::size() >= 2u);
+}
+
+BOOST_AUTO_TEST_CASE(message_pool__acquire__pool_full__not_pooled)
+{
+    typedef message_pool<transaction_message, 2> pool;
+    const auto first = pool::acquire();
+    const auto second = pool::acquire();
+    const auto third = pool::acquire();
+    BOOST_REQUIRE_EQUAL(pool::size(), 2u);
+    BOOST_REQUIRE_EQUAL(third.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(message_pool__acquire__released_transaction__originator_cleared)
+{
+    typedef message_pool<transaction_message, 1> pool;
+
+    {
+        const auto instance = pool::acquire();
+        const auto& genesis = chain::block::genesis_mainnet();
+        const auto raw = genesis.transactions.front()->to_data();
+        instance->set_originator(42);
+        BOOST_REQUIRE(instance->from_data(version::level::minimum, raw));
+    }
+
+    const auto instance = pool::acquire();
+    BOOST_REQUIRE_EQUAL(instance->originator(), 0u);
+    BOOST_REQUIRE(instance->transaction()->inputs.empty());
+    BOOST_REQUIRE(instance->transaction()->outputs.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -38,13 +38,8 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_chunk)
     const message::prefilled_transaction expected
     {
         16,
-        chain::transaction
-        {
-            1,
-            0,
-            { },
-            { }
-        }
+        std::make_shared<const chain::transaction>(1, 0,
+            chain::input::list{}, chain::output::list{})
     };
 
     const auto data = expected.to_data(message::version::level::minimum);
@@ -64,13 +59,8 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_stream)
     const message::prefilled_transaction expected
     {
         16,
-        chain::transaction
-        {
-            1,
-            0,
-            { },
-            { }
-        }
+        std::make_shared<const chain::transaction>(1, 0,
+            chain::input::list{}, chain::output::list{})
     };
 
     const auto data = expected.to_data(message::version::level::minimum);
@@ -91,13 +81,8 @@ BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_reader)
     const message::prefilled_transaction expected
     {
         16,
-        chain::transaction
-        {
-            1,
-            0,
-            { },
-            { }
-        }
+        std::make_shared<const chain::transaction>(1, 0,
+            chain::input::list{}, chain::output::list{})
     };
 
     const auto data = expected.to_data(message::version::level::minimum);
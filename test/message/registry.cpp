@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(registry_tests)
+
+static const uint32_t magic = 0xd9b4bef9;
+static const uint32_t level = version::level::maximum;
+
+struct ping_handler
+{
+    template <typename Message>
+    void operator()(std::shared_ptr<const Message>)
+    {
+        ++others;
+    }
+
+    void operator()(std::shared_ptr<const ping> message)
+    {
+        nonce = message->nonce;
+    }
+
+    uint64_t nonce = 0;
+    size_t others = 0;
+};
+
+// Copies the message, so the dispatched instance is released.
+struct inventory_handler
+{
+    template <typename Message>
+    void operator()(std::shared_ptr<const Message>)
+    {
+    }
+
+    void operator()(std::shared_ptr<const inventory> instance)
+    {
+        message = *instance;
+        address = instance.get();
+    }
+
+    inventory message;
+    const void* address = nullptr;
+};
+
+static data_chunk make_frame(const std::string& command,
+    const data_chunk& payload)
+{
+    heading head
+    {
+        magic,
+        command,
+        static_cast<uint32_t>(payload.size()),
+        bitcoin_checksum(payload)
+    };
+
+    auto wire = head.to_data();
+    extend_data(wire, payload);
+    return wire;
+}
+
+BOOST_AUTO_TEST_CASE(registry__type__registered_commands__round_trip)
+{
+    for (size_t value = 1; value <= registry::size; ++value)
+    {
+        const auto type = static_cast<message_type>(value);
+        const auto& command = registry::command(type);
+        BOOST_REQUIRE(registry::type(command) == type);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(registry__type__unregistered_commands__unknown)
+{
+    BOOST_REQUIRE(registry::type("") == message_type::unknown);
+    BOOST_REQUIRE(registry::type("pin") == message_type::unknown);
+    BOOST_REQUIRE(registry::type("pingg") == message_type::unknown);
+    BOOST_REQUIRE(registry::type("checkorder") == message_type::unknown);
+    BOOST_REQUIRE(registry::type("0123456789abc") == message_type::unknown);
+}
+
+BOOST_AUTO_TEST_CASE(registry__type__heading_fee_filter__fee_filter)
+{
+    heading head{ magic, fee_filter::command, 0u, 0u };
+    BOOST_REQUIRE(head.type() == message_type::fee_filter);
+}
+
+BOOST_AUTO_TEST_CASE(registry__maximum_payload_size__types__expected)
+{
+    BOOST_REQUIRE_EQUAL(registry::maximum_payload_size(message_type::ping,
+        level), sizeof(uint64_t));
+    BOOST_REQUIRE_EQUAL(registry::maximum_payload_size(message_type::verack,
+        level), 0u);
+    BOOST_REQUIRE_EQUAL(registry::maximum_payload_size(message_type::unknown,
+        level), heading::maximum_payload_size(level));
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__version_range__expected)
+{
+    const auto type = message_type::send_compact_blocks;
+    BOOST_REQUIRE(registry::is_supported(type, version::level::bip152));
+    BOOST_REQUIRE(!registry::is_supported(type, version::level::bip133));
+    BOOST_REQUIRE(!registry::is_supported(message_type::unknown, level));
+}
+
+// Supported from the minimum, and at and above the (open ended) maximum.
+template <typename Message>
+static void require_supported_from(message_type type)
+{
+    const auto minimum = Message::version_minimum;
+    const auto maximum = Message::version_maximum;
+    BOOST_REQUIRE(!registry::is_supported(type, minimum - 1));
+    BOOST_REQUIRE(registry::is_supported(type, minimum));
+    BOOST_REQUIRE(registry::is_supported(type, maximum));
+    BOOST_REQUIRE(registry::is_supported(type, maximum + 1));
+    BOOST_REQUIRE(registry::is_supported(type, version::level::bip152 + 1));
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__fee_filter__open_ended)
+{
+    require_supported_from<fee_filter>(message_type::fee_filter);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__send_compact_blocks__open_ended)
+{
+    require_supported_from<send_compact_blocks>(
+        message_type::send_compact_blocks);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__compact_block__open_ended)
+{
+    require_supported_from<compact_block>(message_type::compact_block);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__get_block_transactions__open_ended)
+{
+    require_supported_from<get_block_transactions>(
+        message_type::get_block_transactions);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__block_transactions__open_ended)
+{
+    require_supported_from<block_transactions>(
+        message_type::block_transactions);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__send_headers__open_ended)
+{
+    require_supported_from<send_headers>(message_type::send_headers);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__headers__open_ended)
+{
+    require_supported_from<headers>(message_type::headers);
+}
+
+BOOST_AUTO_TEST_CASE(registry__is_supported__ping__open_ended)
+{
+    require_supported_from<ping>(message_type::ping);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__ping__typed_handler)
+{
+    const auto wire = serialize(level, ping{ 42u }, magic);
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(level, instance, handler),
+        error::success);
+    BOOST_REQUIRE_EQUAL(handler.nonce, 42u);
+    BOOST_REQUIRE_EQUAL(handler.others, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__verack__generic_handler)
+{
+    const auto wire = make_frame(verack::command, {});
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(level, instance, handler),
+        error::success);
+    BOOST_REQUIRE_EQUAL(handler.others, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__unknown_command__not_found)
+{
+    const auto wire = make_frame("foo", {});
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(level, instance, handler),
+        error::not_found);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__unsupported_version__operation_failed)
+{
+    const auto wire = make_frame(send_headers::command, {});
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(version::level::bip61, instance,
+        handler), error::operation_failed);
+    BOOST_REQUIRE_EQUAL(handler.others, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__fee_filter_above_maximum__success)
+{
+    const auto above = fee_filter::version_maximum + 1;
+    const auto wire = make_frame(fee_filter::command, data_chunk(8, 0x00));
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(above, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(fee_filter::version_maximum,
+        instance, handler), error::success);
+    BOOST_REQUIRE_EQUAL(registry::dispatch(above, instance, handler),
+        error::success);
+    BOOST_REQUIRE_EQUAL(handler.others, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__send_compact_blocks_above_maximum__success)
+{
+    const auto above = send_compact_blocks::version_maximum + 1;
+    const auto wire = make_frame(send_compact_blocks::command,
+        data_chunk(9, 0x00));
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(above, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(version::level::bip133, instance,
+        handler), error::operation_failed);
+    BOOST_REQUIRE_EQUAL(registry::dispatch(above, instance, handler),
+        error::success);
+    BOOST_REQUIRE_EQUAL(handler.others, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__ping_above_maximum__typed_handler)
+{
+    const auto above = ping::version_maximum + 1;
+    const auto wire = serialize(above, ping{ 42u }, magic);
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(above, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(above, instance, handler),
+        error::success);
+    BOOST_REQUIRE_EQUAL(handler.nonce, 42u);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__truncated_payload__bad_stream)
+{
+    const auto wire = make_frame(ping::command, { 0x01, 0x02, 0x03, 0x04 });
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    ping_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(level, instance, handler),
+        error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(registry__dispatch__pooled_inventory__instance_reused)
+{
+    const inventory_vector vector{ inventory::type_id::block, null_hash };
+    const inventory expected{ inventory_vector::list(3, vector) };
+    const auto wire = serialize(level, expected, magic);
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::success);
+
+    inventory_handler handler;
+    BOOST_REQUIRE_EQUAL(registry::dispatch(level, instance, handler),
+        error::success);
+    const auto first = handler.address;
+
+    BOOST_REQUIRE_EQUAL(registry::dispatch(level, instance, handler),
+        error::success);
+    BOOST_REQUIRE(handler.message == expected);
+    BOOST_REQUIRE(handler.address == first);
+}
+
+BOOST_AUTO_TEST_CASE(registry__frame_decode__payload_above_type_maximum__size_limits)
+{
+    const auto wire = make_frame(ping::command, data_chunk(9, 0x00));
+    frame instance(magic);
+    BOOST_REQUIRE_EQUAL(instance.decode(level, wire), error::size_limits);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
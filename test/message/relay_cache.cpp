@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(relay_cache_tests)
+
+static const uint32_t magic = 0xd9b4bef9;
+static const uint32_t level = version::level::maximum;
+
+static block_message make_block(uint32_t nonce)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const chain::header header{ 1, null_hash, genesis.header.merkle,
+        genesis.header.timestamp, genesis.header.bits, nonce };
+
+    return block_message(header, genesis.transactions);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__block__framed_message)
+{
+    relay_cache cache(magic, 1000000);
+    const auto block = make_block(42);
+    const auto message = cache.get(level, block);
+
+    BOOST_REQUIRE(message);
+    BOOST_REQUIRE(*message == serialize(level, block, magic));
+    BOOST_REQUIRE_EQUAL(cache.count(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.size(), message->size());
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__repeated__shared_message)
+{
+    relay_cache cache(magic, 1000000);
+    const auto block = make_block(42);
+    const auto first = cache.get(level, block);
+    const auto second = cache.get(level, block);
+
+    BOOST_REQUIRE(first == second);
+    BOOST_REQUIRE(cache.find(message_type::block_message, level,
+        block.header.hash()) == first);
+    BOOST_REQUIRE(!cache.find(message_type::compact_block, level,
+        block.header.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__transaction__keyed_by_hash)
+{
+    relay_cache cache(magic, 1000000);
+    const transaction_message tx(
+        chain::block::genesis_mainnet().transactions.front());
+
+    const auto message = cache.get(level, tx);
+    BOOST_REQUIRE(*message == serialize(level, tx, magic));
+    BOOST_REQUIRE(cache.find(message_type::transaction_message, level,
+        tx.transaction()->hash()) == message);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__over_budget__least_recently_used_evicted)
+{
+    const auto size = serialize(level, make_block(0), magic).size();
+    relay_cache cache(magic, 2 * size);
+
+    const auto first = make_block(1);
+    const auto second = make_block(2);
+    const auto third = make_block(3);
+    cache.get(level, first);
+    cache.get(level, second);
+
+    // Use the first, so the second is least recently used.
+    BOOST_REQUIRE(cache.find(message_type::block_message, level,
+        first.header.hash()));
+
+    cache.get(level, third);
+    BOOST_REQUIRE_EQUAL(cache.count(), 2u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2 * size);
+    BOOST_REQUIRE(cache.find(message_type::block_message, level,
+        first.header.hash()));
+    BOOST_REQUIRE(!cache.find(message_type::block_message, level,
+        second.header.hash()));
+    BOOST_REQUIRE(cache.find(message_type::block_message, level,
+        third.header.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__larger_than_budget__not_cached)
+{
+    relay_cache cache(magic, 10);
+    const auto message = cache.get(level, make_block(42));
+
+    BOOST_REQUIRE(message);
+    BOOST_REQUIRE_EQUAL(cache.count(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__remove__cached__removed)
+{
+    relay_cache cache(magic, 1000000);
+    const auto block = make_block(42);
+    cache.get(level, block);
+    cache.remove(message_type::block_message, block.header.hash());
+
+    BOOST_REQUIRE_EQUAL(cache.count(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__versions__distinct)
+{
+    relay_cache cache(magic, 1000000);
+    const auto block = make_block(42);
+    const auto above = level + 1;
+    const auto first = cache.get(level, block);
+    const auto second = cache.get(above, block);
+
+    BOOST_REQUIRE(first != second);
+    BOOST_REQUIRE_EQUAL(cache.count(), 2u);
+    BOOST_REQUIRE(cache.find(message_type::block_message, level,
+        block.header.hash()) == first);
+    BOOST_REQUIRE(cache.find(message_type::block_message, above,
+        block.header.hash()) == second);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__remove__versions__all_removed)
+{
+    relay_cache cache(magic, 1000000);
+    const auto block = make_block(42);
+    const auto other = make_block(7);
+    cache.get(level, block);
+    cache.get(level + 1, block);
+    cache.get(level, other);
+    cache.remove(message_type::block_message, block.header.hash());
+
+    BOOST_REQUIRE_EQUAL(cache.count(), 1u);
+    BOOST_REQUIRE(!cache.find(message_type::block_message, level,
+        block.header.hash()));
+    BOOST_REQUIRE(!cache.find(message_type::block_message, level + 1,
+        block.header.hash()));
+    BOOST_REQUIRE(cache.find(message_type::block_message, level,
+        other.header.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__compact_block_nonces__distinct)
+{
+    const auto version = compact_block::version_minimum;
+    relay_cache cache(magic, 1000000);
+    const auto block = make_block(42);
+    const auto first = compact_block::factory_from_block(block, 1);
+    const auto second = compact_block::factory_from_block(block, 2);
+    const auto first_message = cache.get(version, first);
+    const auto second_message = cache.get(version, second);
+
+    BOOST_REQUIRE_EQUAL(cache.count(), 2u);
+    BOOST_REQUIRE(*first_message == serialize(version, first, magic));
+    BOOST_REQUIRE(*second_message == serialize(version, second, magic));
+    BOOST_REQUIRE(cache.find(message_type::compact_block, version,
+        relay_cache::compact_block_key(second)) == second_message);
+    BOOST_REQUIRE(!cache.find(message_type::compact_block, version,
+        block.header.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__get__headers_same_last_header__distinct)
+{
+    relay_cache cache(magic, 1000000);
+    const auto first = make_block(1).header;
+    const auto second = make_block(2).header;
+    const auto third = make_block(3).header;
+    const headers long_headers{ first, second, third };
+    const headers short_headers{ second, third };
+
+    const auto long_message = cache.get(level, long_headers);
+    const auto short_message = cache.get(level, short_headers);
+
+    BOOST_REQUIRE_EQUAL(cache.count(), 2u);
+    BOOST_REQUIRE(*long_message == serialize(level, long_headers, magic));
+    BOOST_REQUIRE(*short_message == serialize(level, short_headers, magic));
+    BOOST_REQUIRE(cache.find(message_type::headers, level,
+        relay_cache::headers_key(short_headers)) == short_message);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(rolling_bloom_filter_tests)
+
+// A fixed siphash key, so that cell positions are reproducible.
+static const half_hash key
+{
+    {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    }
+};
+
+static hash_digest make_hash(uint32_t index)
+{
+    return sha256_hash(to_chunk(to_little_endian(index)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__construct__rate__hash_functions)
+{
+    const rolling_bloom_filter filter(1000, 1.0 / 1024, key);
+    BOOST_REQUIRE_EQUAL(filter.hash_functions(), 10u);
+    BOOST_REQUIRE(filter.size() > 0u);
+    BOOST_REQUIRE_EQUAL(filter.size() % 64, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__contains__inserted__true)
+{
+    rolling_bloom_filter filter(1000, 0.000001, key);
+
+    for (uint32_t index = 0; index < 1000; ++index)
+        filter.insert(make_hash(index));
+
+    for (uint32_t index = 0; index < 1000; ++index)
+        BOOST_REQUIRE(filter.contains(make_hash(index)));
+
+    for (uint32_t index = 1000; index < 2000; ++index)
+        BOOST_REQUIRE(!filter.contains(make_hash(index)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__insert__beyond_capacity__oldest_forgotten)
+{
+    rolling_bloom_filter filter(100, 0.000001, key);
+
+    for (uint32_t index = 0; index < 1000; ++index)
+        filter.insert(make_hash(index));
+
+    // The last capacity are retained, those before the last 150 are not.
+    for (uint32_t index = 900; index < 1000; ++index)
+        BOOST_REQUIRE(filter.contains(make_hash(index)));
+
+    for (uint32_t index = 0; index < 850; ++index)
+        BOOST_REQUIRE(!filter.contains(make_hash(index)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__filter__partially_known__unknown_only)
+{
+    rolling_bloom_filter filter(1000, 0.000001, key);
+    const hash_list known{ make_hash(0), make_hash(1), make_hash(2) };
+    filter.insert(inventory(known, inventory::type_id::transaction));
+
+    const inventory announce
+    {
+        { inventory::type_id::transaction, make_hash(1) },
+        { inventory::type_id::block, make_hash(3) },
+        { inventory::type_id::transaction, make_hash(2) },
+        { inventory::type_id::transaction, make_hash(4) }
+    };
+
+    inventory_vector::list unknown;
+    filter.filter(unknown, announce);
+    BOOST_REQUIRE_EQUAL(unknown.size(), 2u);
+    BOOST_REQUIRE(unknown[0] == announce.inventories[1]);
+    BOOST_REQUIRE(unknown[1] == announce.inventories[3]);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__clear__inserted__not_contained)
+{
+    rolling_bloom_filter filter(10, 0.000001, key);
+    filter.insert(make_hash(42));
+    BOOST_REQUIRE(filter.contains(make_hash(42)));
+
+    filter.clear();
+    BOOST_REQUIRE(!filter.contains(make_hash(42)));
+}
+
+// Measure the false positive rate with three generations of hashes, the most
+// the filter holds, against the target rate.
+static double measure_rate(size_t capacity, double rate, uint32_t queries)
+{
+    rolling_bloom_filter filter(capacity, rate, key);
+    const auto inserts = static_cast<uint32_t>(3 * capacity);
+
+    for (uint32_t index = 0; index < inserts; ++index)
+        filter.insert(make_hash(index));
+
+    size_t positives = 0;
+
+    for (uint32_t index = inserts; index < inserts + queries; ++index)
+        if (filter.contains(make_hash(index)))
+            ++positives;
+
+    return static_cast<double>(positives) / queries;
+}
+
+// The filter is sized to the target rate, so the measured rate is allowed
+// four standard errors of sampling the given number of queries above it.
+static bool within_rate(double measured, double rate, uint32_t queries)
+{
+    const auto error = std::sqrt(rate * (1.0 - rate) / queries);
+    return measured <= rate + 4.0 * error;
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__contains__percent_rate__within_rate)
+{
+    const auto measured = measure_rate(10000, 0.01, 200000);
+    BOOST_TEST_MESSAGE("false positive rate: " << measured);
+    BOOST_REQUIRE(within_rate(measured, 0.01, 200000));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__contains__permille_rate__within_rate)
+{
+    const auto measured = measure_rate(10000, 0.001, 1000000);
+    BOOST_TEST_MESSAGE("false positive rate: " << measured);
+    BOOST_REQUIRE(within_rate(measured, 0.001, 1000000));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -65,7 +65,7 @@ BOOST_AUTO_TEST_CASE(case_1_factory_data_chunk)
     const auto tx = transaction_message::factory_from_data(version::level::minimum, raw_tx);
     BOOST_REQUIRE(tx.is_valid());
     BOOST_REQUIRE_EQUAL(tx.serialized_size(version::level::minimum), 225u);
-    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.transaction()->hash() == tx_hash);
 
     // Re-save tx and compare against original.
     BOOST_REQUIRE_EQUAL(tx.serialized_size(version::level::minimum), raw_tx.size());
@@ -99,7 +99,7 @@ BOOST_AUTO_TEST_CASE(case_2_factory_data_chunk)
 
     const auto tx = transaction_message::factory_from_data(version::level::minimum, raw_tx);
     BOOST_REQUIRE(tx.is_valid());
-    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.transaction()->hash() == tx_hash);
 
     // Re-save tx and compare against original.
     BOOST_REQUIRE(tx.serialized_size(version::level::minimum) == raw_tx.size());
@@ -126,7 +126,7 @@ BOOST_AUTO_TEST_CASE(case_1_factory_stream)
     const auto tx = transaction_message::factory_from_data(version::level::minimum, stream);
     BOOST_REQUIRE(tx.is_valid());
     BOOST_REQUIRE_EQUAL(tx.serialized_size(version::level::minimum), 225u);
-    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.transaction()->hash() == tx_hash);
 
     // Re-save tx and compare against original.
     BOOST_REQUIRE_EQUAL(tx.serialized_size(version::level::minimum), raw_tx.size());
@@ -161,7 +161,7 @@ BOOST_AUTO_TEST_CASE(case_2_factory_stream)
     data_source stream(raw_tx);
     const auto tx = transaction_message::factory_from_data(version::level::minimum, stream);
     BOOST_REQUIRE(tx.is_valid());
-    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.transaction()->hash() == tx_hash);
 
     // Re-save tx and compare against original.
     BOOST_REQUIRE(tx.serialized_size(version::level::minimum) == raw_tx.size());
@@ -189,7 +189,7 @@ BOOST_AUTO_TEST_CASE(case_1_factory_reader)
     const auto tx = transaction_message::factory_from_data(version::level::minimum, source);
     BOOST_REQUIRE(tx.is_valid());
     BOOST_REQUIRE_EQUAL(tx.serialized_size(version::level::minimum), 225u);
-    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.transaction()->hash() == tx_hash);
 
     // Re-save tx and compare against original.
     BOOST_REQUIRE_EQUAL(tx.serialized_size(version::level::minimum), raw_tx.size());
@@ -225,7 +225,7 @@ BOOST_AUTO_TEST_CASE(case_2_factory_reader)
     istream_reader source(stream);
     const auto tx = transaction_message::factory_from_data(version::level::minimum, source);
     BOOST_REQUIRE(tx.is_valid());
-    BOOST_REQUIRE(tx.hash() == tx_hash);
+    BOOST_REQUIRE(tx.transaction()->hash() == tx_hash);
 
     // Re-save tx and compare against original.
     BOOST_REQUIRE(tx.serialized_size(version::level::minimum) == raw_tx.size());
@@ -241,5 +241,47 @@ BOOST_AUTO_TEST_CASE(transaction_message__originator__always__expected)
     BOOST_REQUIRE_EQUAL(transaction.originator(), originator);
 }
 
+BOOST_AUTO_TEST_CASE(transaction_message__move_construct__preserves_transaction)
+{
+    hash_digest tx_hash = hash_literal(
+        "bf7c3f5a69a78edd81f3eff7e93a37fb2d7da394d48db4d85e7e5353b9b8e270");
+    const data_chunk raw_tx = to_chunk(base16_literal(
+        "0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc"
+        "4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294"
+        "789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e"
+        "2830b115472fb31de67d16972867f13945012103e589480b2f746381fca01a9b"
+        "12c517b7a482a203c8b2742985da0ac72cc078f2ffffffff02f0c9c467000000"
+        "001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00"
+        "0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000"
+        "00"));
+    auto tx = chain::transaction::factory_from_data(raw_tx);
+    BOOST_REQUIRE(tx.hash() == tx_hash);
+
+    const transaction_message message(std::move(tx));
+    BOOST_REQUIRE_EQUAL(message.transaction()->inputs.size(), 1u);
+    BOOST_REQUIRE_EQUAL(message.transaction()->outputs.size(), 2u);
+    BOOST_REQUIRE(message.transaction()->hash() == tx_hash);
+    BOOST_REQUIRE(message.to_data(version::level::minimum) == raw_tx);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_message__copy_construct__shares_transaction)
+{
+    const auto& genesis = chain::block::genesis_mainnet();
+    const transaction_message message(genesis.transactions.front());
+    const transaction_message copy(message);
+    BOOST_REQUIRE(copy.transaction() == genesis.transactions.front());
+    BOOST_REQUIRE(message.transaction() == genesis.transactions.front());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_message__from_data__shared__does_not_modify)
+{
+    const auto& genesis = chain::block::genesis_mainnet();
+    const auto shared = genesis.transactions.front();
+    const auto raw = shared->to_data();
+    transaction_message message(shared);
+    BOOST_REQUIRE(message.from_data(version::level::minimum, raw));
+    BOOST_REQUIRE(message.transaction() != shared);
+    BOOST_REQUIRE(message.transaction()->hash() == shared->hash());
+}
 
 BOOST_AUTO_TEST_SUITE_END()
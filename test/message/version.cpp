@@ -142,6 +142,20 @@ BOOST_AUTO_TEST_CASE(version__from_data_chunk__version_meets_bip37)
     BOOST_REQUIRE(result.is_valid());
 }
 
+BOOST_AUTO_TEST_CASE(version__serialized_size__negotiated_below_bip37__matches_to_data)
+{
+    message::version instance;
+    instance.value = message::version::level::maximum;
+    instance.user_agent = "my agent";
+    instance.relay = true;
+
+    const auto version = message::version::level::bip37 - 1;
+    const auto data = instance.to_data(version);
+    BOOST_REQUIRE_EQUAL(data.size(), instance.serialized_size(version));
+    BOOST_REQUIRE_EQUAL(message::serialize(version, instance, 0).size(),
+        message::serialized_size(version, instance));
+}
+
 BOOST_AUTO_TEST_CASE(roundtrip_to_data_factory_from_data_chunk)
 {
     const auto sender_services = 1515u;
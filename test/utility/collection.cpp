@@ -87,4 +87,20 @@ BOOST_AUTO_TEST_CASE(collection__move_append__neither_empty__moved_in_order)
     BOOST_REQUIRE_EQUAL(target[9], 18u);
 }
 
+BOOST_AUTO_TEST_CASE(collection__bounded_reserve__count_within_bound__count)
+{
+    collection list;
+    bounded_reserve(list, 10, 100, 4);
+    BOOST_REQUIRE_GE(list.capacity(), 10u);
+    BOOST_REQUIRE(list.empty());
+}
+
+BOOST_AUTO_TEST_CASE(collection__bounded_reserve__hostile_count__available_bound)
+{
+    collection list;
+    bounded_reserve(list, max_uint64, 100, 4);
+    BOOST_REQUIRE_GE(list.capacity(), 25u);
+    BOOST_REQUIRE_LT(list.capacity(), 100u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
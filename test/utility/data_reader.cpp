@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(data_reader_tests)
+
+BOOST_AUTO_TEST_CASE(data_reader__is_exhausted__empty__true)
+{
+    const data_chunk data;
+    data_reader source(data);
+    BOOST_REQUIRE(source.is_exhausted());
+    BOOST_REQUIRE(source);
+}
+
+BOOST_AUTO_TEST_CASE(data_reader__roundtrip__all_types__matches_stream)
+{
+    const hash_digest hash{ { 1, 2, 3 } };
+    const std::string text = "libbitcoin";
+    data_chunk data(2 + 4 + 8 + 3 + 9 + 4 + hash_size + 11 + 16);
+    data_writer sink(data);
+    sink.write_2_bytes_little_endian(0x1234);
+    sink.write_4_bytes_big_endian(0x12345678);
+    sink.write_8_bytes_little_endian(0x0102030405060708);
+    sink.write_variable_uint_little_endian(0xfdfd);
+    sink.write_variable_uint_little_endian(0x0102030405060708);
+    sink.write_4_bytes_little_endian(42);
+    sink.write_hash(hash);
+    sink.write_string(text);
+    sink.write_fixed_string(text, 16);
+    BOOST_REQUIRE(sink);
+    BOOST_REQUIRE_EQUAL(sink.size(), data.size());
+
+    // The span writer produces the same bytes as the stream writer.
+    data_chunk streamed;
+    data_sink ostream(streamed);
+    ostream_writer stream_sink(ostream);
+    stream_sink.write_2_bytes_little_endian(0x1234);
+    stream_sink.write_4_bytes_big_endian(0x12345678);
+    stream_sink.write_8_bytes_little_endian(0x0102030405060708);
+    stream_sink.write_variable_uint_little_endian(0xfdfd);
+    stream_sink.write_variable_uint_little_endian(0x0102030405060708);
+    stream_sink.write_4_bytes_little_endian(42);
+    stream_sink.write_hash(hash);
+    stream_sink.write_string(text);
+    stream_sink.write_fixed_string(text, 16);
+    ostream.flush();
+    BOOST_REQUIRE(streamed == data);
+
+    data_reader source(data);
+    BOOST_REQUIRE_EQUAL(source.read_2_bytes_little_endian(), 0x1234u);
+    BOOST_REQUIRE_EQUAL(source.read_4_bytes_big_endian(), 0x12345678u);
+    BOOST_REQUIRE_EQUAL(source.read_8_bytes_little_endian(),
+        0x0102030405060708u);
+    BOOST_REQUIRE_EQUAL(source.read_variable_uint_little_endian(), 0xfdfdu);
+    BOOST_REQUIRE_EQUAL(source.read_variable_uint_little_endian(),
+        0x0102030405060708u);
+    BOOST_REQUIRE_EQUAL(source.read_4_bytes_little_endian(), 42u);
+    BOOST_REQUIRE(source.read_hash() == hash);
+    BOOST_REQUIRE_EQUAL(source.read_string(), text);
+    BOOST_REQUIRE_EQUAL(source.read_fixed_string(16), text);
+    BOOST_REQUIRE(source.is_exhausted());
+    BOOST_REQUIRE(source);
+}
+
+BOOST_AUTO_TEST_CASE(data_reader__read__past_end__invalid)
+{
+    const data_chunk data{ 1, 2, 3 };
+    data_reader source(data);
+    BOOST_REQUIRE_EQUAL(source.read_4_bytes_little_endian(), 0u);
+    BOOST_REQUIRE(!source);
+    BOOST_REQUIRE(!source.is_exhausted());
+    BOOST_REQUIRE_EQUAL(source.read_byte(), 0u);
+    BOOST_REQUIRE_EQUAL(source.remaining(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(data_reader__read_data__short__partial_and_invalid)
+{
+    const data_chunk data{ 1, 2, 3 };
+    data_reader source(data);
+    BOOST_REQUIRE_EQUAL(source.read_byte(), 1u);
+    BOOST_REQUIRE(source.read_data(5) == (data_chunk{ 2, 3 }));
+    BOOST_REQUIRE(!source);
+}
+
+BOOST_AUTO_TEST_CASE(data_reader__read_string__oversized_length__invalid)
+{
+    const data_chunk data{ 0xfe, 0xff, 0xff, 0xff, 0x7f, 'a', 'b' };
+    data_reader source(data);
+    BOOST_REQUIRE_EQUAL(source.read_string(), "ab");
+    BOOST_REQUIRE(!source);
+}
+
+BOOST_AUTO_TEST_CASE(data_writer__write__past_end__invalid_and_unwritten)
+{
+    data_chunk data(3, 0);
+    data_writer sink(data);
+    sink.write_byte(1);
+    sink.write_4_bytes_little_endian(42);
+    BOOST_REQUIRE(!sink);
+    BOOST_REQUIRE_EQUAL(sink.size(), 1u);
+    BOOST_REQUIRE(data == (data_chunk{ 1, 0, 0 }));
+    sink.write_byte(2);
+    BOOST_REQUIRE_EQUAL(sink.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(data_writer__write_chunk__underestimated__complete)
+{
+    const auto data = write_chunk(2, [](data_writer& sink)
+    {
+        sink.write_4_bytes_little_endian(0x04030201);
+        sink.write_byte(5);
+    });
+
+    BOOST_REQUIRE(data == (data_chunk{ 1, 2, 3, 4, 5 }));
+}
+
+BOOST_AUTO_TEST_CASE(data_writer__write_chunk__overestimated__trimmed)
+{
+    const auto data = write_chunk(8, [](data_writer& sink)
+    {
+        sink.write_2_bytes_little_endian(0x0201);
+    });
+
+    BOOST_REQUIRE(data == (data_chunk{ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(data_reader__block__from_data__matches_stream)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const auto raw = genesis.to_data();
+
+    chain::block instance;
+    BOOST_REQUIRE(instance.from_data(raw));
+    BOOST_REQUIRE(instance.to_data() == raw);
+
+    data_source istream(raw);
+    chain::block streamed;
+    BOOST_REQUIRE(streamed.from_data(istream));
+    BOOST_REQUIRE(streamed.header.hash() == instance.header.hash());
+
+    // Truncation is detected as with the stream reader.
+    const data_chunk truncated(raw.begin(), raw.end() - 1);
+    BOOST_REQUIRE(!instance.from_data(truncated));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
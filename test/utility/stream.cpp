@@ -40,6 +40,16 @@ BOOST_AUTO_TEST_CASE(is_exhausted_initialized_nonempty_stream_returns_false)
     BOOST_REQUIRE_EQUAL(false, source.is_exhausted());
 }
 
+BOOST_AUTO_TEST_CASE(read_data_hostile_size_returns_available_and_invalidates)
+{
+    std::stringstream stream("abc");
+    istream_reader source(stream);
+    const auto result = source.read_data(bc::max_size_t);
+    BOOST_REQUIRE_EQUAL(result.size(), 3u);
+    BOOST_REQUIRE(result.capacity() < 1024 * 1024);
+    BOOST_REQUIRE_EQUAL(false, (bool)source);
+}
+
 BOOST_AUTO_TEST_CASE(roundtrip_byte)
 {
     const uint8_t expected = 0xAA;